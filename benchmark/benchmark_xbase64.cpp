@@ -0,0 +1,131 @@
+/***************************************************************************
+* Copyright (c) Sylvain Corlay and Johan Mabille and Wolf Vollprecht       *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "xeus/xbase64.hpp"
+
+#include "xbenchmark.hpp"
+
+namespace bm = xeus::benchmark;
+
+namespace
+{
+    // Former implementations, growing the output one character at a time
+    std::string push_back_decode(const std::string& input)
+    {
+        std::array<int, 256> T;
+        T.fill(-1);
+        for (std::size_t i = 0; i < 64; ++i)
+        {
+            T[std::size_t("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i])] = int(i);
+        }
+
+        std::string output;
+        int val = 0;
+        int valb = -8;
+        for (char c : input)
+        {
+            if (T[static_cast<unsigned char>(c)] == -1)
+            {
+                break;
+            }
+            val = (val << 6) + T[static_cast<unsigned char>(c)];
+            valb += 6;
+            if (valb >= 0)
+            {
+                output.push_back(char((val >> valb) & 0xFF));
+                valb -= 8;
+            }
+        }
+        return output;
+    }
+
+    std::string push_back_encode(const std::string& input)
+    {
+        std::string output;
+        int val = 0;
+        int valb = -6;
+        for (char sc : input)
+        {
+            unsigned char c = static_cast<unsigned char>(sc);
+            val = (val << 8) + c;
+            valb += 8;
+            while (valb >= 0)
+            {
+                output.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[(val >> valb) & 0x3F]);
+                valb -= 6;
+            }
+        }
+        if (valb > -6)
+        {
+            output.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[((val << 8) >> (valb + 8)) & 0x3F]);
+        }
+        while (output.size() % 4)
+        {
+            output.push_back('=');
+        }
+        return output;
+    }
+
+    std::string make_bytes(std::size_t size)
+    {
+        std::string res(size, '\0');
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            res[i] = static_cast<char>(i * 37 + 11);
+        }
+        return res;
+    }
+
+    void benchmark_base64(std::size_t size, std::size_t iterations)
+    {
+        std::cout << "Base64, " << size << " bytes" << std::endl;
+        std::string bytes = make_bytes(size);
+        std::string encoded(xeus::base64_encoded_size(size), '\0');
+        xeus::base64_encode(bytes.data(), bytes.size(), encoded.data());
+        std::string decoded(xeus::base64_decoded_size(encoded.size()), '\0');
+
+        double old_encode_ns = bm::run("push_back encode", iterations, [&]()
+        {
+            bm::do_not_optimize(push_back_encode(bytes));
+        });
+        double old_decode_ns = bm::run("push_back decode", iterations, [&]()
+        {
+            bm::do_not_optimize(push_back_decode(encoded));
+        });
+        double encode_ns = bm::run("base64_encode", iterations, [&]()
+        {
+            xeus::base64_encode(bytes.data(), bytes.size(), encoded.data());
+            bm::do_not_optimize(encoded);
+        });
+        double decode_ns = bm::run("base64_decode", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::base64_decode(encoded, decoded.data()));
+        });
+        // bytes per ns is GB/s, times 1000 for MB/s
+        std::cout << "  push_back encode " << std::fixed << std::setprecision(0) << size * 1000. / old_encode_ns << " MB/s, "
+                  << "decode " << size * 1000. / old_decode_ns << " MB/s; "
+                  << "base64_encode " << size * 1000. / encode_ns << " MB/s, "
+                  << "base64_decode " << size * 1000. / decode_ns << " MB/s" << std::endl;
+    }
+}
+
+int main()
+{
+    benchmark_base64(100, 1000000);
+    benchmark_base64(64 * 1024, 1000);
+    // Size of an image in a display_data message
+    benchmark_base64(4 * 1024 * 1024, 20);
+    return 0;
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "xeus/xbasic_fixed_string.hpp"
+#include "xeus/xguid.hpp"
+
+#include "xbenchmark.hpp"
+
+namespace bm = xeus::benchmark;
+
+namespace
+{
+    constexpr std::size_t iterations = 2000000;
+
+    template <class S>
+    void benchmark_compare(const std::string& name, const S& lhs, const S& rhs)
+    {
+        bm::run(name + " ==", iterations, [&]()
+        {
+            bm::do_not_optimize(lhs);
+            bm::do_not_optimize(lhs == rhs);
+        });
+        bm::run(name + " compare", iterations, [&]()
+        {
+            bm::do_not_optimize(lhs);
+            bm::do_not_optimize(lhs.compare(rhs));
+        });
+    }
+
+    template <class S>
+    void benchmark_search(const std::string& name, const S& str)
+    {
+        bm::run(name + " find (substring)", iterations, [&]()
+        {
+            bm::do_not_optimize(str);
+            bm::do_not_optimize(str.find("stdout"));
+        });
+        bm::run(name + " rfind (char)", iterations, [&]()
+        {
+            bm::do_not_optimize(str);
+            bm::do_not_optimize(str.rfind('/'));
+        });
+        bm::run(name + " find_first_of", iterations, [&]()
+        {
+            bm::do_not_optimize(str);
+            bm::do_not_optimize(str.find_first_of(" \t\r\n"));
+        });
+        bm::run(name + " find_first_not_of", iterations, [&]()
+        {
+            bm::do_not_optimize(str);
+            bm::do_not_optimize(str.find_first_not_of("abcdefghijklmnopqrstuvwxyz_/."));
+        });
+        bm::run(name + " find_last_of", iterations, [&]()
+        {
+            bm::do_not_optimize(str);
+            bm::do_not_optimize(str.find_last_of("/."));
+        });
+    }
+}
+
+int main()
+{
+    xeus::xguid guid = xeus::new_xguid();
+    xeus::xguid same_guid(guid.c_str());
+    xeus::xguid other_guid = guid;
+    other_guid.back() = other_guid.back() == '0' ? '1' : '0';
+    std::string str_guid(guid.c_str());
+    std::string str_same_guid(str_guid.c_str());
+    std::string str_other_guid(other_guid.c_str());
+
+    std::cout << "Comparison of guids" << std::endl;
+    benchmark_compare("xguid, equal", guid, same_guid);
+    benchmark_compare("std::string, equal", str_guid, str_same_guid);
+    benchmark_compare("xguid, different", guid, other_guid);
+    benchmark_compare("std::string, different", str_guid, str_other_guid);
+
+    std::cout << "Validation of guids" << std::endl;
+    bm::run("xguid find_first_not_of", iterations, [&]()
+    {
+        bm::do_not_optimize(guid);
+        bm::do_not_optimize(guid.find_first_not_of("0123456789abcdef"));
+    });
+    bm::run("std::string find_first_not_of", iterations, [&]()
+    {
+        bm::do_not_optimize(str_guid);
+        bm::do_not_optimize(str_guid.find_first_not_of("0123456789abcdef"));
+    });
+
+    std::cout << "Search in 200 characters" << std::endl;
+    std::string text = "jupyter/widgets/";
+    while (text.size() < 188)
+    {
+        text += "output_area/";
+    }
+    text.resize(188);
+    text += "/stdout.log";
+    xeus::xfixed_string<255> fixed_text(text.c_str());
+    benchmark_search("xfixed_string<255>", fixed_text);
+    benchmark_search("std::string", text);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xeus/xcompression.hpp"
+
+#include "xbenchmark.hpp"
+
+namespace bm = xeus::benchmark;
+
+namespace
+{
+    constexpr std::size_t element_count = 256 * 1024;
+    constexpr std::size_t iterations = 50;
+
+    template <class T>
+    xeus::binary_buffer to_buffer(const std::vector<T>& values)
+    {
+        const char* data = reinterpret_cast<const char*>(values.data());
+        return xeus::binary_buffer(data, data + values.size() * sizeof(T));
+    }
+
+    std::uint32_t next_random(std::uint32_t& state)
+    {
+        state = state * 1103515245u + 12345u;
+        return state >> 8;
+    }
+
+    // Arrays typically sent by widgets and plotting libraries
+    std::vector<std::pair<std::string, xeus::binary_buffer>> make_arrays()
+    {
+        std::vector<std::pair<std::string, xeus::binary_buffer>> res;
+        std::uint32_t state = 42;
+
+        std::vector<double> signal(element_count);
+        for (std::size_t i = 0; i < element_count; ++i)
+        {
+            signal[i] = std::sin(static_cast<double>(i) * 0.001);
+        }
+        res.emplace_back("float64 sine", to_buffer(signal));
+
+        std::vector<double> sparse(element_count, 0.);
+        for (std::size_t i = 0; i < element_count; i += 37)
+        {
+            sparse[i] = static_cast<double>(next_random(state)) / 1024.;
+        }
+        res.emplace_back("float64 sparse", to_buffer(sparse));
+
+        std::vector<float> pixels(element_count);
+        for (std::size_t i = 0; i < element_count; ++i)
+        {
+            // 8-bit image normalized to [0, 1], with smooth regions
+            pixels[i] = static_cast<float>((i / 512 + i % 512 / 64) % 256) / 255.f;
+        }
+        res.emplace_back("float32 image", to_buffer(pixels));
+
+        std::vector<float> noise(element_count);
+        for (std::size_t i = 0; i < element_count; ++i)
+        {
+            noise[i] = static_cast<float>(next_random(state)) / 16777216.f;
+        }
+        res.emplace_back("float32 noise", to_buffer(noise));
+
+        std::vector<std::int32_t> labels(element_count);
+        for (std::size_t i = 0; i < element_count; ++i)
+        {
+            labels[i] = static_cast<std::int32_t>(next_random(state) % 10);
+        }
+        res.emplace_back("int32 labels", to_buffer(labels));
+
+        std::vector<std::int64_t> indices(element_count);
+        for (std::size_t i = 0; i < element_count; ++i)
+        {
+            indices[i] = static_cast<std::int64_t>(i);
+        }
+        res.emplace_back("int64 arange", to_buffer(indices));
+
+        return res;
+    }
+}
+
+int main()
+{
+    for (const auto& [name, buffer] : make_arrays())
+    {
+        xeus::binary_buffer compressed = xeus::lz4_compress(buffer.data(), buffer.size());
+        double ratio = static_cast<double>(buffer.size()) / static_cast<double>(compressed.size());
+        std::cout << name << ": " << buffer.size() << " -> " << compressed.size() << " bytes, ratio "
+                  << std::fixed << std::setprecision(2) << ratio << std::endl;
+
+        double compress_ns = bm::run(name + " compress", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::lz4_compress(buffer.data(), buffer.size()));
+        });
+        double decompress_ns = bm::run(name + " decompress", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::lz4_decompress(compressed.data(), compressed.size(), buffer.size()));
+        });
+        // bytes per ns is GB/s, times 1000 for MB/s
+        std::cout << "  compress " << std::setprecision(0) << buffer.size() * 1000. / compress_ns << " MB/s, "
+                  << "decompress " << buffer.size() * 1000. / decompress_ns << " MB/s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xeus/xhash.hpp"
+
+#include "xbenchmark.hpp"
+
+namespace bm = xeus::benchmark;
+
+namespace
+{
+    void benchmark_hash(const std::vector<unsigned char>& data, std::size_t size, std::size_t iterations)
+    {
+        std::cout << "Hash, " << size << " bytes" << std::endl;
+        double murmur_ns = bm::run("hash_bytes (murmur2)", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::hash_bytes(data.data(), size, 0));
+        });
+        double hash64_ns = bm::run("hash64", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::hash64(data.data(), size));
+        });
+        double hash128_ns = bm::run("hash128", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::hash128(data.data(), size));
+        });
+        // bytes per ns is GB/s
+        std::cout << "  murmur2 " << std::fixed << std::setprecision(2) << size / murmur_ns << " GB/s, "
+                  << "hash64 " << size / hash64_ns << " GB/s, "
+                  << "hash128 " << size / hash128_ns << " GB/s" << std::endl;
+    }
+}
+
+int main()
+{
+    std::vector<unsigned char> data(1024 * 1024);
+    std::uint32_t state = 1;
+    for (unsigned char& c : data)
+    {
+        state = state * 1103515245u + 12345u;
+        c = static_cast<unsigned char>(state >> 24);
+    }
+
+    // 32 is the size of a xguid
+    benchmark_hash(data, 8, 10000000);
+    benchmark_hash(data, 32, 10000000);
+    benchmark_hash(data, 256, 1000000);
+    benchmark_hash(data, 4096, 100000);
+    benchmark_hash(data, data.size(), 500);
+    return 0;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xcomm.hpp"
+#include "xeus/xguid.hpp"
+
+#include "xbenchmark.hpp"
+
+namespace bm = xeus::benchmark;
+namespace nl = nlohmann;
+
+namespace
+{
+    void benchmark_comm_lookup(std::size_t comm_count)
+    {
+        std::cout << "Comm lookup, " << comm_count << " comms" << std::endl;
+        constexpr std::size_t iterations = 1000000;
+
+        std::vector<nl::json> contents;
+        std::map<xeus::xguid, xeus::xcomm*> tree;
+        xeus::xcomm_manager::comm_map table;
+        for (std::size_t i = 0; i < comm_count; ++i)
+        {
+            xeus::xguid id = xeus::new_xguid();
+            tree[id] = nullptr;
+            table.insert_or_assign(id, nullptr);
+            contents.push_back({{"comm_id", std::string(id)}, {"data", nl::json::object()}});
+        }
+
+        // Messages target random comms
+        std::size_t state = 1;
+        auto next_content = [&]() -> const nl::json&
+        {
+            state = state * 6364136223846793005u + 1442695040888963407u;
+            return contents[(state >> 33) % comm_count];
+        };
+
+        bm::run("std::map, xguid from json", iterations, [&]()
+        {
+            const nl::json& content = next_content();
+            xeus::xguid id = content["comm_id"];
+            bm::do_not_optimize(tree.find(id));
+        });
+        bm::run("xhash_map, json key", iterations, [&]()
+        {
+            const nl::json& content = next_content();
+            bm::do_not_optimize(table.find(content["comm_id"]));
+        });
+        bm::run("next_content only", iterations, [&]()
+        {
+            bm::do_not_optimize(next_content());
+        });
+    }
+}
+
+int main()
+{
+    benchmark_comm_lookup(100);
+    benchmark_comm_lookup(50000);
+    return 0;
+}
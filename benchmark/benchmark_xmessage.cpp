@@ -0,0 +1,272 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "xeus/xguid.hpp"
+#include "xeus/xhelper.hpp"
+#include "xeus/xmessage.hpp"
+#include "xeus/xmessage_serializer.hpp"
+#include "xeus/xmessage_type.hpp"
+
+#include "xbenchmark.hpp"
+
+namespace bm = xeus::benchmark;
+
+namespace
+{
+    constexpr std::size_t iterations = 200000;
+
+    void benchmark_header()
+    {
+        std::cout << "Headers" << std::endl;
+        const std::string user_name = "jovyan";
+        const std::string session_id = std::string(xeus::new_xguid());
+        xeus::xheader_factory factory(user_name, session_id);
+
+        // Fields that are generated for every header
+        bm::run("new_xguid", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::new_xguid());
+        });
+        bm::run("new_xguid (fast)", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::new_xguid(xeus::xguid_generator::fast));
+        });
+        bm::run("iso8601_now", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::iso8601_now());
+        });
+        bm::run("format_iso8601", iterations, [&]()
+        {
+            char buffer[xeus::iso8601_size];
+            xeus::format_iso8601(std::chrono::system_clock::now(), buffer);
+            bm::do_not_optimize(buffer);
+        });
+
+        bm::run("make_header", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::make_header("status", user_name, session_id));
+        });
+        bm::run("xheader_factory::make_header", iterations, [&]()
+        {
+            bm::do_not_optimize(factory.make_header("status"));
+        });
+        bm::run("make_header + dump", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::make_header("status", user_name, session_id).dump());
+        });
+        bm::run("make_typed_header + serialize_header", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::serialize_header(xeus::make_typed_header("status", user_name, session_id)));
+        });
+        bm::run("xheader_factory typed header + serialize", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::serialize_header(factory.make_typed_header("status")));
+        });
+        xeus::set_xguid_generator(xeus::xguid_generator::fast);
+        bm::run("xheader_factory typed header + serialize (fast guid)", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::serialize_header(factory.make_typed_header("status")));
+        });
+        xeus::set_xguid_generator(xeus::xguid_generator::system);
+
+        // Serialization only, the header is built once
+        xeus::xmessage_header header = factory.make_typed_header("status");
+        bm::run("nl::json(header).dump()", iterations, [&]()
+        {
+            bm::do_not_optimize(nl::json(header).dump());
+        });
+        xeus::xmessage_header plain_header = xeus::make_typed_header("status", user_name, session_id);
+        bm::run("serialize_header (prebuilt)", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::serialize_header(plain_header));
+        });
+        bm::run("serialize_header (prebuilt, factory)", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::serialize_header(header));
+        });
+    }
+
+    // Typical traffic: an execute request, a stream output and a
+    // display_data message carrying a PNG image.
+    std::vector<std::pair<std::string, nl::json>> make_contents()
+    {
+        std::vector<std::pair<std::string, nl::json>> res;
+        res.emplace_back("execute_request", nl::json{
+            {"code", "import numpy as np\nx = np.linspace(0, 1, 100)\nprint(x.sum())\n"},
+            {"silent", false},
+            {"store_history", true},
+            {"user_expressions", nl::json::object()},
+            {"allow_stdin", true},
+            {"stop_on_error", true}
+        });
+        res.emplace_back("stream", nl::json{{"name", "stdout"}, {"text", "50.00000000000001\n"}});
+        res.emplace_back("display_data", nl::json{
+            {"data", {
+                {"image/png", std::string(16384, 'A')},
+                {"text/plain", "<Figure size 640x480 with 1 Axes>"}
+            }},
+            {"metadata", {{"image/png", {{"width", 640}, {"height", 480}}}}},
+            {"transient", nl::json::object()}
+        });
+        return res;
+    }
+
+    const char* encoding_name(xeus::message_encoding encoding)
+    {
+        switch (encoding)
+        {
+        case xeus::message_encoding::cbor:
+            return "cbor";
+        case xeus::message_encoding::msgpack:
+            return "msgpack";
+        case xeus::message_encoding::json:
+        default:
+            return "json";
+        }
+    }
+
+    void benchmark_encoding()
+    {
+        std::cout << "Encodings" << std::endl;
+        constexpr std::size_t encoding_iterations = 20000;
+        for (const auto& [name, content] : make_contents())
+        {
+            for (auto encoding : {xeus::message_encoding::json,
+                                  xeus::message_encoding::cbor,
+                                  xeus::message_encoding::msgpack})
+            {
+                std::string prefix = name + " " + encoding_name(encoding);
+                xeus::binary_buffer bytes = xeus::serialize_json(content, encoding);
+                std::cout << prefix << ": " << bytes.size() << " bytes" << std::endl;
+                bm::run(prefix + " encode", encoding_iterations, [&]()
+                {
+                    bm::do_not_optimize(xeus::serialize_json(content, encoding));
+                });
+                bm::run(prefix + " decode", encoding_iterations, [&]()
+                {
+                    bm::do_not_optimize(xeus::parse_json(bytes, encoding));
+                });
+            }
+        }
+    }
+
+    void benchmark_serializer()
+    {
+        std::cout << "Serializer" << std::endl;
+        constexpr std::size_t serializer_iterations = 20000;
+        xeus::xheader_factory factory("jovyan", std::string(xeus::new_xguid()));
+        xeus::xmessage_serializer serializer;
+        for (const auto& [name, content] : make_contents())
+        {
+            xeus::xpub_message msg(name,
+                                   factory.make_typed_header(name),
+                                   factory.make_header("execute_request"),
+                                   nl::json::object(),
+                                   content,
+                                   xeus::buffer_sequence());
+
+            // What servers used to do: one string per frame, then a copy
+            // into the transport frame
+            bm::run(name + " dump + copy", serializer_iterations, [&]()
+            {
+                std::vector<char> frames[xeus::xmessage_serializer::frame_count];
+                const nl::json* sections[] = { &msg.header(), &msg.parent_header(), &msg.metadata(), &msg.content() };
+                for (std::size_t i = 0; i < xeus::xmessage_serializer::frame_count; ++i)
+                {
+                    std::string dumped = sections[i]->dump();
+                    frames[i].assign(dumped.begin(), dumped.end());
+                }
+                bm::do_not_optimize(frames);
+            });
+            bm::run(name + " xmessage_serializer", serializer_iterations, [&]()
+            {
+                bm::do_not_optimize(serializer.serialize(msg));
+            });
+        }
+    }
+
+    void benchmark_replies()
+    {
+        std::cout << "Replies" << std::endl;
+        constexpr std::size_t reply_iterations = 200;
+        constexpr std::size_t match_count = 10000;
+        std::vector<std::string> names(match_count);
+        for (std::size_t i = 0; i < match_count; ++i)
+        {
+            names[i] = "completion_candidate_" + std::to_string(i);
+        }
+
+        // The interpreter builds its matches, then the reply
+        bm::run("complete_reply from const json&", reply_iterations, [&]()
+        {
+            const nl::json matches = names;
+            bm::do_not_optimize(xeus::create_complete_reply(matches, 0, 4));
+        });
+        bm::run("complete_reply from json&&", reply_iterations, [&]()
+        {
+            nl::json matches = names;
+            bm::do_not_optimize(xeus::create_complete_reply(std::move(matches), 0, 4));
+        });
+        bm::run("complete_reply from complete_reply_content", reply_iterations, [&]()
+        {
+            xeus::complete_reply_content content;
+            content.m_matches = names;
+            content.m_cursor_end = 4;
+            bm::do_not_optimize(xeus::create_complete_reply(std::move(content)));
+        });
+    }
+
+    void benchmark_message_type()
+    {
+        std::cout << "Message types" << std::endl;
+        constexpr std::size_t lookup_iterations = 2000000;
+        auto linear_lookup = [](std::string_view name)
+        {
+            for (std::size_t i = 0; i < xeus::message_type_count; ++i)
+            {
+                if (xeus::message_type_names[i] == name)
+                {
+                    return static_cast<xeus::message_type>(i);
+                }
+            }
+            return xeus::message_type::unknown;
+        };
+        for (std::string name : {"execute_request", "input_reply", "custom_request"})
+        {
+            bm::run(name + " linear scan", lookup_iterations, [&]()
+            {
+                bm::do_not_optimize(name);
+                bm::do_not_optimize(linear_lookup(name));
+            });
+            bm::run(name + " to_message_type", lookup_iterations, [&]()
+            {
+                bm::do_not_optimize(name);
+                bm::do_not_optimize(xeus::to_message_type(name));
+            });
+        }
+    }
+}
+
+int main()
+{
+    benchmark_header();
+    benchmark_encoding();
+    benchmark_serializer();
+    benchmark_replies();
+    benchmark_message_type();
+    return 0;
+}
@@ -0,0 +1,143 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "xeus/xguid.hpp"
+#include "xeus/xstring_utils.hpp"
+
+#include "xbenchmark.hpp"
+
+namespace bm = xeus::benchmark;
+
+namespace
+{
+    // Former implementation of hex_string
+    std::string stream_hex_string(const std::string& buffer)
+    {
+        std::ostringstream oss;
+        oss << std::hex;
+        for (std::size_t i = 0; i < buffer.size(); ++i)
+        {
+            oss << std::setw(2) << std::setfill('0') << static_cast<int>(static_cast<unsigned char>(buffer[i]));
+        }
+        return oss.str();
+    }
+
+    // Former UTF-8 validation of the logger
+    // Copyright (c) 2008-2009 Bjoern Hoehrmann <bjoern@hoehrmann.de>
+    // See http://bjoern.hoehrmann.de/utf-8/decoder/dfa/
+    bool dfa_is_utf8_valid(const std::string& str)
+    {
+        static const std::array<std::uint8_t, 400> utf8d =
+        {
+            {
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 00..1F
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 20..3F
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 40..5F
+                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 60..7F
+                1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, // 80..9F
+                7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, // A0..BF
+                8, 8, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, // C0..DF
+                0xA, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x4, 0x3, 0x3, // E0..EF
+                0xB, 0x6, 0x6, 0x6, 0x5, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, // F0..FF
+                0x0, 0x1, 0x2, 0x3, 0x5, 0x8, 0x7, 0x1, 0x1, 0x1, 0x4, 0x6, 0x1, 0x1, 0x1, 0x1, // s0..s0
+                1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1, 0, 1, 1, 1, 1, 1, 1, // s1..s2
+                1, 2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, // s3..s4
+                1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 1, 3, 1, 1, 1, 1, 1, 1, // s5..s6
+                1, 3, 1, 1, 1, 1, 1, 3, 1, 3, 1, 1, 1, 1, 1, 1, 1, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 // s7..s8
+            }
+        };
+        std::uint8_t state = 0;
+        for (char c : str)
+        {
+            state = utf8d[256u + state * 16u + utf8d[static_cast<std::uint8_t>(c)]];
+        }
+        return state == 0;
+    }
+
+    std::string make_bytes(std::size_t size)
+    {
+        std::string res(size, '\0');
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            res[i] = static_cast<char>(i * 37 + 11);
+        }
+        return res;
+    }
+
+    void benchmark_hex(std::size_t size, std::size_t iterations)
+    {
+        std::cout << "Hex, " << size << " bytes" << std::endl;
+        std::string bytes = make_bytes(size);
+        std::string encoded = xeus::hex_string(bytes);
+        std::string decoded(size, '\0');
+
+        double stream_ns = bm::run("ostringstream", iterations, [&]()
+        {
+            bm::do_not_optimize(stream_hex_string(bytes));
+        });
+        double string_ns = bm::run("hex_string", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::hex_string(bytes));
+        });
+        double encode_ns = bm::run("hex_encode", iterations, [&]()
+        {
+            xeus::hex_encode(bytes.data(), bytes.size(), encoded.data());
+            bm::do_not_optimize(encoded);
+        });
+        double decode_ns = bm::run("hex_decode", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::hex_decode(encoded.data(), encoded.size(), decoded.data()));
+        });
+        // bytes per ns is GB/s, times 1000 for MB/s
+        std::cout << "  ostringstream " << std::fixed << std::setprecision(0) << size * 1000. / stream_ns << " MB/s, "
+                  << "hex_string " << size * 1000. / string_ns << " MB/s, "
+                  << "hex_encode " << size * 1000. / encode_ns << " MB/s, "
+                  << "hex_decode " << size * 1000. / decode_ns << " MB/s" << std::endl;
+    }
+
+    void benchmark_utf8(const std::string& name, const std::string& pattern, std::size_t iterations)
+    {
+        std::string text;
+        while (text.size() < 1024 * 1024)
+        {
+            text += pattern;
+        }
+        std::cout << "UTF-8 validation, 1 MB of " << name << std::endl;
+        double dfa_ns = bm::run("DFA", iterations, [&]()
+        {
+            bm::do_not_optimize(dfa_is_utf8_valid(text));
+        });
+        double valid_ns = bm::run("utf8_valid_prefix", iterations, [&]()
+        {
+            bm::do_not_optimize(xeus::utf8_valid_prefix(text.data(), text.size()));
+        });
+        std::cout << "  DFA " << std::fixed << std::setprecision(0) << text.size() * 1000. / dfa_ns << " MB/s, "
+                  << "utf8_valid_prefix " << text.size() * 1000. / valid_ns << " MB/s" << std::endl;
+    }
+}
+
+int main()
+{
+    // Size of a xguid
+    benchmark_hex(16, 1000000);
+    benchmark_hex(1024, 100000);
+    benchmark_hex(1024 * 1024, 100);
+    benchmark_utf8("ASCII", "Line of process output\n", 100);
+    benchmark_utf8("French", "Caf\xC3\xA9 cr\xC3\xA8" "me br\xC3\xBBl\xC3\xA9" "e, \xC3\xA0 la fran\xC3\xA7" "aise\n", 100);
+    benchmark_utf8("Chinese", "\xE4\xBD\xA0\xE5\xA5\xBD\xEF\xBC\x8C\xE4\xB8\x96\xE7\x95\x8C\n", 100);
+    return 0;
+}
@@ -0,0 +1,67 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_BENCHMARK_HPP
+#define XEUS_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace xeus
+{
+    namespace benchmark
+    {
+        // Prevents the compiler from optimizing away the computation
+        // of value.
+        template <class T>
+        inline void do_not_optimize(const T& value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            static volatile const void* sink;
+            sink = &value;
+#endif
+        }
+
+        /**
+         * Runs f iterations times after a warm-up, and prints the average
+         * time per call in nanoseconds. Returns the average time.
+         */
+        template <class F>
+        inline double run(const std::string& name, std::size_t iterations, F&& f)
+        {
+            using clock_type = std::chrono::steady_clock;
+
+            for (std::size_t i = 0; i < iterations / 10 + 1; ++i)
+            {
+                f();
+            }
+
+            auto start = clock_type::now();
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                f();
+            }
+            auto stop = clock_type::now();
+
+            double total = std::chrono::duration<double, std::nano>(stop - start).count();
+            double per_call = total / static_cast<double>(iterations);
+            std::cout << std::left << std::setw(48) << name
+                      << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+                      << per_call << " ns" << std::endl;
+            return per_call;
+        }
+    }
+}
+
+#endif
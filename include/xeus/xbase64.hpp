@@ -10,66 +10,49 @@
 #ifndef XEUS_BASE64_HPP
 #define XEUS_BASE64_HPP
 
-#include <array>
 #include <cstddef>
 #include <string>
+#include <string_view>
+
+#include "xeus/xeus.hpp"
 
 namespace xeus
 {
-    inline std::string base64decode(const std::string& input)
+    // Number of characters encoding size bytes, padding included
+    constexpr std::size_t base64_encoded_size(std::size_t size) noexcept
+    {
+        return (size + 2) / 3 * 4;
+    }
+
+    // Maximum number of bytes decoded from size characters
+    constexpr std::size_t base64_decoded_size(std::size_t size) noexcept
     {
-        std::array<int, 256> T;
-        T.fill(-1);
-        for (std::size_t i = 0; i < 64; ++i)
-        {
-            T[std::size_t("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i])] = int(i);
-        }
+        return size / 4 * 3 + size % 4 * 3 / 4;
+    }
+
+    // Writes the base64_encoded_size(size) characters encoding the size
+    // bytes at data to out.
+    XEUS_API void base64_encode(const void* data, std::size_t size, char* out) noexcept;
 
-        std::string output;
-        int val = 0;
-        int valb = -8;
-        for (char c : input)
-        {
-            if (T[std::size_t(c)] == -1)
-            {
-                break;
-            }
-            val = (val << 6) + T[std::size_t(c)];
-            valb += 6;
-            if (valb >= 0)
-            {
-                output.push_back(char((val >> valb) & 0xFF));
-                valb -= 8;
-            }
-        }
+    // Writes the bytes encoded by input to out, which must have room for
+    // base64_decoded_size(input.size()) bytes; its content past the
+    // decoded bytes is unspecified. Decoding stops at the first character
+    // that is not in the base64 alphabet, such as the padding. Returns
+    // the number of decoded bytes.
+    XEUS_API std::size_t base64_decode(std::string_view input, void* out) noexcept;
+
+    inline std::string base64decode(std::string_view input)
+    {
+        std::string output(base64_decoded_size(input.size()), '\0');
+        output.resize(base64_decode(input, output.data()));
         return output;
     }
 
-    inline std::string base64encode(const std::string& input)
+    inline std::string base64encode(std::string_view input)
     {
-        std::string output;
-        int val = 0;
-        int valb = -6;
-        for (char sc : input)
-        {
-            unsigned char c = static_cast<unsigned char>(sc);
-            val = (val << 8) + c;
-            valb += 8;
-            while (valb >= 0)
-            {
-                output.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[(val >> valb) & 0x3F]);
-                valb -= 6;
-            }
-        }
-        if (valb > -6)
-        {
-            output.push_back("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[((val << 8) >> (valb + 8)) & 0x3F]);
-        }
-        while (output.size() % 4)
-        {
-            output.push_back('=');
-        }
+        std::string output(base64_encoded_size(input.size()), '\0');
+        base64_encode(input.data(), input.size(), output.data());
         return output;
     }
 }
-#endif
\ No newline at end of file
+#endif
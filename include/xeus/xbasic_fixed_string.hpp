@@ -17,9 +17,11 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <cassert>
 
 #include <xeus/xhash.hpp>
+#include <xeus/xstring_utils.hpp>
 
 namespace xeus
 {
@@ -57,7 +59,8 @@ namespace xeus
                                            xbasic_fixed_string<CT, N, ST, EP, TR>& str);
 
     template <class CT>
-    using xbasic_string_view = xbasic_fixed_string<const CT, 0, pointer | store_size | is_const>;
+    using xbasic_string_view = xbasic_fixed_string<const CT, 0, pointer | store_size | is_const,
+                                                   string_policy::silent_error, std::char_traits<CT>>;
 
     namespace detail
     {
@@ -72,7 +75,8 @@ namespace xeus
         {
             static_assert(N <= (1u << (8 * sizeof(T))), "small string");
 
-            fixed_small_string_storage_impl()
+            constexpr fixed_small_string_storage_impl()
+                : m_buffer()
             {
                 set_size(0);
             }
@@ -83,33 +87,31 @@ namespace xeus
                 m_buffer[N - 1] = N - size;
             }
 
-            T* buffer()
+            constexpr T* buffer()
             {
                 return m_buffer;
             }
 
-            const T* buffer() const
+            constexpr const T* buffer() const
             {
                 return m_buffer;
             }
 
-            std::size_t size() const
+            constexpr std::size_t size() const
             {
-                // Don't use std::make_unsinged_t here, this should remain C++11 compatible
-                using unsigned_type = typename std::make_unsigned<T>::type;
-                return N - reinterpret_cast<unsigned_type const*>(m_buffer)[N - 1];
+                using unsigned_type = std::make_unsigned_t<T>;
+                return N - static_cast<unsigned_type>(m_buffer[N - 1]);
             }
 
-            void set_size(std::size_t sz)
+            constexpr void set_size(std::size_t sz)
             {
                 assert(sz < N && "setting a small size");
-                // Don't use std::make_unsinged_t here, this should remain C++11 compatible
-                using unsigned_type = typename std::make_unsigned<T>::type;
-                reinterpret_cast<unsigned_type*>(m_buffer)[N - 1] = static_cast<unsigned_type>(N - sz);
+                using unsigned_type = std::make_unsigned_t<T>;
+                m_buffer[N - 1] = static_cast<T>(static_cast<unsigned_type>(N - sz));
                 m_buffer[sz] = '\0';
             }
 
-            void adjust_size(std::ptrdiff_t val)
+            constexpr void adjust_size(std::ptrdiff_t val)
             {
                 assert(size() + val >= 0 && "adjusting to positive size");
                 set_size(static_cast<std::size_t>(static_cast<std::ptrdiff_t>(size()) + val));
@@ -128,35 +130,61 @@ namespace xeus
             {
             }
 
-            T& buffer()
+            constexpr T& buffer()
             {
                 return m_buffer;
             }
 
-            const T& buffer() const
+            constexpr const T& buffer() const
             {
                 return m_buffer;
             }
 
-            std::size_t size() const
+            constexpr std::size_t size() const
             {
                 return m_size;
             }
 
-            void set_size(std::size_t sz)
+            constexpr void set_size(std::size_t sz)
             {
                 m_size = sz;
                 m_buffer[sz] = '\0';
             }
 
-            void adjust_size(std::ptrdiff_t val)
+            constexpr void adjust_size(std::ptrdiff_t val)
             {
                 m_size += std::size_t(val);
                 m_buffer[m_size] = '\0';
             }
 
-            T m_buffer;
-            std::size_t m_size;
+            T m_buffer = {};
+            std::size_t m_size = 0;
+        };
+
+        // Storage of xbasic_string_view: a pointer to characters owned
+        // by another object, and their count
+        template <class T>
+        struct fixed_string_view_storage_impl
+        {
+            constexpr fixed_string_view_storage_impl() = default;
+
+            constexpr fixed_string_view_storage_impl(T* ptr, std::size_t size)
+                : m_buffer(ptr), m_size(size)
+            {
+            }
+
+            constexpr T* buffer() const
+            {
+                return m_buffer;
+            }
+
+            constexpr std::size_t size() const
+            {
+                return m_size;
+            }
+
+            T* m_buffer = nullptr;
+            std::size_t m_size = 0;
         };
 
         template <class T>
@@ -220,6 +248,98 @@ namespace xeus
             template <class T, std::size_t N>
             using type = fixed_string_external_storage_impl<T[N + 1]>;
         };
+
+        template <>
+        struct select_storage<pointer | store_size | is_const>
+        {
+            template <class T, std::size_t>
+            using type = fixed_string_view_storage_impl<T>;
+        };
+
+        // Character copies usable in constant expressions; the traits
+        // functions are used at runtime since they are faster
+        template <class TR, class CT>
+        constexpr void copy_chars(CT* dst, const CT* src, std::size_t count) noexcept
+        {
+            if (is_constant_evaluated())
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    dst[i] = src[i];
+                }
+            }
+            else
+            {
+                TR::copy(dst, src, count);
+            }
+        }
+
+        template <class TR, class CT>
+        constexpr void assign_chars(CT* dst, std::size_t count, CT ch) noexcept
+        {
+            if (is_constant_evaluated())
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    dst[i] = ch;
+                }
+            }
+            else
+            {
+                TR::assign(dst, count, ch);
+            }
+        }
+
+        // Strings of char are searched at runtime with the vectorized
+        // functions of xstring_utils.hpp
+        template <class CT, class TR>
+        constexpr bool is_char_string = std::is_same<std::remove_const_t<CT>, char>::value &&
+                                        std::is_same<TR, std::char_traits<char>>::value;
+
+        // Compares 8 bytes at a time, the last word overlapping the
+        // previous ones. Inlined, this is faster than memcmp for the
+        // short strings held by xbasic_fixed_string.
+        inline bool equal_bytes(const char* s1, const char* s2, std::size_t count) noexcept
+        {
+            const unsigned char* p1 = reinterpret_cast<const unsigned char*>(s1);
+            const unsigned char* p2 = reinterpret_cast<const unsigned char*>(s2);
+            if (count >= 8)
+            {
+                for (std::size_t i = 0; i + 8 < count; i += 8)
+                {
+                    if (wyread8(p1 + i) != wyread8(p2 + i))
+                    {
+                        return false;
+                    }
+                }
+                return wyread8(p1 + count - 8) == wyread8(p2 + count - 8);
+            }
+            if (count >= 4)
+            {
+                return wyread4(p1) == wyread4(p2) && wyread4(p1 + count - 4) == wyread4(p2 + count - 4);
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (p1[i] != p2[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class TR, class CT>
+        constexpr bool equal_chars(const CT* s1, const CT* s2, std::size_t count) noexcept
+        {
+            if constexpr (is_char_string<CT, TR>)
+            {
+                if (!is_constant_evaluated())
+                {
+                    return equal_bytes(s1, s2, count);
+                }
+            }
+            return TR::compare(s1, s2, count) == 0;
+        }
     }
 
     template <class CT,
@@ -248,30 +368,30 @@ namespace xeus
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 
-        static const size_type npos;
+        static constexpr size_type npos = size_type(-1);
 
         using self_type = xbasic_fixed_string;
         using initializer_type = std::initializer_list<value_type>;
-        using string_type = std::basic_string<value_type, traits_type>;
+        using string_type = std::basic_string<std::remove_const_t<value_type>, traits_type>;
 
         using error_policy = EP<N>;
 
-        xbasic_fixed_string();
+        constexpr xbasic_fixed_string();
 
-        explicit xbasic_fixed_string(size_type count, value_type ch);
-        explicit xbasic_fixed_string(const self_type& other,
+        explicit constexpr xbasic_fixed_string(size_type count, value_type ch);
+        explicit constexpr xbasic_fixed_string(const self_type& other,
                             size_type pos,
                             size_type count = npos);
         explicit xbasic_fixed_string(const string_type& other);
         explicit xbasic_fixed_string(const string_type& other,
                                      size_type pos,
                                      size_type count = npos);
-        xbasic_fixed_string(const_pointer s, size_type count);
-        xbasic_fixed_string(const_pointer s);
-        xbasic_fixed_string(initializer_type ilist);
+        constexpr xbasic_fixed_string(const_pointer s, size_type count);
+        constexpr xbasic_fixed_string(const_pointer s);
+        constexpr xbasic_fixed_string(initializer_type ilist);
 
         template <class InputIt>
-        xbasic_fixed_string(InputIt first, InputIt last);
+        constexpr xbasic_fixed_string(InputIt first, InputIt last);
 
         operator string_type() const;
 
@@ -282,70 +402,70 @@ namespace xeus
 
         self_type& operator=(const self_type&) = default;
         self_type& operator=(self_type&&) = default;
-        self_type& operator=(const_pointer s);
-        self_type& operator=(value_type ch);
-        self_type& operator=(initializer_type ilist);
+        constexpr self_type& operator=(const_pointer s);
+        constexpr self_type& operator=(value_type ch);
+        constexpr self_type& operator=(initializer_type ilist);
         self_type& operator=(const string_type& str);
 
-        self_type& assign(size_type count, value_type ch);
-        self_type& assign(const self_type& other,
-                          size_type pos,
-                          size_type count = npos);
-        self_type& assign(const_pointer s, size_type count);
-        self_type& assign(const_pointer s);
-        self_type& assign(initializer_type ilist);
+        constexpr self_type& assign(size_type count, value_type ch);
+        constexpr self_type& assign(const self_type& other,
+                                    size_type pos,
+                                    size_type count = npos);
+        constexpr self_type& assign(const_pointer s, size_type count);
+        constexpr self_type& assign(const_pointer s);
+        constexpr self_type& assign(initializer_type ilist);
         template <class InputIt>
-        self_type& assign(InputIt first, InputIt last);
-        self_type& assign(const self_type& rhs);
-        self_type& assign(self_type&& rhs);
+        constexpr self_type& assign(InputIt first, InputIt last);
+        constexpr self_type& assign(const self_type& rhs);
+        constexpr self_type& assign(self_type&& rhs);
         self_type& assign(const string_type& str);
         self_type& assign(const string_type& other,
                           size_type pos,
                           size_type count = npos);
 
-        reference at(size_type pos);
-        const_reference at(size_type pos) const;
-
-        reference operator[](size_type pos);
-        const_reference operator[](size_type pos) const;
-
-        reference front();
-        const_reference front() const;
-
-        reference back();
-        const_reference back() const;
-
-        pointer data() noexcept;
-        const_pointer data() const noexcept;
-
-        const_pointer c_str() const noexcept;
-
-        iterator begin() noexcept;
-        iterator end() noexcept;
-        const_iterator begin() const noexcept;
-        const_iterator end() const noexcept;
-        const_iterator cbegin() const noexcept;
-        const_iterator cend() const noexcept;
-
-        reverse_iterator rbegin() noexcept;
-        reverse_iterator rend() noexcept;
-        const_reverse_iterator rbegin() const noexcept;
-        const_reverse_iterator rend() const noexcept;
-        const_reverse_iterator crbegin() const noexcept;
-        const_reverse_iterator crend() const noexcept;
-
-        bool empty() const noexcept;
-        size_type size() const noexcept;
-        size_type length() const noexcept;
-        size_type max_size() const noexcept;
-
-        void clear() noexcept;
-        void push_back(value_type ch);
-        void pop_back();
-        self_type substr(size_type pos = 0, size_type count = npos) const;
-        size_type copy(pointer dest, size_type count, size_type pos = 0) const;
-        void resize(size_type count);
-        void resize(size_type count, value_type ch);
+        constexpr reference at(size_type pos);
+        constexpr const_reference at(size_type pos) const;
+
+        constexpr reference operator[](size_type pos);
+        constexpr const_reference operator[](size_type pos) const;
+
+        constexpr reference front();
+        constexpr const_reference front() const;
+
+        constexpr reference back();
+        constexpr const_reference back() const;
+
+        constexpr pointer data() noexcept;
+        constexpr const_pointer data() const noexcept;
+
+        constexpr const_pointer c_str() const noexcept;
+
+        constexpr iterator begin() noexcept;
+        constexpr iterator end() noexcept;
+        constexpr const_iterator begin() const noexcept;
+        constexpr const_iterator end() const noexcept;
+        constexpr const_iterator cbegin() const noexcept;
+        constexpr const_iterator cend() const noexcept;
+
+        constexpr reverse_iterator rbegin() noexcept;
+        constexpr reverse_iterator rend() noexcept;
+        constexpr const_reverse_iterator rbegin() const noexcept;
+        constexpr const_reverse_iterator rend() const noexcept;
+        constexpr const_reverse_iterator crbegin() const noexcept;
+        constexpr const_reverse_iterator crend() const noexcept;
+
+        constexpr bool empty() const noexcept;
+        constexpr size_type size() const noexcept;
+        constexpr size_type length() const noexcept;
+        constexpr size_type max_size() const noexcept;
+
+        constexpr void clear() noexcept;
+        constexpr void push_back(value_type ch);
+        constexpr void pop_back();
+        constexpr self_type substr(size_type pos = 0, size_type count = npos) const;
+        constexpr size_type copy(pointer dest, size_type count, size_type pos = 0) const;
+        constexpr void resize(size_type count);
+        constexpr void resize(size_type count, value_type ch);
         void swap(self_type& rhs) noexcept;
 
         self_type& insert(size_type index, size_type count, value_type ch);
@@ -367,36 +487,36 @@ namespace xeus
         iterator erase(const_iterator position);
         iterator erase(const_iterator first, const_iterator last);
 
-        self_type& append(size_type count, value_type ch);
-        self_type& append(const self_type& str);
-        self_type& append(const self_type& str,
-                          size_type pos, size_type count = npos);
+        constexpr self_type& append(size_type count, value_type ch);
+        constexpr self_type& append(const self_type& str);
+        constexpr self_type& append(const self_type& str,
+                                    size_type pos, size_type count = npos);
         self_type& append(const string_type& str);
         self_type& append(const string_type& str,
                           size_type pos, size_type count = npos);
-        self_type& append(const_pointer s, size_type count);
-        self_type& append(const_pointer s);
-        self_type& append(initializer_type ilist);
+        constexpr self_type& append(const_pointer s, size_type count);
+        constexpr self_type& append(const_pointer s);
+        constexpr self_type& append(initializer_type ilist);
         template <class InputIt>
-        self_type& append(InputIt first, InputIt last);
+        constexpr self_type& append(InputIt first, InputIt last);
 
-        self_type& operator+=(const self_type& str);
+        constexpr self_type& operator+=(const self_type& str);
         self_type& operator+=(const string_type& str);
-        self_type& operator+=(value_type ch);
-        self_type& operator+=(const_pointer s);
-        self_type& operator+=(initializer_type ilist);
-
-        int compare(const self_type& str) const noexcept;
-        int compare(size_type pos1, size_type count1, const self_type& str) const;
-        int compare(size_type pos1, size_type count1, const self_type& str,
-                    size_type pos2, size_type count2 = npos) const;
+        constexpr self_type& operator+=(value_type ch);
+        constexpr self_type& operator+=(const_pointer s);
+        constexpr self_type& operator+=(initializer_type ilist);
+
+        constexpr int compare(const self_type& str) const noexcept;
+        constexpr int compare(size_type pos1, size_type count1, const self_type& str) const;
+        constexpr int compare(size_type pos1, size_type count1, const self_type& str,
+                              size_type pos2, size_type count2 = npos) const;
         int compare(const string_type& str) const noexcept;
         int compare(size_type pos1, size_type count1, const string_type& str) const;
         int compare(size_type pos1, size_type count1, const string_type& str,
                     size_type pos2, size_type count2 = npos) const;
-        int compare(const_pointer s) const noexcept;
-        int compare(size_type pos1, size_type count1, const_pointer s) const;
-        int compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const;
+        constexpr int compare(const_pointer s) const noexcept;
+        constexpr int compare(size_type pos1, size_type count1, const_pointer s) const;
+        constexpr int compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const;
 
         self_type& replace(size_type pos, size_type count, const self_type& str);
         self_type& replace(const_iterator first, const_iterator last, const self_type& str);
@@ -416,56 +536,54 @@ namespace xeus
         template <class InputIt>
         self_type& replace(const_iterator first, const_iterator last, InputIt first2, InputIt last2);
 
-        size_type find(const self_type& str, size_type pos = 0) const noexcept;
+        constexpr size_type find(const self_type& str, size_type pos = 0) const noexcept;
         size_type find(const string_type& str, size_type pos = 0) const noexcept;
-        size_type find(const_pointer s, size_type pos, size_type count) const;
-        size_type find(const_pointer s, size_type pos = 0) const;
-        size_type find(value_type ch, size_type pos = 0) const;
+        constexpr size_type find(const_pointer s, size_type pos, size_type count) const;
+        constexpr size_type find(const_pointer s, size_type pos = 0) const;
+        constexpr size_type find(value_type ch, size_type pos = 0) const;
 
-        size_type rfind(const self_type& str, size_type pos = npos) const noexcept;
+        constexpr size_type rfind(const self_type& str, size_type pos = npos) const noexcept;
         size_type rfind(const string_type& str, size_type pos = npos) const noexcept;
-        size_type rfind(const_pointer s, size_type pos, size_type count) const;
-        size_type rfind(const_pointer s, size_type pos = npos) const;
-        size_type rfind(value_type ch, size_type pos = npos) const;
+        constexpr size_type rfind(const_pointer s, size_type pos, size_type count) const;
+        constexpr size_type rfind(const_pointer s, size_type pos = npos) const;
+        constexpr size_type rfind(value_type ch, size_type pos = npos) const;
 
-        size_type find_first_of(const self_type& str, size_type pos = 0) const noexcept;
+        constexpr size_type find_first_of(const self_type& str, size_type pos = 0) const noexcept;
         size_type find_first_of(const string_type& str, size_type pos = 0) const noexcept;
-        size_type find_first_of(const_pointer s, size_type pos, size_type count) const;
-        size_type find_first_of(const_pointer s, size_type pos = 0) const;
-        size_type find_first_of(value_type ch, size_type pos = 0) const;
+        constexpr size_type find_first_of(const_pointer s, size_type pos, size_type count) const;
+        constexpr size_type find_first_of(const_pointer s, size_type pos = 0) const;
+        constexpr size_type find_first_of(value_type ch, size_type pos = 0) const;
 
-        size_type find_first_not_of(const self_type& str, size_type pos = 0) const noexcept;
+        constexpr size_type find_first_not_of(const self_type& str, size_type pos = 0) const noexcept;
         size_type find_first_not_of(const string_type& str, size_type pos = 0) const noexcept;
-        size_type find_first_not_of(const_pointer s, size_type pos, size_type count) const;
-        size_type find_first_not_of(const_pointer s, size_type pos = 0) const;
-        size_type find_first_not_of(value_type ch, size_type pos = 0) const;
+        constexpr size_type find_first_not_of(const_pointer s, size_type pos, size_type count) const;
+        constexpr size_type find_first_not_of(const_pointer s, size_type pos = 0) const;
+        constexpr size_type find_first_not_of(value_type ch, size_type pos = 0) const;
 
-        size_type find_last_of(const self_type& str, size_type pos = 0) const noexcept;
+        constexpr size_type find_last_of(const self_type& str, size_type pos = 0) const noexcept;
         size_type find_last_of(const string_type& str, size_type pos = 0) const noexcept;
-        size_type find_last_of(const_pointer s, size_type pos, size_type count) const;
-        size_type find_last_of(const_pointer s, size_type pos = 0) const;
-        size_type find_last_of(value_type ch, size_type pos = 0) const;
+        constexpr size_type find_last_of(const_pointer s, size_type pos, size_type count) const;
+        constexpr size_type find_last_of(const_pointer s, size_type pos = 0) const;
+        constexpr size_type find_last_of(value_type ch, size_type pos = 0) const;
 
-        size_type find_last_not_of(const self_type& str, size_type pos = npos) const noexcept;
+        constexpr size_type find_last_not_of(const self_type& str, size_type pos = npos) const noexcept;
         size_type find_last_not_of(const string_type& str, size_type pos = npos) const noexcept;
-        size_type find_last_not_of(const_pointer s, size_type pos, size_type count) const;
-        size_type find_last_not_of(const_pointer s, size_type pos = npos) const;
-        size_type find_last_not_of(value_type ch, size_type pos = npos) const;
+        constexpr size_type find_last_not_of(const_pointer s, size_type pos, size_type count) const;
+        constexpr size_type find_last_not_of(const_pointer s, size_type pos = npos) const;
+        constexpr size_type find_last_not_of(value_type ch, size_type pos = npos) const;
 
     private:
 
-        int compare_impl(const_pointer s1, size_type count1, const_pointer s2, size_type count2) const noexcept;
-        void update_null_termination() noexcept;
-        void check_index(size_type pos, size_type size, const char* what) const;
-        void check_index_strict(size_type pos, size_type size, const char* what) const;
+        constexpr int compare_impl(const_pointer s1, size_type count1, const_pointer s2, size_type count2) const noexcept;
+        template <class InputIt>
+        static constexpr void copy_range(InputIt first, InputIt last, pointer dst);
+        constexpr void update_null_termination() noexcept;
+        constexpr void check_index(size_type pos, size_type size, const char* what) const;
+        constexpr void check_index_strict(size_type pos, size_type size, const char* what) const;
 
         storage_type m_storage;
     };
 
-    template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    const typename xbasic_fixed_string<CT, N, ST, EP, TR>::size_type xbasic_fixed_string<CT, N, ST, EP, TR>::npos
-        = std::basic_string<value_type, traits_type>::npos;
-
     template <std::size_t N>
     using xfixed_string = xbasic_fixed_string<char, N>;
 
@@ -483,62 +601,62 @@ namespace xeus
      **************************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               const CT* rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               CT rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const CT* lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(CT lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               const CT* rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               CT rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const CT* lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs);
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(CT lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs);
 
@@ -547,16 +665,16 @@ namespace xeus
      ************************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const CT* rhs) noexcept;
+    constexpr bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator==(const CT* lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator==(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
@@ -567,16 +685,16 @@ namespace xeus
                     const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const CT* rhs) noexcept;
+    constexpr bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator!=(const CT* lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator!=(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
@@ -587,16 +705,16 @@ namespace xeus
                     const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                   const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                   const CT* rhs) noexcept;
+    constexpr bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const std::remove_const_t<CT>* rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator<(const CT* lhs,
-                   const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator<(const std::remove_const_t<CT>* lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
@@ -607,16 +725,16 @@ namespace xeus
                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const CT* rhs) noexcept;
+    constexpr bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator<=(const CT* lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator<=(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
@@ -627,16 +745,16 @@ namespace xeus
                     const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                   const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                   const CT* rhs) noexcept;
+    constexpr bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const std::remove_const_t<CT>* rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator>(const CT* lhs,
-                   const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator>(const std::remove_const_t<CT>* lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
@@ -647,16 +765,16 @@ namespace xeus
                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                    const CT* rhs) noexcept;
+    constexpr bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    bool operator>=(const CT* lhs,
-                    const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
+    constexpr bool operator>=(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept;
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
@@ -701,9 +819,9 @@ namespace std
     {
         using argument_type = ::xeus::xbasic_fixed_string<CT, N, ST, EP, TR>;
         using result_type = std::size_t;
-        inline result_type operator()(const argument_type& arg) const
+        constexpr result_type operator()(const argument_type& arg) const
         {
-            return ::xeus::hash_bytes(arg.data(), arg.size(), std::size_t(0xc70f6907));
+            return ::xeus::hash_key_string(arg.data(), arg.size());
         }
     };
 }  // namespace std
@@ -719,11 +837,11 @@ namespace xeus
         template <std::size_t N>
         struct silent_error
         {
-            inline static std::size_t check_size(std::size_t size)
+            constexpr static std::size_t check_size(std::size_t size)
             {
                 return size;
             }
-            inline static std::size_t check_add(std::size_t size1, std::size_t size2)
+            constexpr static std::size_t check_add(std::size_t size1, std::size_t size2)
             {
                 return size1 + size2;
             }
@@ -732,21 +850,26 @@ namespace xeus
         template <std::size_t N>
         struct throwing_error
         {
-            inline static std::size_t check_size(std::size_t size)
+            constexpr static std::size_t check_size(std::size_t size)
             {
                 if (size > N)
                 {
-                    std::ostringstream oss;
-                    oss << "Invalid size (" << size << ") for xbasic_fixed_string - maximal size: " << N;
-                    throw std::length_error(oss.str());
+                    throw_length_error(size);
                 }
                 return size;
             }
 
-            inline static std::size_t check_add(std::size_t size1, std::size_t size2)
+            constexpr static std::size_t check_add(std::size_t size1, std::size_t size2)
             {
                 return check_size(size1 + size2);
             }
+
+            [[noreturn]] static void throw_length_error(std::size_t size)
+            {
+                std::ostringstream oss;
+                oss << "Invalid size (" << size << ") for xbasic_fixed_string - maximal size: " << N;
+                throw std::length_error(oss.str());
+            }
         };
     }  // string_policy
 
@@ -759,20 +882,20 @@ namespace xeus
      ****************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string()
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string()
         : m_storage()
     {
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(size_type count, value_type ch)
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(size_type count, value_type ch)
         : m_storage()
     {
         assign(count, ch);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(const self_type& other,
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(const self_type& other,
                                                                    size_type pos,
                                                                    size_type count)
         : m_storage()
@@ -797,21 +920,21 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(const_pointer s, size_type count)
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(const_pointer s, size_type count)
         : m_storage()
     {
         assign(s, count);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(const_pointer s)
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(const_pointer s)
         : m_storage()
     {
         assign(s);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(initializer_type ilist)
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(initializer_type ilist)
         : m_storage()
     {
         assign(ilist);
@@ -819,7 +942,7 @@ namespace xeus
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     template <class InputIt>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(InputIt first, InputIt last)
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>::xbasic_fixed_string(InputIt first, InputIt last)
         : m_storage()
     {
         assign(first, last);
@@ -828,7 +951,7 @@ namespace xeus
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     inline xbasic_fixed_string<CT, N, ST, EP, TR>::operator string_type() const
     {
-        return string_type(data());
+        return string_type(data(), size());
     }
 
     /**************
@@ -836,19 +959,19 @@ namespace xeus
      **************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator=(const_pointer s) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator=(const_pointer s) -> self_type&
     {
         return assign(s);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator=(value_type ch) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator=(value_type ch) -> self_type&
     {
         return assign(size_type(1), ch);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator=(initializer_type ilist) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator=(initializer_type ilist) -> self_type&
     {
         return assign(ilist);
     }
@@ -860,73 +983,79 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(size_type count, value_type ch) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(size_type count, value_type ch) -> self_type&
     {
         m_storage.set_size(error_policy::check_size(count));
-        traits_type::assign(data(), count, ch);
+        detail::assign_chars<traits_type>(data(), count, ch);
         return *this;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const self_type& other,
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const self_type& other,
                                                            size_type pos,
                                                            size_type count) -> self_type&
     {
         check_index_strict(pos, other.size(), "xbasic_fixed_string::assign");
         size_type copy_count = std::min(other.size() - pos, count);
-        m_storage.set_size(error_policy::check_size(copy_count));
-        traits_type::copy(data(), other.data() + pos, copy_count);
-        return *this;
+        return assign(other.data() + pos, copy_count);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const_pointer s, size_type count) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const_pointer s, size_type count) -> self_type&
     {
-        m_storage.set_size(error_policy::check_size(count));
-        traits_type::copy(data(), s, count);
+        if constexpr ((ST & is_const) != 0)
+        {
+            // String view, s is referenced
+            m_storage = storage_type(s, count);
+        }
+        else
+        {
+            m_storage.set_size(error_policy::check_size(count));
+            detail::copy_chars<traits_type>(data(), s, count);
+        }
         return *this;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const_pointer s) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const_pointer s) -> self_type&
     {
         std::size_t ssize = traits_type::length(s);
         return assign(s, ssize);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(initializer_type ilist) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(initializer_type ilist) -> self_type&
     {
         return assign(ilist.begin(), ilist.end());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     template <class InputIt>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(InputIt first, InputIt last) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(InputIt first, InputIt last) -> self_type&
     {
         m_storage.set_size(error_policy::check_size(static_cast<size_type>(std::distance(first, last))));
-        std::copy(first, last, data());
+        copy_range(first, last, data());
         return *this;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const self_type& rhs) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(const self_type& rhs) -> self_type&
     {
         if (this != &rhs)
         {
             m_storage.set_size(rhs.size());
-            traits_type::copy(data(), rhs.data(), rhs.size());
+            detail::copy_chars<traits_type>(data(), rhs.data(), rhs.size());
         }
         return *this;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(self_type&& rhs) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::assign(self_type&& rhs) -> self_type&
     {
         if (this != &rhs)
         {
             m_storage.set_size(rhs.size());
-            traits_type::copy(data(), rhs.data(), rhs.size());
+            detail::copy_chars<traits_type>(data(), rhs.data(), rhs.size());
         }
         return *this;
     }
@@ -950,69 +1079,69 @@ namespace xeus
      ******************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::at(size_type pos) -> reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::at(size_type pos) -> reference
     {
         check_index(pos, size(), "basic_fixed_string::at");
         return this->operator[](pos);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::at(size_type pos) const -> const_reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::at(size_type pos) const -> const_reference
     {
         check_index(pos, size(), "basic_fixed_string::at");
         return this->operator[](pos);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator[](size_type pos) -> reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator[](size_type pos) -> reference
     {
         return data()[pos];
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator[](size_type pos) const -> const_reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator[](size_type pos) const -> const_reference
     {
         return data()[pos];
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::front() -> reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::front() -> reference
     {
         return this->operator[](0);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::front() const -> const_reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::front() const -> const_reference
     {
         return this->operator[](0);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::back() -> reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::back() -> reference
     {
         return this->operator[](size() - 1);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::back() const -> const_reference
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::back() const -> const_reference
     {
         return this->operator[](size() - 1);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::data() noexcept -> pointer
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::data() noexcept -> pointer
     {
         return m_storage.buffer();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::data() const noexcept -> const_pointer
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::data() const noexcept -> const_pointer
     {
         return m_storage.buffer();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::c_str() const noexcept -> const_pointer
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::c_str() const noexcept -> const_pointer
     {
         return m_storage.buffer();
     }
@@ -1022,72 +1151,72 @@ namespace xeus
      *************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::begin() noexcept -> iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::begin() noexcept -> iterator
     {
         return data();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::end() noexcept -> iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::end() noexcept -> iterator
     {
         return data() + size();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::begin() const noexcept -> const_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::begin() const noexcept -> const_iterator
     {
         return cbegin();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::end() const noexcept -> const_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::end() const noexcept -> const_iterator
     {
         return cend();
     }
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::cbegin() const noexcept -> const_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::cbegin() const noexcept -> const_iterator
     {
         return data();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::cend() const noexcept -> const_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::cend() const noexcept -> const_iterator
     {
         return data() + size();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::rbegin() noexcept -> reverse_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rbegin() noexcept -> reverse_iterator
     {
         return reverse_iterator(end());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::rend() noexcept -> reverse_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rend() noexcept -> reverse_iterator
     {
         return reverse_iterator(begin());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::rbegin() const noexcept -> const_reverse_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rbegin() const noexcept -> const_reverse_iterator
     {
         return const_reverse_iterator(end());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::rend() const noexcept -> const_reverse_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rend() const noexcept -> const_reverse_iterator
     {
         return const_reverse_iterator(begin());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::crbegin() const noexcept -> const_reverse_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::crbegin() const noexcept -> const_reverse_iterator
     {
         return const_reverse_iterator(end());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::crend() const noexcept -> const_reverse_iterator
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::crend() const noexcept -> const_reverse_iterator
     {
         return const_reverse_iterator(begin());
     }
@@ -1097,25 +1226,25 @@ namespace xeus
      ************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool xbasic_fixed_string<CT, N, ST, EP, TR>::empty() const noexcept
+    constexpr bool xbasic_fixed_string<CT, N, ST, EP, TR>::empty() const noexcept
     {
         return size() == 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::size() const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::size() const noexcept -> size_type
     {
         return m_storage.size();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::length() const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::length() const noexcept -> size_type
     {
         return m_storage.size();
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::max_size() const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::max_size() const noexcept -> size_type
     {
         return N;
     }
@@ -1125,13 +1254,13 @@ namespace xeus
      **************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline void xbasic_fixed_string<CT, N, ST, EP, TR>::clear() noexcept
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::clear() noexcept
     {
         m_storage.set_size(0);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline void xbasic_fixed_string<CT, N, ST, EP, TR>::push_back(value_type ch)
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::push_back(value_type ch)
     {
         error_policy::check_add(size(), size_type(1));
         data()[size()] = ch;
@@ -1139,40 +1268,40 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline void xbasic_fixed_string<CT, N, ST, EP, TR>::pop_back()
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::pop_back()
     {
         m_storage.adjust_size(-1);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::substr(size_type pos, size_type count) const -> self_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::substr(size_type pos, size_type count) const -> self_type
     {
         return self_type(*this, pos, count);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::copy(pointer dest, size_type count, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::copy(pointer dest, size_type count, size_type pos) const -> size_type
     {
         check_index_strict(pos, size(), "xbasic_fixed_string::copy");
         size_type nb_copied = std::min(count, size() - pos);
-        traits_type::copy(dest, data() + pos, nb_copied);
+        detail::copy_chars<traits_type>(dest, data() + pos, nb_copied);
         return nb_copied;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline void xbasic_fixed_string<CT, N, ST, EP, TR>::resize(size_type count)
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::resize(size_type count)
     {
         resize(count, value_type(' '));  // need to initialize with some value != \0
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline void xbasic_fixed_string<CT, N, ST, EP, TR>::resize(size_type count, value_type ch)
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::resize(size_type count, value_type ch)
     {
         size_type old_size = size();
         m_storage.set_size(error_policy::check_size(count));
         if (old_size < size())
         {
-            traits_type::assign(data() + old_size, size() - old_size, ch);
+            detail::assign_chars<traits_type>(data() + old_size, size() - old_size, ch);
         }
     }
 
@@ -1326,22 +1455,22 @@ namespace xeus
      **********/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(size_type count, value_type ch) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(size_type count, value_type ch) -> self_type&
     {
         size_type old_size = m_storage.size();
         m_storage.set_size(error_policy::check_add(size(), count));
-        traits_type::assign(data() + old_size, count, ch);
+        detail::assign_chars<traits_type>(data() + old_size, count, ch);
         return *this;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const self_type& str) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const self_type& str) -> self_type&
     {
         return append(str.data(), str.size());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const self_type& str,
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const self_type& str,
                                                            size_type pos, size_type count) -> self_type&
     {
         check_index_strict(pos, str.size(), "xbasic_fixed_string::append");
@@ -1363,39 +1492,39 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const_pointer s, size_type count) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const_pointer s, size_type count) -> self_type&
     {
         size_type old_size = m_storage.size();
         m_storage.set_size(error_policy::check_add(size(), count));
-        traits_type::copy(data() + old_size, s, count);
+        detail::copy_chars<traits_type>(data() + old_size, s, count);
         return *this;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const_pointer s) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(const_pointer s) -> self_type&
     {
         return append(s, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(initializer_type ilist) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(initializer_type ilist) -> self_type&
     {
         return append(ilist.begin(), ilist.end());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
     template <class InputIt>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(InputIt first, InputIt last) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::append(InputIt first, InputIt last) -> self_type&
     {
         size_type count = static_cast<size_type>(std::distance(first, last));
         size_type old_size = m_storage.size();
         m_storage.set_size(error_policy::check_add(size(), count));
-        std::copy(first, last, data() + old_size);
+        copy_range(first, last, data() + old_size);
         return *this;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(const self_type& str) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(const self_type& str) -> self_type&
     {
         return append(str);
     }
@@ -1407,19 +1536,19 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(value_type ch) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(value_type ch) -> self_type&
     {
         return append(size_type(1), ch);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(const_pointer s) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(const_pointer s) -> self_type&
     {
         return append(s);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(initializer_type ilist) -> self_type&
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::operator+=(initializer_type ilist) -> self_type&
     {
         return append(ilist);
     }
@@ -1429,20 +1558,20 @@ namespace xeus
      ***********/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(const self_type& str) const noexcept
+    constexpr int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(const self_type& str) const noexcept
     {
         return compare_impl(data(), size(), str.data(), str.size());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const self_type& str) const
+    constexpr int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const self_type& str) const
     {
         check_index_strict(pos1, size(), "xbasic_fixed_string::compare");
         return compare_impl(data() + pos1, std::min(count1, size() - pos1), str.data(), str.size());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const self_type& str,
+    constexpr int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const self_type& str,
                                                            size_type pos2, size_type count2) const
     {
         check_index_strict(pos1, size(), "xbasic_fixed_string::compare");
@@ -1475,19 +1604,19 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(const_pointer s) const noexcept
+    constexpr int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(const_pointer s) const noexcept
     {
         return compare_impl(data(), size(), s, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const_pointer s) const
+    constexpr int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const_pointer s) const
     {
         return compare(pos1, count1, s, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
+    constexpr int xbasic_fixed_string<CT, N, ST, EP, TR>::compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
     {
         check_index_strict(pos1, size(), "xbasic_fixed_string::compare");
         return compare_impl(data() + pos1, std::min(count1, size() - pos1),
@@ -1675,7 +1804,7 @@ namespace xeus
      ********/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(const self_type& str, size_type pos) const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(const self_type& str, size_type pos) const noexcept -> size_type
     {
         return find(str.data(), pos, str.size());
     }
@@ -1687,17 +1816,18 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(const_pointer s, size_type pos, size_type count) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(const_pointer s, size_type pos, size_type count) const -> size_type
     {
         if (count == size_type(0) && pos <= size())
         {
             return pos;
         }
 
-        size_type nm;
+        size_type nm = 0;
         if (pos < size() && count <= (nm = size() - pos))
         {
-            const_pointer uptr, vptr;
+            const_pointer uptr = nullptr;
+            const_pointer vptr = nullptr;
             for (nm -= count - 1, vptr = data() + pos;
                  (uptr = traits_type::find(vptr, nm, *s)) != 0;
                  nm -= size_type(uptr - vptr) + 1ul, vptr = uptr + 1ul)
@@ -1712,13 +1842,13 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(const_pointer s, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(const_pointer s, size_type pos) const -> size_type
     {
         return find(s, pos, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(value_type ch, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find(value_type ch, size_type pos) const -> size_type
     {
         return find(&ch, pos, size_type(1));
     }
@@ -1728,7 +1858,7 @@ namespace xeus
      *********/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(const self_type& str, size_type pos) const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(const self_type& str, size_type pos) const noexcept -> size_type
     {
         return rfind(str.data(), pos, str.size());
     }
@@ -1740,7 +1870,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(const_pointer s, size_type pos, size_type count) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(const_pointer s, size_type pos, size_type count) const -> size_type
     {
         if (count == 0)
         {
@@ -1766,15 +1896,16 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(const_pointer s, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(const_pointer s, size_type pos) const -> size_type
     {
         return rfind(s, pos, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(value_type ch, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::rfind(value_type ch, size_type pos) const -> size_type
     {
-        return rfind(&ch, pos, size_type(1));
+        // Same as find_last_of, which is vectorized
+        return find_last_of(&ch, pos, size_type(1));
     }
 
     /*****************
@@ -1782,7 +1913,7 @@ namespace xeus
      *****************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(const self_type& str, size_type pos) const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(const self_type& str, size_type pos) const noexcept -> size_type
     {
         return find_first_of(str.data(), pos, str.size());
     }
@@ -1794,8 +1925,16 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(const_pointer s, size_type pos, size_type count) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(const_pointer s, size_type pos, size_type count) const -> size_type
     {
+        if constexpr (detail::is_char_string<CT, TR>)
+        {
+            if (!detail::is_constant_evaluated())
+            {
+                size_type res = pos < size() ? find_first_of_chars(data() + pos, size() - pos, s, count) : npos;
+                return res == npos ? npos : res + pos;
+            }
+        }
         if (size_type(0) < count && pos < size())
         {
             const_pointer vptr = data() + size();
@@ -1811,13 +1950,13 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(const_pointer s, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(const_pointer s, size_type pos) const -> size_type
     {
         return find_first_of(s, pos, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(value_type ch, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_of(value_type ch, size_type pos) const -> size_type
     {
         return find_first_of(&ch, pos, size_type(1));
     }
@@ -1827,7 +1966,7 @@ namespace xeus
      *********************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(const self_type& str, size_type pos) const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(const self_type& str, size_type pos) const noexcept -> size_type
     {
         return find_first_not_of(str.data(), pos, str.size());
     }
@@ -1839,8 +1978,16 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(const_pointer s, size_type pos, size_type count) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(const_pointer s, size_type pos, size_type count) const -> size_type
     {
+        if constexpr (detail::is_char_string<CT, TR>)
+        {
+            if (!detail::is_constant_evaluated())
+            {
+                size_type res = pos < size() ? find_first_not_of_chars(data() + pos, size() - pos, s, count) : npos;
+                return res == npos ? npos : res + pos;
+            }
+        }
         if (pos < size())
         {
             const_pointer vptr = data() + size();
@@ -1856,13 +2003,13 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(const_pointer s, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(const_pointer s, size_type pos) const -> size_type
     {
         return find_first_not_of(s, pos, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(value_type ch, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_first_not_of(value_type ch, size_type pos) const -> size_type
     {
         return find_first_not_of(&ch, pos, size_type(1));
     }
@@ -1872,7 +2019,7 @@ namespace xeus
      ****************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(const self_type& str, size_type pos) const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(const self_type& str, size_type pos) const noexcept -> size_type
     {
         return find_last_of(str.data(), pos, str.size());
     }
@@ -1884,8 +2031,15 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(const_pointer s, size_type pos, size_type count) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(const_pointer s, size_type pos, size_type count) const -> size_type
     {
+        if constexpr (detail::is_char_string<CT, TR>)
+        {
+            if (!detail::is_constant_evaluated())
+            {
+                return empty() ? npos : find_last_of_chars(data(), std::min(pos, size() - 1) + 1, s, count);
+            }
+        }
         if (size_type(0) < count && size_type(0) < size())
         {
             const_pointer uptr = data() + std::min(pos, size() - 1);
@@ -1905,13 +2059,13 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(const_pointer s, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(const_pointer s, size_type pos) const -> size_type
     {
         return find_last_of(s, pos, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(value_type ch, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_of(value_type ch, size_type pos) const -> size_type
     {
         return find_last_of(&ch, pos, size_type(1));
     }
@@ -1921,7 +2075,7 @@ namespace xeus
      ********************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(const self_type& str, size_type pos) const noexcept -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(const self_type& str, size_type pos) const noexcept -> size_type
     {
         return find_last_not_of(str.data(), pos, str.size());
     }
@@ -1933,8 +2087,15 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(const_pointer s, size_type pos, size_type count) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(const_pointer s, size_type pos, size_type count) const -> size_type
     {
+        if constexpr (detail::is_char_string<CT, TR>)
+        {
+            if (!detail::is_constant_evaluated())
+            {
+                return empty() ? npos : find_last_not_of_chars(data(), std::min(pos, size() - 1) + 1, s, count);
+            }
+        }
         if (size_type(0) < size())
         {
             const_pointer uptr = data() + std::min(pos, size() - 1);
@@ -1954,13 +2115,13 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(const_pointer s, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(const_pointer s, size_type pos) const -> size_type
     {
         return find_last_not_of(s, pos, traits_type::length(s));
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(value_type ch, size_type pos) const -> size_type
+    constexpr auto xbasic_fixed_string<CT, N, ST, EP, TR>::find_last_not_of(value_type ch, size_type pos) const -> size_type
     {
         return find_last_not_of(&ch, pos, size_type(1));
     }
@@ -1970,7 +2131,7 @@ namespace xeus
      *******************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    int xbasic_fixed_string<CT, N, ST, EP, TR>::compare_impl(const_pointer s1, size_type count1,
+    constexpr int xbasic_fixed_string<CT, N, ST, EP, TR>::compare_impl(const_pointer s1, size_type count1,
                                                          const_pointer s2, size_type count2) const noexcept
     {
         size_type rlen = std::min(count1, count2);
@@ -1986,13 +2147,30 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline void xbasic_fixed_string<CT, N, ST, EP, TR>::update_null_termination() noexcept
+    template <class InputIt>
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::copy_range(InputIt first, InputIt last, pointer dst)
+    {
+        if (detail::is_constant_evaluated())
+        {
+            for (; first != last; ++first, ++dst)
+            {
+                *dst = *first;
+            }
+        }
+        else
+        {
+            std::copy(first, last, dst);
+        }
+    }
+
+    template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::update_null_termination() noexcept
     {
         data()[size()] = '\0';
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    void xbasic_fixed_string<CT, N, ST, EP, TR>::check_index(size_type pos, size_type size, const char* what) const
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::check_index(size_type pos, size_type size, const char* what) const
     {
         if (pos >= size)
         {
@@ -2001,7 +2179,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    void xbasic_fixed_string<CT, N, ST, EP, TR>::check_index_strict(size_type pos, size_type size, const char* what) const
+    constexpr void xbasic_fixed_string<CT, N, ST, EP, TR>::check_index_strict(size_type pos, size_type size, const char* what) const
     {
         check_index(pos, size + 1, what);
     }
@@ -2011,7 +2189,7 @@ namespace xeus
      **************************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs)
     {
@@ -2020,7 +2198,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               const CT* rhs)
     {
@@ -2029,7 +2207,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               CT rhs)
     {
@@ -2038,7 +2216,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const CT* lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs)
     {
@@ -2047,7 +2225,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(CT lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs)
     {
@@ -2057,7 +2235,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs)
     {
@@ -2066,7 +2244,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs)
     {
@@ -2075,7 +2253,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs)
     {
@@ -2084,7 +2262,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               const CT* rhs)
     {
@@ -2093,7 +2271,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const xbasic_fixed_string<CT, N, ST, EP, TR>&& lhs,
               CT rhs)
     {
@@ -2102,7 +2280,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(const CT* lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs)
     {
@@ -2111,7 +2289,7 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline xbasic_fixed_string<CT, N, ST, EP, TR>
+    constexpr xbasic_fixed_string<CT, N, ST, EP, TR>
     operator+(CT lhs,
               const xbasic_fixed_string<CT, N, ST, EP, TR>&& rhs)
     {
@@ -2125,22 +2303,23 @@ namespace xeus
     ************************/
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
-        return lhs.compare(rhs) == 0;
+        return lhs.size() == rhs.size() && detail::equal_chars<TR>(lhs.data(), rhs.data(), lhs.size());
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const CT* rhs) noexcept
+    constexpr bool operator==(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept
     {
-        return lhs.compare(rhs) == 0;
+        std::size_t size = TR::length(rhs);
+        return lhs.size() == size && detail::equal_chars<TR>(lhs.data(), rhs, size);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator==(const CT* lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator==(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return rhs == lhs;
     }
@@ -2160,22 +2339,22 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
-        return lhs.compare(rhs) != 0;
+        return !(lhs == rhs);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const CT* rhs) noexcept
+    constexpr bool operator!=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept
     {
-        return lhs.compare(rhs) != 0;
+        return !(lhs == rhs);
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator!=(const CT* lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator!=(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return rhs != lhs;
     }
@@ -2195,22 +2374,22 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                          const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return lhs.compare(rhs) < 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                          const CT* rhs) noexcept
+    constexpr bool operator<(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const std::remove_const_t<CT>* rhs) noexcept
     {
         return lhs.compare(rhs) < 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator<(const CT* lhs,
-                          const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator<(const std::remove_const_t<CT>* lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return rhs > lhs;
     }
@@ -2230,22 +2409,22 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return lhs.compare(rhs) <= 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const CT* rhs) noexcept
+    constexpr bool operator<=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept
     {
         return lhs.compare(rhs) <= 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator<=(const CT* lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator<=(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return rhs >= lhs;
     }
@@ -2265,22 +2444,22 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                          const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return lhs.compare(rhs) > 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                          const CT* rhs) noexcept
+    constexpr bool operator>(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                             const std::remove_const_t<CT>* rhs) noexcept
     {
         return lhs.compare(rhs) > 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator>(const CT* lhs,
-                          const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator>(const std::remove_const_t<CT>* lhs,
+                             const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return rhs < lhs;
     }
@@ -2300,22 +2479,22 @@ namespace xeus
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return lhs.compare(rhs) >= 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
-                           const CT* rhs) noexcept
+    constexpr bool operator>=(const xbasic_fixed_string<CT, N, ST, EP, TR>& lhs,
+                              const std::remove_const_t<CT>* rhs) noexcept
     {
         return lhs.compare(rhs) >= 0;
     }
 
     template <class CT, std::size_t N, int ST, template <std::size_t> class EP, class TR>
-    inline bool operator>=(const CT* lhs,
-                           const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
+    constexpr bool operator>=(const std::remove_const_t<CT>* lhs,
+                              const xbasic_fixed_string<CT, N, ST, EP, TR>& rhs) noexcept
     {
         return rhs <= lhs;
     }
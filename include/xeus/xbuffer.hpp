@@ -0,0 +1,228 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_BUFFER_HPP
+#define XEUS_BUFFER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xeus
+{
+    /***********************
+     * xbuffer declaration *
+     ***********************/
+
+    /**
+     * @class xbuffer
+     * @brief Reference-counted read-only binary buffer.
+     *
+     * An xbuffer either owns its bytes (when it is built from a vector or a
+     * string, which are moved in) or aliases memory owned elsewhere. In the
+     * latter case, the owner is kept alive through a shared handle, or notified
+     * through a release callback when the last xbuffer referring to the memory
+     * is destroyed. Copying an xbuffer never copies the underlying bytes.
+     */
+    class xbuffer
+    {
+    public:
+
+        using value_type = char;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using const_reference = const char&;
+        using const_pointer = const char*;
+        using const_iterator = const char*;
+        using owner_type = std::shared_ptr<const void>;
+        using release_callback = std::function<void(const char*, size_type)>;
+
+        xbuffer() noexcept = default;
+
+        xbuffer(std::vector<char>&& data);
+        xbuffer(const std::vector<char>& data);
+        xbuffer(std::string&& data);
+        xbuffer(const char* first, const char* last);
+        xbuffer(const char* data, size_type size, release_callback release);
+        xbuffer(owner_type owner, const char* data, size_type size) noexcept;
+
+        const_pointer data() const noexcept;
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+        const_reference operator[](size_type i) const noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        xbuffer slice(size_type pos, size_type count) const;
+
+        const owner_type& owner() const noexcept;
+        long use_count() const noexcept;
+
+    private:
+
+        template <class C>
+        void adopt(C&& container);
+
+        owner_type p_owner;
+        const_pointer p_data = nullptr;
+        size_type m_size = 0;
+    };
+
+    bool operator==(const xbuffer& lhs, const xbuffer& rhs) noexcept;
+    bool operator!=(const xbuffer& lhs, const xbuffer& rhs) noexcept;
+
+    /**************************
+     * xbuffer implementation *
+     **************************/
+
+    template <class C>
+    inline void xbuffer::adopt(C&& container)
+    {
+        using container_type = std::decay_t<C>;
+        auto holder = std::make_shared<container_type>(std::forward<C>(container));
+        p_data = holder->data();
+        m_size = holder->size();
+        p_owner = std::move(holder);
+    }
+
+    inline xbuffer::xbuffer(std::vector<char>&& data)
+    {
+        adopt(std::move(data));
+    }
+
+    inline xbuffer::xbuffer(const std::vector<char>& data)
+    {
+        adopt(data);
+    }
+
+    inline xbuffer::xbuffer(std::string&& data)
+    {
+        adopt(std::move(data));
+    }
+
+    inline xbuffer::xbuffer(const char* first, const char* last)
+    {
+        adopt(std::vector<char>(first, last));
+    }
+
+    /**
+     * Aliases \c size bytes starting at \c data. \c release is called
+     * with the same arguments when the last xbuffer referring to these
+     * bytes is destroyed.
+     */
+    inline xbuffer::xbuffer(const char* data, size_type size, release_callback release)
+        : p_owner(data, [release = std::move(release), size](const void* p)
+          {
+              if (release)
+              {
+                  release(static_cast<const char*>(p), size);
+              }
+          })
+        , p_data(data)
+        , m_size(size)
+    {
+    }
+
+    /**
+     * Aliases \c size bytes starting at \c data, which must remain
+     * valid as long as \c owner is alive.
+     */
+    inline xbuffer::xbuffer(owner_type owner, const char* data, size_type size) noexcept
+        : p_owner(std::move(owner))
+        , p_data(data)
+        , m_size(size)
+    {
+    }
+
+    inline auto xbuffer::data() const noexcept -> const_pointer
+    {
+        return p_data;
+    }
+
+    inline auto xbuffer::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    inline bool xbuffer::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    inline auto xbuffer::operator[](size_type i) const noexcept -> const_reference
+    {
+        return p_data[i];
+    }
+
+    inline auto xbuffer::begin() const noexcept -> const_iterator
+    {
+        return p_data;
+    }
+
+    inline auto xbuffer::end() const noexcept -> const_iterator
+    {
+        return p_data + m_size;
+    }
+
+    inline auto xbuffer::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    inline auto xbuffer::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Returns a buffer viewing \c count bytes starting at \c pos and
+     * sharing the ownership of this buffer.
+     */
+    inline xbuffer xbuffer::slice(size_type pos, size_type count) const
+    {
+        if (pos > m_size)
+        {
+            throw std::out_of_range("xbuffer::slice: position out of range");
+        }
+        return xbuffer(p_owner, p_data + pos, (std::min)(count, m_size - pos));
+    }
+
+    inline auto xbuffer::owner() const noexcept -> const owner_type&
+    {
+        return p_owner;
+    }
+
+    inline long xbuffer::use_count() const noexcept
+    {
+        return p_owner.use_count();
+    }
+
+    inline bool operator==(const xbuffer& lhs, const xbuffer& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() &&
+            (lhs.data() == rhs.data() || lhs.empty() || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+    }
+
+    inline bool operator!=(const xbuffer& lhs, const xbuffer& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,133 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_CHUNKED_BUFFER_HPP
+#define XEUS_CHUNKED_BUFFER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "xeus/xbuffer.hpp"
+
+namespace xeus
+{
+    /*******************************
+     * xchunked_buffer declaration *
+     *******************************/
+
+    /**
+     * @class xchunked_buffer
+     * @brief Binary buffer made of a list of segments.
+     *
+     * A chunked buffer holds a logical binary buffer of a message as a list
+     * of segments, so that it never needs to be contiguous in memory. The
+     * segments are either stored in the buffer, or pulled on demand from a
+     * producer, which keeps the memory used by a large buffer bounded by the
+     * size of its segments.
+     *
+     * Segments are consumed with next, in order; a chunked buffer can only
+     * be read once.
+     */
+    class xchunked_buffer
+    {
+    public:
+
+        // Stores the next segment in its argument and returns true, or
+        // returns false when all the segments have been produced.
+        using producer = std::function<bool(xbuffer&)>;
+
+        xchunked_buffer() = default;
+        xchunked_buffer(xbuffer segment);
+        xchunked_buffer(std::vector<xbuffer> segments);
+        explicit xchunked_buffer(producer p);
+
+        // Whether segments are produced on demand
+        bool is_streamed() const noexcept;
+        // Segments stored in the buffer, including consumed ones
+        const std::vector<xbuffer>& segments() const noexcept;
+
+        bool next(xbuffer& segment);
+
+        // Consumes the remaining segments and returns them in a single
+        // buffer; a single stored segment is returned without copy.
+        xbuffer flatten();
+
+    private:
+
+        std::vector<xbuffer> m_segments;
+        std::size_t m_next = 0;
+        producer m_producer;
+    };
+
+    using chunked_buffer_sequence = std::vector<xchunked_buffer>;
+
+    /**********************************
+     * xchunked_buffer implementation *
+     **********************************/
+
+    inline xchunked_buffer::xchunked_buffer(xbuffer segment)
+        : m_segments(1, std::move(segment))
+    {
+    }
+
+    inline xchunked_buffer::xchunked_buffer(std::vector<xbuffer> segments)
+        : m_segments(std::move(segments))
+    {
+    }
+
+    inline xchunked_buffer::xchunked_buffer(producer p)
+        : m_producer(std::move(p))
+    {
+    }
+
+    inline bool xchunked_buffer::is_streamed() const noexcept
+    {
+        return static_cast<bool>(m_producer);
+    }
+
+    inline auto xchunked_buffer::segments() const noexcept -> const std::vector<xbuffer>&
+    {
+        return m_segments;
+    }
+
+    inline bool xchunked_buffer::next(xbuffer& segment)
+    {
+        if (m_next < m_segments.size())
+        {
+            segment = m_segments[m_next++];
+            return true;
+        }
+        if (m_producer && m_producer(segment))
+        {
+            return true;
+        }
+        // Release the resources held by the producer as soon as possible
+        m_producer = nullptr;
+        return false;
+    }
+
+    inline xbuffer xchunked_buffer::flatten()
+    {
+        if (!m_producer && m_next + 1 == m_segments.size())
+        {
+            return m_segments[m_next++];
+        }
+        std::vector<char> res;
+        xbuffer segment;
+        while (next(segment))
+        {
+            res.insert(res.end(), segment.begin(), segment.end());
+        }
+        return xbuffer(std::move(res));
+    }
+}
+
+#endif
@@ -10,13 +10,18 @@
 #ifndef XEUS_COMM_HPP
 #define XEUS_COMM_HPP
 
+#include <cstddef>
 #include <functional>
 #include <list>
-#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
+#include "xeus/xcompression.hpp"
 #include "xeus/xguid.hpp"
+#include "xeus/xhash.hpp"
+#include "xeus/xhash_map.hpp"
 #include "xeus/xjson.hpp"
 #include "xeus/xmessage.hpp"
 
@@ -48,6 +53,7 @@ namespace xeus
         void operator()(xcomm&& comm, xmessage request) const;
 
         void publish_message(const std::string&, nl::json, nl::json, buffer_sequence) const;
+        void publish_message(const std::string&, nl::json, nl::json, chunked_buffer_sequence) const;
 
         void register_comm(xguid, xcomm*) const;
         void unregister_comm(xguid) const;
@@ -85,6 +91,10 @@ namespace xeus
         void open(nl::json metadata, nl::json data, buffer_sequence buffers);
         void close(nl::json metadata, nl::json data, buffer_sequence buffers);
         void send(nl::json metadata, nl::json data, buffer_sequence buffers) const;
+        // Sends a comm message whose buffers are made of segments. The
+        // segments of a streamed buffer are produced while the server sends
+        // the message, so that the memory used is bounded by their size.
+        void send_chunked(nl::json metadata, nl::json data, chunked_buffer_sequence buffers) const;
 
         const xtarget& target() const noexcept;
 
@@ -93,6 +103,13 @@ namespace xeus
 
         xguid id() const noexcept;
 
+        // Codec used to compress the buffers of the messages sent by this
+        // comm, see compress_buffers. Only enable it when the frontend side
+        // of the comm understands the buffer_compression_key metadata.
+        // Chunked buffers are never compressed.
+        void set_buffer_codec(buffer_codec codec) noexcept;
+        buffer_codec get_buffer_codec() const noexcept;
+
         template <class T>
         void on_message(T&& handler);
         template <class T>
@@ -120,11 +137,16 @@ namespace xeus
                                nl::json data,
                                buffer_sequence,
                                const std::string& target_name) const;
+        void send_comm_message(const std::string& msg_type,
+                               nl::json metadata,
+                               nl::json data,
+                               chunked_buffer_sequence) const;
 
         handler_type m_close_handler;
         handler_type m_message_handler;
         const xtarget* p_target;
         xguid m_id;
+        buffer_codec m_buffer_codec;
         bool m_moved_from;
     };
 
@@ -134,6 +156,65 @@ namespace xeus
 
     class xkernel_core;
 
+    namespace detail
+    {
+        inline std::string_view comm_key(std::string_view key) noexcept
+        {
+            return key;
+        }
+
+        inline std::string_view comm_key(const char* key) noexcept
+        {
+            return key;
+        }
+
+        inline std::string_view comm_key(const std::string& key) noexcept
+        {
+            return key;
+        }
+
+        inline std::string_view comm_key(const xguid& key) noexcept
+        {
+            return std::string_view(key.data(), key.size());
+        }
+
+        // Throws nl::json::type_error if key is not a string
+        inline std::string_view comm_key(const nl::json& key)
+        {
+            return key.get_ref<const std::string&>();
+        }
+    }
+
+    /**
+     * Hash and equality of the keys of the comm and target registries.
+     * Comm ids and target names can be given as xguid, std::string,
+     * std::string_view or JSON strings, so that the comm id of a message
+     * is looked up without being copied. The hash of a xguid is the same
+     * as std::hash<xguid>.
+     */
+    struct xcomm_key_hash
+    {
+        using is_transparent = void;
+
+        template <class T>
+        std::size_t operator()(const T& key) const
+        {
+            std::string_view k = detail::comm_key(key);
+            return hash_key(k.data(), k.size());
+        }
+    };
+
+    struct xcomm_key_equal
+    {
+        using is_transparent = void;
+
+        template <class T1, class T2>
+        bool operator()(const T1& lhs, const T2& rhs) const
+        {
+            return detail::comm_key(lhs) == detail::comm_key(rhs);
+        }
+    };
+
     /**
      * @class xcomm_manager
      * @brief Manager and registry for comms and comm targets in the kernel.
@@ -143,6 +224,13 @@ namespace xeus
     public:
 
         xcomm_manager(xkernel_core* kernel = nullptr);
+        ~xcomm_manager() = default;
+
+        xcomm_manager(const xcomm_manager& rhs);
+        xcomm_manager& operator=(const xcomm_manager& rhs);
+
+        xcomm_manager(xcomm_manager&&) = default;
+        xcomm_manager& operator=(xcomm_manager&&) = default;
 
         using target_function_type = xtarget::function_type;
 
@@ -154,7 +242,11 @@ namespace xeus
         void comm_close(xmessage request);
         void comm_msg(xmessage request);
 
-        const std::map<xguid, xcomm*>& comms() const noexcept;
+        using comm_map = xhash_map<xguid, xcomm*, xcomm_key_hash, xcomm_key_equal>;
+
+        // The comms are not ordered, and opening or closing a comm
+        // invalidates the iterators and references into the map.
+        const comm_map& comms() const noexcept;
 
         const xtarget* target(const std::string& target_name) const;
 
@@ -167,8 +259,12 @@ namespace xeus
 
         nl::json get_metadata() const;
 
-        std::map<xguid, xcomm*> m_comms;
-        std::map<std::string, xtarget> m_targets;
+        // Targets are allocated separately since comms keep a pointer
+        // to their target
+        using target_map = xhash_map<std::string, std::unique_ptr<xtarget>, xcomm_key_hash, xcomm_key_equal>;
+
+        comm_map m_comms;
+        target_map m_targets;
         xkernel_core* p_kernel;
     };
 
@@ -0,0 +1,70 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_COMPRESSION_HPP
+#define XEUS_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "xeus/xeus.hpp"
+#include "xeus/xjson.hpp"
+#include "xeus/xmessage.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    /**
+     * Codecs for the binary buffers of messages. lz4 buffers use the LZ4
+     * block format, so that they can be decoded by any LZ4 implementation.
+     */
+    enum class buffer_codec : std::uint8_t
+    {
+        none,
+        lz4
+    };
+
+    // Key of the message metadata describing how the buffers are compressed:
+    // {"codec": "lz4", "sizes": [...]}, where sizes holds the decompressed
+    // size of each compressed buffer, and null for buffers sent as they are.
+    inline constexpr const char* buffer_compression_key = "buffer_compression";
+
+    // Buffers smaller than this are not worth compressing
+    inline constexpr std::size_t default_min_compressed_size = 1024;
+
+    XEUS_API std::size_t lz4_compress_bound(std::size_t size) noexcept;
+    XEUS_API binary_buffer lz4_compress(const char* data, std::size_t size);
+    // Throws std::runtime_error if data is not a valid LZ4 block decoding
+    // to exactly decompressed_size bytes. decompressed_size is checked
+    // against the maximal expansion of LZ4 before anything is allocated.
+    XEUS_API binary_buffer lz4_decompress(const char* data, std::size_t size, std::size_t decompressed_size);
+
+    /**
+     * Compresses the buffers with the given codec and describes the result
+     * in the metadata. Buffers smaller than min_size, or that do not shrink,
+     * are left untouched. Does nothing for buffer_codec::none.
+     */
+    XEUS_API void compress_buffers(nl::json& metadata,
+                                   buffer_sequence& buffers,
+                                   buffer_codec codec,
+                                   std::size_t min_size = default_min_compressed_size);
+
+    // Decompresses the buffers described by the metadata; does nothing if
+    // the metadata has no buffer_compression_key. Throws std::runtime_error
+    // for an unknown codec or a corrupted buffer.
+    XEUS_API void decompress_buffers(const nl::json& metadata, buffer_sequence& buffers);
+
+    // Returns message with decompressed buffers and without the
+    // buffer_compression_key in its metadata, or message itself if its
+    // buffers are not compressed.
+    XEUS_API xmessage decompress_buffers(xmessage message);
+}
+
+#endif
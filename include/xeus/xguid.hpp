@@ -25,7 +25,31 @@ namespace xeus
     // Here we want a size of 64 bytes, which gives room for 55 characters (64 - 8 - 1).
     using xguid = xfixed_string<55>;
 
+    /**
+     * Generators of xguid. Both produce ids made of 32 lowercase hexadecimal
+     * digits.
+     *
+     * - system relies on the UUID facility of the platform, which may issue a
+     *   system call for every id.
+     * - fast concatenates a random 64-bit prefix, drawn once per thread from
+     *   the system generator, and a per-thread counter. It never issues a
+     *   system call nor allocates after the first id of a thread, but its ids
+     *   are predictable and must not be used as secrets.
+     */
+    enum class xguid_generator
+    {
+        system,
+        fast
+    };
+
+    // Selects the generator used by new_xguid() in the whole process,
+    // including every kernel that was not given its own generator;
+    // defaults to xguid_generator::system.
+    XEUS_API void set_xguid_generator(xguid_generator generator) noexcept;
+    XEUS_API xguid_generator get_xguid_generator() noexcept;
+
     XEUS_API xguid new_xguid();
+    XEUS_API xguid new_xguid(xguid_generator generator);
 }
 
 #endif
@@ -16,6 +16,12 @@
 
 #include <type_traits>
 
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include "xeus/xeus.hpp"
+
 namespace xeus
 {
 
@@ -24,6 +30,44 @@ namespace xeus
     uint32_t murmur2_x86(const void* buffer, std::size_t length, uint32_t seed);
     uint64_t murmur2_x64(const void* buffer, std::size_t length, uint64_t seed);
 
+    struct xhash128
+    {
+        uint64_t m_low = 0;
+        uint64_t m_high = 0;
+    };
+
+    bool operator==(const xhash128& lhs, const xhash128& rhs) noexcept;
+    bool operator!=(const xhash128& lhs, const xhash128& rhs) noexcept;
+
+    /**
+     * Fast 64-bit and 128-bit hashes, of higher quality than the murmur
+     * hashes. Inputs up to long_hash_threshold bytes are hashed with
+     * the wyhash algorithm (by Wang Yi, released in the public domain),
+     * inlined. Longer inputs are accumulated in 64-byte stripes, in the
+     * spirit of XXH3, with SSE2 or AVX2 code selected at runtime; the
+     * result does not depend on the instruction set used.
+     *
+     * The bytes are read in native order, so the hashes differ between
+     * little-endian and big-endian platforms.
+     */
+    uint64_t hash64(const void* buffer, std::size_t length, uint64_t seed = 0) noexcept;
+    xhash128 hash128(const void* buffer, std::size_t length, uint64_t seed = 0) noexcept;
+
+    // hash64 as a std::size_t, for hash tables
+    std::size_t hash_key(const void* buffer, std::size_t length) noexcept;
+
+    /**
+     * hash64 and hash_key of the bytes of a character string, usable in
+     * constant expressions for strings of up to long_hash_threshold
+     * bytes. This allows to compute the hashes of constants at compile
+     * time; they are equal to the ones computed at runtime.
+     */
+    template <class CT>
+    constexpr uint64_t hash64_string(const CT* str, std::size_t count, uint64_t seed = 0) noexcept;
+
+    template <class CT>
+    constexpr std::size_t hash_key_string(const CT* str, std::size_t count) noexcept;
+
     /******************************
      *  hash_bytes implementation *
      ******************************/
@@ -57,7 +101,8 @@ namespace xeus
             
             while(len >= 4)
             {
-                uint32_t k = *reinterpret_cast<uint32_t*>(const_cast<unsigned char*>(data));
+                uint32_t k;
+                std::memcpy(&k, data, sizeof(k));
                 k *= m;
                 k ^= k >> 24;
                 k *= m;
@@ -164,7 +209,8 @@ namespace xeus
 
             while (length >= 4)
             {
-                uint32_t k = *(uint32_t*)data;
+                uint32_t k;
+                std::memcpy(&k, data, sizeof(k));
 
                 mmix(h, k, m, r);
 
@@ -209,6 +255,291 @@ namespace xeus
     {
         return detail::murmur_hash<8>(buffer, length, seed);
     }
+
+    /*************************************
+     * hash64 and hash128 implementation *
+     *************************************/
+
+    inline bool operator==(const xhash128& lhs, const xhash128& rhs) noexcept
+    {
+        return lhs.m_low == rhs.m_low && lhs.m_high == rhs.m_high;
+    }
+
+    inline bool operator!=(const xhash128& lhs, const xhash128& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    namespace detail
+    {
+        // True during constant evaluation. Without compiler support, this
+        // is always true, so that the code usable in constant expressions
+        // is always taken.
+        constexpr bool is_constant_evaluated() noexcept
+        {
+#if defined(__cpp_lib_is_constant_evaluated)
+            return std::is_constant_evaluated();
+#elif (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+            return __builtin_is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+            return __builtin_is_constant_evaluated();
+#else
+            return true;
+#endif
+#else
+            return true;
+#endif
+        }
+
+        constexpr std::size_t long_hash_threshold = 1024;
+
+        constexpr uint64_t wyhash_secret[4] = {
+            0xa0761d6478bd642full,
+            0xe7037ed1a0b428dbull,
+            0x8ebc6af09c88c6e3ull,
+            0x589965cc75374cc3ull
+        };
+
+        constexpr void multiply128_portable(uint64_t& a, uint64_t& b) noexcept
+        {
+            uint64_t ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+            uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            uint64_t t = rl + (rm0 << 32);
+            uint64_t c = t < rl ? 1 : 0;
+            uint64_t lo = t + (rm1 << 32);
+            c += lo < t ? 1 : 0;
+            a = lo;
+            b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        }
+
+        // Full 128-bit product of a and b, a receives the low part and
+        // b the high part
+        constexpr void multiply128(uint64_t& a, uint64_t& b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ using uint128 = unsigned __int128;
+            uint128 r = static_cast<uint128>(a) * b;
+            a = static_cast<uint64_t>(r);
+            b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            if (is_constant_evaluated())
+            {
+                multiply128_portable(a, b);
+            }
+            else
+            {
+                a = _umul128(a, b, &b);
+            }
+#else
+            multiply128_portable(a, b);
+#endif
+        }
+
+        constexpr uint64_t wymix(uint64_t a, uint64_t b) noexcept
+        {
+            multiply128(a, b);
+            return a ^ b;
+        }
+
+        inline uint64_t wyread8(const unsigned char* p) noexcept
+        {
+            uint64_t res;
+            std::memcpy(&res, p, sizeof(res));
+            return res;
+        }
+
+        inline uint64_t wyread4(const unsigned char* p) noexcept
+        {
+            uint32_t res;
+            std::memcpy(&res, p, sizeof(res));
+            return res;
+        }
+
+        // Reads the bytes of a buffer
+        struct byte_reader
+        {
+            uint64_t read8(std::size_t i) const noexcept
+            {
+                return wyread8(m_data + i);
+            }
+
+            uint64_t read4(std::size_t i) const noexcept
+            {
+                return wyread4(m_data + i);
+            }
+
+            uint64_t byte(std::size_t i) const noexcept
+            {
+                return m_data[i];
+            }
+
+            const unsigned char* m_data;
+        };
+
+        // Reads the bytes of a character string in constant expressions,
+        // in the order they have in memory
+        template <class CT>
+        struct char_reader
+        {
+            constexpr uint64_t read8(std::size_t i) const noexcept
+            {
+                return read(i, 8);
+            }
+
+            constexpr uint64_t read4(std::size_t i) const noexcept
+            {
+                return read(i, 4);
+            }
+
+            constexpr uint64_t byte(std::size_t i) const noexcept
+            {
+                using unsigned_type = std::make_unsigned_t<CT>;
+                std::size_t shift = i % sizeof(CT);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                shift = sizeof(CT) - 1 - shift;
+#endif
+                uint64_t c = static_cast<unsigned_type>(m_data[i / sizeof(CT)]);
+                return (c >> (8 * shift)) & 0xFF;
+            }
+
+            constexpr uint64_t read(std::size_t i, std::size_t n) const noexcept
+            {
+                uint64_t res = 0;
+                for (std::size_t k = 0; k < n; ++k)
+                {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                    res = (res << 8) | byte(i + k);
+#else
+                    res |= byte(i + k) << (8 * k);
+#endif
+                }
+                return res;
+            }
+
+            const CT* m_data;
+        };
+
+        template <class R>
+        constexpr uint64_t wyread3(const R& r, std::size_t k) noexcept
+        {
+            return (r.byte(0) << 16) | (r.byte(k >> 1) << 8) | r.byte(k - 1);
+        }
+
+        template <class R>
+        constexpr uint64_t wyhash_impl(const R& r, std::size_t length, uint64_t seed) noexcept
+        {
+            const uint64_t* secret = wyhash_secret;
+            seed ^= wymix(seed ^ secret[0], secret[1]);
+            uint64_t a = 0;
+            uint64_t b = 0;
+            if (length <= 16)
+            {
+                if (length >= 4)
+                {
+                    std::size_t offset = (length >> 3) << 2;
+                    a = (r.read4(0) << 32) | r.read4(offset);
+                    b = (r.read4(length - 4) << 32) | r.read4(length - 4 - offset);
+                }
+                else if (length > 0)
+                {
+                    a = wyread3(r, length);
+                }
+            }
+            else
+            {
+                std::size_t p = 0;
+                std::size_t i = length;
+                if (i > 48)
+                {
+                    uint64_t see1 = seed;
+                    uint64_t see2 = seed;
+                    do
+                    {
+                        seed = wymix(r.read8(p) ^ secret[1], r.read8(p + 8) ^ seed);
+                        see1 = wymix(r.read8(p + 16) ^ secret[2], r.read8(p + 24) ^ see1);
+                        see2 = wymix(r.read8(p + 32) ^ secret[3], r.read8(p + 40) ^ see2);
+                        p += 48;
+                        i -= 48;
+                    } while (i > 48);
+                    seed ^= see1 ^ see2;
+                }
+                while (i > 16)
+                {
+                    seed = wymix(r.read8(p) ^ secret[1], r.read8(p + 8) ^ seed);
+                    i -= 16;
+                    p += 16;
+                }
+                a = r.read8(p + i - 16);
+                b = r.read8(p + i - 8);
+            }
+            a ^= secret[1];
+            b ^= seed;
+            multiply128(a, b);
+            return wymix(a ^ secret[0] ^ length, b ^ secret[1]);
+        }
+
+        inline uint64_t wyhash(const void* buffer, std::size_t length, uint64_t seed) noexcept
+        {
+            return wyhash_impl(byte_reader{static_cast<const unsigned char*>(buffer)}, length, seed);
+        }
+
+        template <class T>
+        constexpr T truncate_hash(uint64_t hash) noexcept
+        {
+            return static_cast<T>(hash);
+        }
+
+        XEUS_API uint64_t hash64_long(const void* buffer, std::size_t length, uint64_t seed) noexcept;
+        XEUS_API xhash128 hash128_long(const void* buffer, std::size_t length, uint64_t seed) noexcept;
+    }
+
+    inline uint64_t hash64(const void* buffer, std::size_t length, uint64_t seed) noexcept
+    {
+        if (length > detail::long_hash_threshold)
+        {
+            return detail::hash64_long(buffer, length, seed);
+        }
+        return detail::wyhash(buffer, length, seed);
+    }
+
+    inline xhash128 hash128(const void* buffer, std::size_t length, uint64_t seed) noexcept
+    {
+        if (length > detail::long_hash_threshold)
+        {
+            return detail::hash128_long(buffer, length, seed);
+        }
+        // Two hashes with unrelated seeds
+        return {detail::wyhash(buffer, length, seed),
+                detail::wyhash(buffer, length, seed ^ detail::wyhash_secret[2])};
+    }
+
+    inline std::size_t hash_key(const void* buffer, std::size_t length) noexcept
+    {
+        return detail::truncate_hash<std::size_t>(hash64(buffer, length));
+    }
+
+    template <class CT>
+    constexpr uint64_t hash64_string(const CT* str, std::size_t count, uint64_t seed) noexcept
+    {
+        std::size_t length = count * sizeof(CT);
+        if (detail::is_constant_evaluated())
+        {
+            if (length > detail::long_hash_threshold)
+            {
+                // Not a constant expression
+                return detail::hash64_long(str, length, seed);
+            }
+            return detail::wyhash_impl(detail::char_reader<CT>{str}, length, seed);
+        }
+        return hash64(str, length, seed);
+    }
+
+    template <class CT>
+    constexpr std::size_t hash_key_string(const CT* str, std::size_t count) noexcept
+    {
+        return detail::truncate_hash<std::size_t>(hash64_string(str, count));
+    }
 }
 
 #endif
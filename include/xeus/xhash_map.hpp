@@ -0,0 +1,524 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_HASH_MAP_HPP
+#define XEUS_HASH_MAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xeus
+{
+    /*************************
+     * xhash_map declaration *
+     *************************/
+
+    /**
+     * @class xhash_map
+     * @brief Hash table with open addressing.
+     *
+     * Entries are stored in a single array and collisions are resolved
+     * with linear probing; erasing shifts back the following entries, so
+     * that lookups never need tombstones. Along with each entry, the table
+     * stores the hash of its key, which is compared before the key itself.
+     *
+     * Lookup and erase functions accept any key type supported by both
+     * Hash and KeyEqual, which allows to find an entry without building
+     * a key_type.
+     *
+     * Inserting an entry invalidates iterators and references to other
+     * entries when the table grows; erasing an entry may move other
+     * entries.
+     */
+    template <class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+    class xhash_map
+    {
+        struct slot;
+
+        template <bool is_const>
+        class iterator_impl;
+
+    public:
+
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<const K, V>;
+        using size_type = std::size_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+
+        xhash_map() = default;
+        ~xhash_map() = default;
+
+        xhash_map(const xhash_map&) = default;
+        xhash_map& operator=(const xhash_map&) = default;
+
+        xhash_map(xhash_map&& rhs) noexcept;
+        xhash_map& operator=(xhash_map&& rhs) noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type capacity() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        template <class Q>
+        iterator find(const Q& key);
+        template <class Q>
+        const_iterator find(const Q& key) const;
+        template <class Q>
+        bool contains(const Q& key) const;
+        template <class Q>
+        size_type count(const Q& key) const;
+
+        // Throws std::out_of_range if there is no entry for key
+        template <class Q>
+        mapped_type& at(const Q& key);
+        template <class Q>
+        const mapped_type& at(const Q& key) const;
+
+        template <class M>
+        std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value);
+        template <class Q>
+        size_type erase(const Q& key);
+        void clear() noexcept;
+
+        // Makes room for count entries without growing
+        void reserve(size_type count);
+
+    private:
+
+        struct slot
+        {
+            std::size_t m_hash = 0;
+            std::optional<value_type> m_value;
+        };
+
+        template <bool is_const>
+        class iterator_impl
+        {
+        public:
+
+            using slot_pointer = std::conditional_t<is_const, const slot*, slot*>;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename xhash_map::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<is_const, const value_type&, value_type&>;
+            using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+
+            iterator_impl() = default;
+            iterator_impl(slot_pointer position, slot_pointer last) noexcept;
+            // Conversion from iterator to const_iterator
+            template <bool C = is_const, class = std::enable_if_t<C>>
+            iterator_impl(const iterator_impl<false>& rhs) noexcept;
+
+            reference operator*() const noexcept;
+            pointer operator->() const noexcept;
+
+            iterator_impl& operator++() noexcept;
+            iterator_impl operator++(int) noexcept;
+
+            bool operator==(const iterator_impl& rhs) const noexcept;
+            bool operator!=(const iterator_impl& rhs) const noexcept;
+
+        private:
+
+            void skip_empty() noexcept;
+
+            slot_pointer p_position = nullptr;
+            slot_pointer p_last = nullptr;
+
+            friend class iterator_impl<true>;
+        };
+
+        static constexpr size_type min_capacity = 16;
+        static constexpr size_type npos = size_type(-1);
+
+        // The table is kept at most 3/4 full
+        static constexpr bool needs_growth(size_type size, size_type capacity) noexcept;
+
+        template <class Q>
+        size_type find_index(const Q& key) const;
+        void rehash(size_type capacity);
+
+        std::vector<slot> m_slots;
+        size_type m_size = 0;
+        hasher m_hasher;
+        key_equal m_key_equal;
+    };
+
+    /****************************
+     * xhash_map implementation *
+     ****************************/
+
+    template <class K, class V, class H, class E>
+    inline xhash_map<K, V, H, E>::xhash_map(xhash_map&& rhs) noexcept
+        : m_slots(std::move(rhs.m_slots))
+        , m_size(std::exchange(rhs.m_size, 0))
+        , m_hasher(std::move(rhs.m_hasher))
+        , m_key_equal(std::move(rhs.m_key_equal))
+    {
+        rhs.m_slots.clear();
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::operator=(xhash_map&& rhs) noexcept -> xhash_map&
+    {
+        m_slots = std::move(rhs.m_slots);
+        m_size = std::exchange(rhs.m_size, 0);
+        m_hasher = std::move(rhs.m_hasher);
+        m_key_equal = std::move(rhs.m_key_equal);
+        rhs.m_slots.clear();
+        return *this;
+    }
+
+    template <class K, class V, class H, class E>
+    inline bool xhash_map<K, V, H, E>::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::capacity() const noexcept -> size_type
+    {
+        return m_slots.size();
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::begin() noexcept -> iterator
+    {
+        return iterator(m_slots.data(), m_slots.data() + m_slots.size());
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::end() noexcept -> iterator
+    {
+        slot* last = m_slots.data() + m_slots.size();
+        return iterator(last, last);
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(m_slots.data(), m_slots.data() + m_slots.size());
+    }
+
+    template <class K, class V, class H, class E>
+    inline auto xhash_map<K, V, H, E>::cend() const noexcept -> const_iterator
+    {
+        const slot* last = m_slots.data() + m_slots.size();
+        return const_iterator(last, last);
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline auto xhash_map<K, V, H, E>::find(const Q& key) -> iterator
+    {
+        size_type index = find_index(key);
+        slot* last = m_slots.data() + m_slots.size();
+        return index == npos ? iterator(last, last) : iterator(m_slots.data() + index, last);
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline auto xhash_map<K, V, H, E>::find(const Q& key) const -> const_iterator
+    {
+        size_type index = find_index(key);
+        const slot* last = m_slots.data() + m_slots.size();
+        return index == npos ? const_iterator(last, last) : const_iterator(m_slots.data() + index, last);
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline bool xhash_map<K, V, H, E>::contains(const Q& key) const
+    {
+        return find_index(key) != npos;
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline auto xhash_map<K, V, H, E>::count(const Q& key) const -> size_type
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline auto xhash_map<K, V, H, E>::at(const Q& key) -> mapped_type&
+    {
+        size_type index = find_index(key);
+        if (index == npos)
+        {
+            throw std::out_of_range("xhash_map::at: key not found");
+        }
+        return m_slots[index].m_value->second;
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline auto xhash_map<K, V, H, E>::at(const Q& key) const -> const mapped_type&
+    {
+        size_type index = find_index(key);
+        if (index == npos)
+        {
+            throw std::out_of_range("xhash_map::at: key not found");
+        }
+        return m_slots[index].m_value->second;
+    }
+
+    template <class K, class V, class H, class E>
+    template <class M>
+    inline auto xhash_map<K, V, H, E>::insert_or_assign(const key_type& key, M&& value) -> std::pair<iterator, bool>
+    {
+        if (needs_growth(m_size + 1, m_slots.size()))
+        {
+            rehash(m_slots.empty() ? min_capacity : 2 * m_slots.size());
+        }
+
+        std::size_t hash = m_hasher(key);
+        size_type mask = m_slots.size() - 1;
+        size_type index = hash & mask;
+        while (m_slots[index].m_value)
+        {
+            slot& s = m_slots[index];
+            if (s.m_hash == hash && m_key_equal(s.m_value->first, key))
+            {
+                s.m_value->second = std::forward<M>(value);
+                return {iterator(&s, m_slots.data() + m_slots.size()), false};
+            }
+            index = (index + 1) & mask;
+        }
+
+        slot& s = m_slots[index];
+        s.m_hash = hash;
+        s.m_value.emplace(key, std::forward<M>(value));
+        ++m_size;
+        return {iterator(&s, m_slots.data() + m_slots.size()), true};
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline auto xhash_map<K, V, H, E>::erase(const Q& key) -> size_type
+    {
+        size_type hole = find_index(key);
+        if (hole == npos)
+        {
+            return 0;
+        }
+        m_slots[hole].m_value.reset();
+        --m_size;
+
+        // Shifts back the following entries of the cluster that can be
+        // found from the hole, i.e. whose home slot is not between the
+        // hole and their current slot
+        size_type mask = m_slots.size() - 1;
+        size_type index = (hole + 1) & mask;
+        while (m_slots[index].m_value)
+        {
+            size_type home = m_slots[index].m_hash & mask;
+            if (((index - home) & mask) >= ((index - hole) & mask))
+            {
+                slot& dst = m_slots[hole];
+                slot& src = m_slots[index];
+                dst.m_hash = src.m_hash;
+                dst.m_value.emplace(std::move(*src.m_value));
+                src.m_value.reset();
+                hole = index;
+            }
+            index = (index + 1) & mask;
+        }
+        return 1;
+    }
+
+    template <class K, class V, class H, class E>
+    inline void xhash_map<K, V, H, E>::clear() noexcept
+    {
+        for (slot& s : m_slots)
+        {
+            s.m_value.reset();
+        }
+        m_size = 0;
+    }
+
+    template <class K, class V, class H, class E>
+    inline void xhash_map<K, V, H, E>::reserve(size_type count)
+    {
+        size_type capacity = m_slots.empty() ? min_capacity : m_slots.size();
+        while (needs_growth(count, capacity))
+        {
+            capacity *= 2;
+        }
+        if (capacity != m_slots.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    template <class K, class V, class H, class E>
+    constexpr bool xhash_map<K, V, H, E>::needs_growth(size_type size, size_type capacity) noexcept
+    {
+        return 4 * size > 3 * capacity;
+    }
+
+    template <class K, class V, class H, class E>
+    template <class Q>
+    inline auto xhash_map<K, V, H, E>::find_index(const Q& key) const -> size_type
+    {
+        if (m_size == 0)
+        {
+            return npos;
+        }
+        std::size_t hash = m_hasher(key);
+        size_type mask = m_slots.size() - 1;
+        size_type index = hash & mask;
+        // The table is never full, the probing ends on an empty slot
+        while (m_slots[index].m_value)
+        {
+            const slot& s = m_slots[index];
+            if (s.m_hash == hash && m_key_equal(s.m_value->first, key))
+            {
+                return index;
+            }
+            index = (index + 1) & mask;
+        }
+        return npos;
+    }
+
+    template <class K, class V, class H, class E>
+    inline void xhash_map<K, V, H, E>::rehash(size_type capacity)
+    {
+        std::vector<slot> slots(capacity);
+        size_type mask = capacity - 1;
+        for (slot& s : m_slots)
+        {
+            if (s.m_value)
+            {
+                size_type index = s.m_hash & mask;
+                while (slots[index].m_value)
+                {
+                    index = (index + 1) & mask;
+                }
+                slots[index].m_hash = s.m_hash;
+                slots[index].m_value.emplace(std::move(*s.m_value));
+            }
+        }
+        m_slots = std::move(slots);
+    }
+
+    /*******************************************
+     * xhash_map::iterator_impl implementation *
+     *******************************************/
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline xhash_map<K, V, H, E>::iterator_impl<is_const>::iterator_impl(slot_pointer position, slot_pointer last) noexcept
+        : p_position(position)
+        , p_last(last)
+    {
+        skip_empty();
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    template <bool C, class>
+    inline xhash_map<K, V, H, E>::iterator_impl<is_const>::iterator_impl(const iterator_impl<false>& rhs) noexcept
+        : p_position(rhs.p_position)
+        , p_last(rhs.p_last)
+    {
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline auto xhash_map<K, V, H, E>::iterator_impl<is_const>::operator*() const noexcept -> reference
+    {
+        return *(p_position->m_value);
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline auto xhash_map<K, V, H, E>::iterator_impl<is_const>::operator->() const noexcept -> pointer
+    {
+        return &*(p_position->m_value);
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline auto xhash_map<K, V, H, E>::iterator_impl<is_const>::operator++() noexcept -> iterator_impl&
+    {
+        ++p_position;
+        skip_empty();
+        return *this;
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline auto xhash_map<K, V, H, E>::iterator_impl<is_const>::operator++(int) noexcept -> iterator_impl
+    {
+        iterator_impl tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline bool xhash_map<K, V, H, E>::iterator_impl<is_const>::operator==(const iterator_impl& rhs) const noexcept
+    {
+        return p_position == rhs.p_position;
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline bool xhash_map<K, V, H, E>::iterator_impl<is_const>::operator!=(const iterator_impl& rhs) const noexcept
+    {
+        return p_position != rhs.p_position;
+    }
+
+    template <class K, class V, class H, class E>
+    template <bool is_const>
+    inline void xhash_map<K, V, H, E>::iterator_impl<is_const>::skip_empty() noexcept
+    {
+        while (p_position != p_last && !p_position->m_value)
+        {
+            ++p_position;
+        }
+    }
+}
+
+#endif
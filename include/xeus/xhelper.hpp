@@ -38,45 +38,65 @@ namespace xeus
 
     XEUS_API bool should_print_version(int argc, char* argv[]);
 
+    // The reply builders take ownership of their arguments: pass large
+    // values (matches, mime bundles, tracebacks) as rvalues to move them
+    // into the reply instead of copying them.
+
+    XEUS_API
+    nl::json create_error_reply(std::string ename = std::string(),
+                                std::string evalue = std::string(),
+                                nl::json trace_back = nl::json::array());
+
     XEUS_API
-    nl::json create_error_reply(const std::string& ename = std::string(),
-                                const std::string& evalue = std::string(),
-                                const nl::json& trace_back = nl::json::array());
+    nl::json create_successful_reply(nl::json payload = nl::json::array(),
+                                     nl::json user_expressions = nl::json::object());
 
     XEUS_API
-    nl::json create_successful_reply(const nl::json& payload = nl::json::array(),
-                                     const nl::json& user_expressions = nl::json::object());
+    nl::json create_complete_reply(nl::json matches,
+                                   int cursor_start,
+                                   int cursor_end,
+                                   nl::json metadata = nl::json::object());
+
+    /**
+     * Typed content of a complete_reply. The matches are moved into the
+     * reply, which is built with a single allocation for the array of
+     * matches.
+     */
+    struct XEUS_API complete_reply_content
+    {
+        std::vector<std::string> m_matches;
+        int m_cursor_start = 0;
+        int m_cursor_end = 0;
+        nl::json m_metadata = nl::json::object();
+    };
 
     XEUS_API
-    nl::json create_complete_reply(const nl::json& matches,
-                                   const int& cursor_start,
-                                   const int& cursor_end,
-                                   const nl::json& metadata = nl::json::object());
+    nl::json create_complete_reply(complete_reply_content&& reply);
 
     XEUS_API
-    nl::json create_inspect_reply(const bool found = false,
-                                  const nl::json& data = nl::json::object(),
-                                  const nl::json& metadata = nl::json::object());
+    nl::json create_inspect_reply(bool found = false,
+                                  nl::json data = nl::json::object(),
+                                  nl::json metadata = nl::json::object());
 
     XEUS_API
-    nl::json create_is_complete_reply(const std::string& status = std::string(),
-                                      const std::string& indent = std::string(""));
+    nl::json create_is_complete_reply(std::string status = std::string(),
+                                      std::string indent = std::string(""));
 
     using codemirror_mode_t = std::variant<std::string, nl::json>;
 
     XEUS_API
-    nl::json create_info_reply(const std::string& implementation = std::string(),
-                               const std::string& implementation_version = std::string(),
-                               const std::string& language_name = std::string(),
-                               const std::string& language_version = std::string(),
-                               const std::string& language_mimetype = std::string(),
-                               const std::string& language_file_extension = std::string(),
-                               const std::string& pygments_lexer = std::string(),
+    nl::json create_info_reply(std::string implementation = std::string(),
+                               std::string implementation_version = std::string(),
+                               std::string language_name = std::string(),
+                               std::string language_version = std::string(),
+                               std::string language_mimetype = std::string(),
+                               std::string language_file_extension = std::string(),
+                               std::string pygments_lexer = std::string(),
                                codemirror_mode_t language_codemirror_mode = std::string(),
-                               const std::string& language_nbconvert_exporter = std::string(),
-                               const std::string& banner = std::string(),
-                               const nl::json& help_links = nl::json::array(),
-                               const std::vector<std::string>& supported_features = std::vector<std::string>());
+                               std::string language_nbconvert_exporter = std::string(),
+                               std::string banner = std::string(),
+                               nl::json help_links = nl::json::array(),
+                               std::vector<std::string> supported_features = std::vector<std::string>());
 
     XEUS_API
     nl::json create_shutdown_reply(bool restart);
@@ -15,6 +15,7 @@
 
 #include "xeus/xeus.hpp"
 #include "xeus/xjson.hpp"
+#include "xeus/xrequest_content.hpp"
 
 namespace nl = nlohmann;
 
@@ -40,6 +41,7 @@ namespace xeus
                           const std::string& output = "");
 
         nl::json process_request(const nl::json& content) const;
+        nl::json process_request(const history_request_content& content) const;
 
         nl::json get_tail(int n, bool raw, bool output) const;
         nl::json get_range(int session, int start, int stop, bool raw, bool output) const;
@@ -12,6 +12,7 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "xeus/xcomm.hpp"
@@ -69,26 +70,37 @@ namespace xeus
         nl::json internal_request(const nl::json& message);
 
         // publish(msg_type, metadata, content)
-        using publisher_type = std::function<void(xrequest_context, const std::string&, nl::json, nl::json, buffer_sequence)>;
+        using publisher_type = std::function<void(xrequest_context, std::string_view, nl::json, xmessage_section, buffer_sequence)>;
         void register_publisher(const publisher_type& publisher);
 
-        void publish_stream(const std::string& name, const std::string& text);
+        // Publishes content that has already been serialized to JSON,
+        // the bytes are forwarded to the server without being parsed.
+        void publish_serialized_content(std::string_view msg_type,
+                                        nl::json metadata,
+                                        binary_buffer content,
+                                        buffer_sequence buffers = buffer_sequence());
+
+        // The text is moved to the content of the message when it is
+        // passed as an rvalue, and copied once otherwise.
+        void publish_stream(std::string_view name, std::string_view text);
+        void publish_stream(std::string_view name, const char* text);
+        void publish_stream(std::string_view name, std::string&& text);
         void display_data(nl::json data, nl::json metadata, nl::json transient);
         void update_display_data(nl::json data, nl::json metadata, nl::json transient);
-        void publish_execution_input(const std::string& code, int execution_count);
+        void publish_execution_input(std::string_view code, int execution_count);
         void publish_execution_result(int execution_count, nl::json data, nl::json metadata);
-        void publish_execution_error(const std::string& ename,
-                                     const std::string& evalue,
-                                     const std::vector<std::string>& trace_back);
+        void publish_execution_error(std::string_view ename,
+                                     std::string_view evalue,
+                                     std::vector<std::string> trace_back);
         void clear_output(bool wait);
 
         // send_stdin(msg_type, metadata, content)
-        using stdin_sender_type = std::function<void(xrequest_context, const std::string&, nl::json, nl::json)>;
+        using stdin_sender_type = std::function<void(xrequest_context, std::string_view, nl::json, nl::json)>;
         void register_stdin_sender(const stdin_sender_type& sender);
         using input_reply_handler_type = std::function<void(const std::string&)>;
         void register_input_handler(const input_reply_handler_type& handler);
 
-        void input_request(const std::string& prompt, bool pwd);
+        void input_request(std::string_view prompt, bool pwd);
         void input_reply(const std::string& value);
 
         void register_comm_manager(xcomm_manager* manager);
@@ -11,16 +11,19 @@
 #define XEUS_KERNEL_HPP
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <functional>
 
 #include "xeus/xdebugger.hpp"
 #include "xeus/xeus.hpp"
 #include "xeus/xeus_context.hpp"
+#include "xeus/xguid.hpp"
 #include "xeus/xhistory_manager.hpp"
 #include "xeus/xinterpreter.hpp"
 #include "xeus/xkernel_configuration.hpp"
 #include "xeus/xserver.hpp"
+#include "xeus/xstatus_policy.hpp"
 #include "xeus/xlogger.hpp"
 
 namespace xeus
@@ -50,6 +53,10 @@ namespace xeus
                                                 const std::string&,
                                                 const nl::json&)>;
 
+        // guid_generator selects the generator of the ids of the messages
+        // sent by this kernel only; when it is not set, they are drawn from
+        // the process-wide generator (see set_xguid_generator). The ids of
+        // comms always come from the process-wide generator.
         xkernel(xconfiguration config,
                 const std::string& user_name,
                 context_ptr context,
@@ -59,7 +66,8 @@ namespace xeus
                 logger_ptr logger = nullptr,
                 debugger_builder dbuilder = make_null_debugger,
                 nl::json debugger_config = nl::json::object(),
-                nl::json::error_handler_t eh = nl::json::error_handler_t::strict);
+                nl::json::error_handler_t eh = nl::json::error_handler_t::strict,
+                std::optional<xguid_generator> guid_generator = std::nullopt);
 
         xkernel(const std::string& user_name,
                 context_ptr context,
@@ -69,7 +77,8 @@ namespace xeus
                 logger_ptr logger = nullptr,
                 debugger_builder dbuilder = make_null_debugger,
                 nl::json debugger_config = nl::json::object(),
-                nl::json::error_handler_t eh = nl::json::error_handler_t::strict);
+                nl::json::error_handler_t eh = nl::json::error_handler_t::strict,
+                std::optional<xguid_generator> guid_generator = std::nullopt);
 
         ~xkernel();
 
@@ -79,6 +88,10 @@ namespace xeus
         const xkernel_configuration& get_config();
         xserver& get_server();
 
+        // Selects when the busy and idle status messages are published,
+        // must be called before start.
+        void set_status_policy(const xstatus_policy& policy);
+
     private:
 
         xkernel_configuration m_config;
@@ -97,6 +110,7 @@ namespace xeus
         kernel_core_ptr p_core;
         nl::json m_debugger_config;
         nl::json::error_handler_t m_error_handler;
+        std::optional<xguid_generator> m_guid_generator;
     };
 }
 
@@ -80,10 +80,13 @@ namespace xeus
     std::unique_ptr<xlogger> make_console_logger(xlogger::level log_level,
                                                  std::unique_ptr<xlogger> next_logger = nullptr);
 
+    // With a binary encoding, the log file is a sequence of records made of
+    // their size on four bytes (little endian) followed by the encoded record.
     XEUS_API
     std::unique_ptr<xlogger> make_file_logger(xlogger::level log_level,
                                               const std::string& file_name,
-                                              std::unique_ptr<xlogger> next_logger = nullptr);
+                                              std::unique_ptr<xlogger> next_logger = nullptr,
+                                              message_encoding encoding = message_encoding::json);
 }
 
 #endif
@@ -10,19 +10,93 @@
 #ifndef XEUS_MESSAGE_HPP
 #define XEUS_MESSAGE_HPP
 
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "xeus/xbuffer.hpp"
+#include "xeus/xchunked_buffer.hpp"
 #include "xeus/xeus.hpp"
+#include "xeus/xguid.hpp"
 #include "xeus/xjson.hpp"
 
 namespace nl = nlohmann;
 
 namespace xeus
 {
-    using binary_buffer = std::vector<char>;
+    // Buffers are reference counted so that they can be carried from the
+    // interpreter to the transport without copying their bytes.
+    using binary_buffer = xbuffer;
     using buffer_sequence = std::vector<binary_buffer>;
 
+    /**
+     * Fields of a header that do not change across the messages sent by
+     * a kernel. They are shared by the headers built by an xheader_factory.
+     */
+    struct XEUS_API xheader_fields
+    {
+        std::string m_username;
+        std::string m_session;
+        std::string m_version;
+        // Wire JSON of the fields above, written as is by serialize_header
+        // when it is not empty
+        std::string m_serialized;
+    };
+
+    /**
+     * Typed header of a message.
+     */
+    struct XEUS_API xmessage_header
+    {
+        using time_point = std::chrono::system_clock::time_point;
+
+        // The protocol does not bound the length of msg_id, received ids
+        // may not fit in an xguid
+        std::string m_msg_id;
+        std::string m_msg_type;
+        time_point m_date;
+        std::shared_ptr<const xheader_fields> p_fields;
+
+        // Empty strings if p_fields is null
+        const std::string& username() const noexcept;
+        const std::string& session() const noexcept;
+        const std::string& version() const noexcept;
+    };
+
+    XEUS_API void to_json(nl::json& j, const xmessage_header& header);
+
+    // Decodes the typed header from a JSON header. Missing fields are
+    // left empty, a malformed date throws.
+    XEUS_API xmessage_header parse_header(const nl::json& header);
+
+    // Writes the wire JSON of the header, with the same layout as
+    // nl::json(header).dump(), without building a JSON tree.
+    XEUS_API std::string serialize_header(const xmessage_header& header);
+    // Writes the same bytes to out
+    XEUS_API void serialize_header(const xmessage_header& header, std::ostream& out);
+
+    /**
+     * Encoding of the serialized JSON sections of a message. The Jupyter
+     * protocol uses text JSON; the binary encodings are meant for in-process
+     * transports and logs, where both ends are xeus.
+     */
+    enum class message_encoding
+    {
+        json,
+        cbor,
+        msgpack
+    };
+
+    XEUS_API binary_buffer serialize_json(const nl::json& value, message_encoding encoding);
+
+    // An empty buffer is decoded as an empty object
+    XEUS_API nl::json parse_json(const binary_buffer& buffer, message_encoding encoding);
+
     struct XEUS_API xmessage_base_data
     {
         nl::json m_header;
@@ -32,6 +106,65 @@ namespace xeus
         buffer_sequence m_buffers;
     };
 
+    /**
+     * Serialized frames of a message, as received from the wire. Each
+     * JSON frame is parsed only when the corresponding section of the
+     * message is accessed.
+     *
+     * The binary buffers of a message that were built chunked are kept in
+     * m_chunked_buffers, after those of m_buffers, so that transports can
+     * send them segment by segment.
+     */
+    struct XEUS_API xmessage_serialized_data
+    {
+        binary_buffer m_header;
+        binary_buffer m_parent_header;
+        binary_buffer m_metadata;
+        binary_buffer m_content;
+        buffer_sequence m_buffers;
+        chunked_buffer_sequence m_chunked_buffers;
+        message_encoding m_encoding = message_encoding::json;
+    };
+
+    /**
+     * @class xmessage_section
+     * @brief JSON section of a message.
+     *
+     * A section is either built from a JSON value, or from its serialized
+     * form, which is parsed on the first access to the JSON value. In the
+     * latter case, the serialized bytes remain available so that they can
+     * be forwarded without being dumped again. Parsing on access is not
+     * synchronized, a section must not be accessed concurrently before it
+     * has been parsed.
+     */
+    class XEUS_API xmessage_section
+    {
+    public:
+
+        xmessage_section() = default;
+        xmessage_section(nl::json value);
+        explicit xmessage_section(binary_buffer serialized,
+                                  message_encoding encoding = message_encoding::json);
+
+        const nl::json& json() const;
+
+        bool is_parsed() const noexcept;
+        bool is_serialized() const noexcept;
+        const binary_buffer& serialized() const noexcept;
+        message_encoding encoding() const noexcept;
+
+        // Returns the serialized bytes if they already have the requested
+        // encoding, serializes the JSON value otherwise.
+        binary_buffer serialized(message_encoding encoding) const;
+
+    private:
+
+        mutable nl::json m_value;
+        binary_buffer m_serialized;
+        message_encoding m_encoding = message_encoding::json;
+        mutable bool m_parsed = true;
+    };
+
     class XEUS_API xmessage_base
     {
     public:
@@ -44,18 +177,45 @@ namespace xeus
         const nl::json& metadata() const;
         const nl::json& content() const;
 
+        const xmessage_header& typed_header() const;
+        const std::string& msg_type() const;
+
+        const xmessage_section& header_section() const;
+        const xmessage_section& parent_header_section() const noexcept;
+        const xmessage_section& metadata_section() const noexcept;
+        const xmessage_section& content_section() const noexcept;
+
+        // Chunked buffers are flattened on the first access to the
+        // contiguous buffers; transports that can stream them should
+        // check has_chunked_buffers and use chunked_buffers instead.
         const buffer_sequence& buffers() const&;
         buffer_sequence&& buffers() &&;
 
+        bool has_chunked_buffers() const noexcept;
+        // Returns the binary buffers of the message as chunked buffers,
+        // contiguous buffers are returned as single segments
+        chunked_buffer_sequence&& chunked_buffers() &&;
+
     protected:
 
         xmessage_base() = default;
-        xmessage_base(nl::json header,
-                      nl::json parent_header,
-                      nl::json metadata,
-                      nl::json content,
+        xmessage_base(xmessage_section header,
+                      xmessage_section parent_header,
+                      xmessage_section metadata,
+                      xmessage_section content,
+                      buffer_sequence buffers);
+        xmessage_base(xmessage_header header,
+                      xmessage_section parent_header,
+                      xmessage_section metadata,
+                      xmessage_section content,
                       buffer_sequence buffers);
+        xmessage_base(xmessage_header header,
+                      xmessage_section parent_header,
+                      xmessage_section metadata,
+                      xmessage_section content,
+                      chunked_buffer_sequence buffers);
         xmessage_base(xmessage_base_data&& data);
+        xmessage_base(xmessage_serialized_data&& data);
         ~xmessage_base() = default;
 
         xmessage_base(xmessage_base&&) = default;
@@ -63,11 +223,20 @@ namespace xeus
 
     private:
 
-        nl::json m_header;
-        nl::json m_parent_header;
-        nl::json m_metadata;
-        nl::json m_content;
-        buffer_sequence m_buffers;
+        friend class xmessage_serializer;
+
+        void flatten_buffers() const;
+
+        // When the message is built from a typed header, the JSON header
+        // is only computed if it is accessed, and conversely.
+        mutable xmessage_section m_header;
+        mutable std::optional<xmessage_header> m_typed_header;
+        mutable bool m_header_pending = false;
+        xmessage_section m_parent_header;
+        xmessage_section m_metadata;
+        xmessage_section m_content;
+        mutable buffer_sequence m_buffers;
+        mutable chunked_buffer_sequence m_chunked_buffers;
     };
 
     class XEUS_API xmessage : public xmessage_base
@@ -79,13 +248,21 @@ namespace xeus
 
         xmessage() = default;
         xmessage(const guid_list& zmq_id,
-                 nl::json header,
-                 nl::json parent_header,
-                 nl::json metadata,
-                 nl::json content,
+                 xmessage_section header,
+                 xmessage_section parent_header,
+                 xmessage_section metadata,
+                 xmessage_section content,
+                 buffer_sequence buffers);
+        xmessage(const guid_list& zmq_id,
+                 xmessage_header header,
+                 xmessage_section parent_header,
+                 xmessage_section metadata,
+                 xmessage_section content,
                  buffer_sequence buffers);
         xmessage(const guid_list& zmq_id,
                  xmessage_base_data&& data);
+        xmessage(const guid_list& zmq_id,
+                 xmessage_serialized_data&& data);
 
         ~xmessage() = default;
 
@@ -110,13 +287,27 @@ namespace xeus
 
         xpub_message() = default;
         xpub_message(const std::string& topic,
-                     nl::json header,
-                     nl::json parent_header,
-                     nl::json metadata,
-                     nl::json content,
+                     xmessage_section header,
+                     xmessage_section parent_header,
+                     xmessage_section metadata,
+                     xmessage_section content,
                      buffer_sequence buffers);
+        xpub_message(const std::string& topic,
+                     xmessage_header header,
+                     xmessage_section parent_header,
+                     xmessage_section metadata,
+                     xmessage_section content,
+                     buffer_sequence buffers);
+        xpub_message(const std::string& topic,
+                     xmessage_header header,
+                     xmessage_section parent_header,
+                     xmessage_section metadata,
+                     xmessage_section content,
+                     chunked_buffer_sequence buffers);
         xpub_message(const std::string& topic,
                      xmessage_base_data&& data);
+        xpub_message(const std::string& topic,
+                     xmessage_serialized_data&& data);
 
         ~xpub_message() = default;
 
@@ -135,11 +326,68 @@ namespace xeus
 
     XEUS_API std::string iso8601_now();
 
+    XEUS_API std::string iso8601(std::chrono::system_clock::time_point tp);
+
+    // Size of the ISO 8601 representation of a date, with a microsecond
+    // precision: YYYY-MM-DDTHH:MM:SS.ffffffZ
+    inline constexpr std::size_t iso8601_size = 27;
+
+    // Writes the ISO 8601 representation of tp to out, which must hold at
+    // least iso8601_size characters. No null character is written. This
+    // function neither allocates nor depends on the locale, and can be
+    // called concurrently.
+    XEUS_API void format_iso8601(std::chrono::system_clock::time_point tp, char* out) noexcept;
+
+    XEUS_API std::chrono::system_clock::time_point parse_iso8601(const std::string& date);
+
     XEUS_API std::string get_protocol_version();
 
-    XEUS_API nl::json make_header(const std::string& msg_type,
-                                  const std::string& user_name,
-                                  const std::string& session_id);
+    XEUS_API nl::json make_header(std::string_view msg_type,
+                                  std::string_view user_name,
+                                  std::string_view session_id);
+
+    XEUS_API xmessage_header make_typed_header(std::string_view msg_type,
+                                               std::string_view user_name,
+                                               std::string_view session_id);
+
+    /*******************************
+     * xheader_factory declaration *
+     *******************************/
+
+    /**
+     * @class xheader_factory
+     * @brief Builds the headers of the messages sent by a kernel.
+     *
+     * The username, session and version fields do not change across the
+     * messages sent by a kernel. They are built and serialized once and
+     * shared by the headers of the factory, so that only msg_id, date and
+     * msg_type are built and written for each header.
+     *
+     * The msg_id of the headers is drawn from the given generator, or from
+     * the process-wide generator selected by set_xguid_generator when none
+     * is given.
+     */
+    class XEUS_API xheader_factory
+    {
+    public:
+
+        xheader_factory(const std::string& user_name,
+                        const std::string& session_id,
+                        std::optional<xguid_generator> generator = std::nullopt);
+
+        const std::string& user_name() const noexcept;
+        const std::string& session_id() const noexcept;
+
+        nl::json make_header(std::string_view msg_type) const;
+        xmessage_header make_typed_header(std::string_view msg_type) const;
+
+    private:
+
+        xguid new_msg_id() const;
+
+        std::shared_ptr<const xheader_fields> p_fields;
+        std::optional<xguid_generator> m_generator;
+    };
 }
 
 #endif
@@ -0,0 +1,131 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_MESSAGE_SERIALIZER_HPP
+#define XEUS_MESSAGE_SERIALIZER_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "xeus/xeus.hpp"
+#include "xeus/xmessage.hpp"
+
+namespace xeus
+{
+    /****************************
+     * xbuffer_pool declaration *
+     ****************************/
+
+    /**
+     * @class xbuffer_pool
+     * @brief Pool of byte vectors backing serialized frames.
+     *
+     * A vector handed over to the pool through adopt is given back to the
+     * pool, with its capacity, when the last xbuffer referring to it is
+     * destroyed. This can happen on any thread, and after the pool itself
+     * has been destroyed. Copies of a pool share the same vectors.
+     */
+    class XEUS_API xbuffer_pool
+    {
+    public:
+
+        static constexpr std::size_t default_max_buffers = 16;
+
+        explicit xbuffer_pool(std::size_t max_buffers = default_max_buffers);
+
+        // Returns an empty vector, with the capacity of a recycled vector
+        // if the pool holds one
+        std::vector<char> acquire() const;
+        binary_buffer adopt(std::vector<char>&& data) const;
+
+        // Number of vectors currently held by the pool
+        std::size_t available() const;
+
+    private:
+
+        struct state;
+
+        static void recycle(const std::weak_ptr<state>& pool, std::vector<char>* data) noexcept;
+
+        std::shared_ptr<state> p_state;
+    };
+
+    /***********************************
+     * xmessage_serializer declaration *
+     ***********************************/
+
+    /**
+     * @class xmessage_serializer
+     * @brief Encodes the JSON frames of messages and decodes them back.
+     *
+     * The header, parent_header, metadata and content frames are written
+     * one after the other in a single buffer, without intermediate strings:
+     * sections that are already serialized with the right encoding are
+     * copied as they are, the others are written straight from their JSON
+     * value. Deserialization only splits the frames, each section is parsed
+     * when it is accessed.
+     *
+     * The identities, delimiter and signature frames of the wire protocol
+     * are left to the transport.
+     */
+    class XEUS_API xmessage_serializer
+    {
+    public:
+
+        static constexpr std::size_t frame_count = 4;
+        using frame_sizes = std::array<std::size_t, frame_count>;
+
+        // error_handler is applied to invalid UTF-8 in the JSON values
+        // written with the text JSON encoding, as in nl::json::dump
+        explicit xmessage_serializer(message_encoding encoding = message_encoding::json,
+                                     xbuffer_pool pool = xbuffer_pool(),
+                                     nl::json::error_handler_t error_handler = nl::json::error_handler_t::strict) noexcept;
+
+        message_encoding encoding() const noexcept;
+        const xbuffer_pool& pool() const noexcept;
+        nl::json::error_handler_t error_handler() const noexcept;
+
+        // Sizes of the frames of message, computed without storing them
+        frame_sizes sizes(const xmessage_base& message) const;
+
+        // Appends the frames of message to out
+        frame_sizes serialize(const xmessage_base& message, std::vector<char>& out) const;
+        // Writes the frames of message to out, throws std::length_error if
+        // they do not fit in capacity bytes
+        frame_sizes serialize(const xmessage_base& message, char* out, std::size_t capacity) const;
+        // Writes the frames of message to a pooled buffer; the frames of the
+        // result share this buffer, the binary buffers of message are shared
+        // and not copied. Chunked buffers are kept chunked, except streamed
+        // ones, which can only be read once: they are flattened, unless the
+        // message is passed as an rvalue, in which case they are moved.
+        xmessage_serialized_data serialize(const xmessage_base& message) const;
+        xmessage_serialized_data serialize(xmessage_base&& message) const;
+
+        // frames holds the four JSON frames followed by the binary buffers;
+        // throws std::invalid_argument if it holds fewer than four frames
+        xmessage_serialized_data deserialize(buffer_sequence frames) const;
+        // data holds the JSON frames one after the other, as written by serialize
+        xmessage_serialized_data deserialize(const binary_buffer& data,
+                                             const frame_sizes& sizes,
+                                             buffer_sequence buffers) const;
+
+    private:
+
+        template <class B>
+        frame_sizes write_frames(const xmessage_base& message, B& buffer) const;
+
+        message_encoding m_encoding;
+        xbuffer_pool m_pool;
+        nl::json::error_handler_t m_error_handler;
+    };
+}
+
+#endif
@@ -0,0 +1,235 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_MESSAGE_TYPE_HPP
+#define XEUS_MESSAGE_TYPE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace xeus
+{
+    /**
+     * Message types defined by the Jupyter messaging protocol. Custom
+     * message types are mapped to message_type::unknown and must be
+     * handled through their string representation.
+     */
+    enum class message_type : std::uint8_t
+    {
+        // shell and control requests and replies
+        execute_request,
+        execute_reply,
+        inspect_request,
+        inspect_reply,
+        complete_request,
+        complete_reply,
+        history_request,
+        history_reply,
+        is_complete_request,
+        is_complete_reply,
+        comm_info_request,
+        comm_info_reply,
+        kernel_info_request,
+        kernel_info_reply,
+        shutdown_request,
+        shutdown_reply,
+        interrupt_request,
+        interrupt_reply,
+        debug_request,
+        debug_reply,
+        // comms
+        comm_open,
+        comm_msg,
+        comm_close,
+        // iopub
+        stream,
+        display_data,
+        update_display_data,
+        execute_input,
+        execute_result,
+        error,
+        status,
+        clear_output,
+        debug_event,
+        shutdown,
+        interrupt,
+        // stdin
+        input_request,
+        input_reply,
+        // custom message types
+        unknown
+    };
+
+    inline constexpr std::size_t message_type_count = static_cast<std::size_t>(message_type::unknown);
+
+    // Canonical names of the message types, indexed by message_type
+    inline constexpr std::array<std::string_view, message_type_count> message_type_names =
+    {
+        "execute_request",
+        "execute_reply",
+        "inspect_request",
+        "inspect_reply",
+        "complete_request",
+        "complete_reply",
+        "history_request",
+        "history_reply",
+        "is_complete_request",
+        "is_complete_reply",
+        "comm_info_request",
+        "comm_info_reply",
+        "kernel_info_request",
+        "kernel_info_reply",
+        "shutdown_request",
+        "shutdown_reply",
+        "interrupt_request",
+        "interrupt_reply",
+        "debug_request",
+        "debug_reply",
+        "comm_open",
+        "comm_msg",
+        "comm_close",
+        "stream",
+        "display_data",
+        "update_display_data",
+        "execute_input",
+        "execute_result",
+        "error",
+        "status",
+        "clear_output",
+        "debug_event",
+        "shutdown",
+        "interrupt",
+        "input_request",
+        "input_reply"
+    };
+
+    constexpr std::string_view to_string(message_type type) noexcept;
+    constexpr message_type to_message_type(std::string_view name) noexcept;
+    constexpr message_type reply_type(message_type request) noexcept;
+
+    /*******************************
+     * message_type implementation *
+     *******************************/
+
+    /**
+     * Returns the canonical name of a message type, or an empty string
+     * for message_type::unknown.
+     */
+    constexpr std::string_view to_string(message_type type) noexcept
+    {
+        auto index = static_cast<std::size_t>(type);
+        return index < message_type_count ? message_type_names[index] : std::string_view();
+    }
+
+    namespace detail
+    {
+        // Perfect hash of the message type names: the length and three
+        // characters of a name are packed in a 32-bit key, which is
+        // mapped to a slot of the table by a multiplicative hash. The
+        // multiplier is searched at compile time so that no two names
+        // fall in the same slot.
+        inline constexpr std::size_t message_type_slot_bits = 7;
+        inline constexpr std::size_t message_type_slot_count = std::size_t(1) << message_type_slot_bits;
+
+        constexpr std::uint32_t message_type_key(std::string_view name) noexcept
+        {
+            std::size_t size = name.size();
+            return static_cast<std::uint32_t>(size & 0xFFu)
+                | static_cast<std::uint32_t>(static_cast<unsigned char>(name[0])) << 8
+                | static_cast<std::uint32_t>(static_cast<unsigned char>(name[size / 2])) << 16
+                | static_cast<std::uint32_t>(static_cast<unsigned char>(name[size - 1])) << 24;
+        }
+
+        constexpr std::size_t message_type_slot(std::uint32_t key, std::uint32_t multiplier) noexcept
+        {
+            std::uint32_t product = key * multiplier;
+            return product >> (32 - message_type_slot_bits);
+        }
+
+        struct message_type_table
+        {
+            std::uint32_t m_multiplier = 0;
+            // Index of the message type stored in each slot, or
+            // message_type_count for empty slots
+            std::array<std::uint8_t, message_type_slot_count> m_slots = {};
+        };
+
+        constexpr message_type_table make_message_type_table() noexcept
+        {
+            message_type_table res;
+            std::uint32_t multiplier = 0x9E3779B1u;
+            for (std::size_t attempt = 0; attempt < 4096; ++attempt)
+            {
+                for (auto& s : res.m_slots)
+                {
+                    s = static_cast<std::uint8_t>(message_type_count);
+                }
+                bool collision = false;
+                for (std::size_t i = 0; i < message_type_count && !collision; ++i)
+                {
+                    std::size_t slot = message_type_slot(message_type_key(message_type_names[i]), multiplier);
+                    collision = res.m_slots[slot] != message_type_count;
+                    res.m_slots[slot] = static_cast<std::uint8_t>(i);
+                }
+                if (!collision)
+                {
+                    res.m_multiplier = multiplier;
+                    return res;
+                }
+                multiplier = (multiplier + 0xD413CCCEu) | 1u;
+            }
+            return res;
+        }
+
+        inline constexpr message_type_table message_types = make_message_type_table();
+
+        static_assert(message_types.m_multiplier != 0,
+                      "no perfect hash found for the message type names");
+    }
+
+    /**
+     * Returns the message type of a name, or message_type::unknown for
+     * custom message types. The lookup costs a single comparison of
+     * strings.
+     */
+    constexpr message_type to_message_type(std::string_view name) noexcept
+    {
+        if (name.empty())
+        {
+            return message_type::unknown;
+        }
+        std::uint32_t key = detail::message_type_key(name);
+        std::size_t index = detail::message_types.m_slots[detail::message_type_slot(key, detail::message_types.m_multiplier)];
+        return index < message_type_count && message_type_names[index] == name
+            ? static_cast<message_type>(index)
+            : message_type::unknown;
+    }
+
+    /**
+     * Returns the type of the reply to a request, or message_type::unknown
+     * if the argument is not a request.
+     */
+    constexpr message_type reply_type(message_type request) noexcept
+    {
+        if (request == message_type::input_request)
+        {
+            return message_type::input_reply;
+        }
+        // Shell and control requests and replies are interleaved at
+        // the beginning of the table
+        auto index = static_cast<std::size_t>(request);
+        return index <= static_cast<std::size_t>(message_type::debug_request) && index % 2 == 0
+            ? static_cast<message_type>(index + 1)
+            : message_type::unknown;
+    }
+}
+
+#endif
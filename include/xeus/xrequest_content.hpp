@@ -0,0 +1,113 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_REQUEST_CONTENT_HPP
+#define XEUS_REQUEST_CONTENT_HPP
+
+#include <string>
+
+#include "xeus/xeus.hpp"
+#include "xeus/xjson.hpp"
+#include "xeus/xmessage.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    /**
+     * Typed contents of the requests handled by the kernel. Fields that
+     * are missing from a request hold the default value of the protocol.
+     *
+     * Strings are owned rather than viewed: the interpreter and history
+     * APIs take them as const std::string&, and the content of an
+     * execute_request outlives the message. They are moved out of the
+     * parser when decoding serialized bytes, so a received frame is never
+     * copied twice.
+     */
+
+    struct XEUS_API execute_request_content
+    {
+        std::string m_code;
+        bool m_silent = false;
+        bool m_store_history = true;
+        nl::json m_user_expressions = nl::json::object();
+        bool m_allow_stdin = true;
+        bool m_stop_on_error = false;
+    };
+
+    struct XEUS_API complete_request_content
+    {
+        std::string m_code;
+        int m_cursor_pos = -1;
+    };
+
+    struct XEUS_API inspect_request_content
+    {
+        std::string m_code;
+        int m_cursor_pos = -1;
+        int m_detail_level = 0;
+    };
+
+    struct XEUS_API is_complete_request_content
+    {
+        std::string m_code;
+    };
+
+    struct XEUS_API history_request_content
+    {
+        std::string m_hist_access_type = "tail";
+        bool m_output = false;
+        bool m_raw = true;
+        int m_session = 0;
+        int m_start = 1;
+        int m_stop = 10;
+        int m_n = 10;
+        std::string m_pattern = "*";
+        bool m_unique = false;
+    };
+
+    /**
+     * Decode the content of a request in a single pass. If the section
+     * has not been parsed yet, the fields are decoded straight from its
+     * serialized bytes, without building the JSON value of the section.
+     * The values of unknown fields are skipped without being decoded. A
+     * field with an unexpected JSON type throws nl::json::type_error,
+     * unless it is a field of a history request that is not read for its
+     * hist_access_type.
+     */
+
+    XEUS_API void decode_content(const xmessage_section& section, execute_request_content& content);
+    XEUS_API void decode_content(const xmessage_section& section, complete_request_content& content);
+    XEUS_API void decode_content(const xmessage_section& section, inspect_request_content& content);
+    XEUS_API void decode_content(const xmessage_section& section, is_complete_request_content& content);
+    XEUS_API void decode_content(const xmessage_section& section, history_request_content& content);
+
+    XEUS_API void decode_content(const nl::json& json, execute_request_content& content);
+    XEUS_API void decode_content(const nl::json& json, complete_request_content& content);
+    XEUS_API void decode_content(const nl::json& json, inspect_request_content& content);
+    XEUS_API void decode_content(const nl::json& json, is_complete_request_content& content);
+    XEUS_API void decode_content(const nl::json& json, history_request_content& content);
+
+    template <class T, class S>
+    T decode_content(const S& source);
+
+    /*********************************
+     * decode_content implementation *
+     *********************************/
+
+    template <class T, class S>
+    inline T decode_content(const S& source)
+    {
+        T content;
+        decode_content(source, content);
+        return content;
+    }
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include "xeus/xkernel_configuration.hpp"
 #include "xeus/xcontrol_messenger.hpp"
 #include "xeus/xmessage.hpp"
+#include "xeus/xmessage_serializer.hpp"
 
 namespace xeus
 {
@@ -45,6 +46,9 @@ namespace xeus
         void send_shell(xmessage message);
         void send_control(xmessage message);
         void send_stdin(xmessage message);
+        // The content of a published message may still be in serialized form
+        // (see xmessage_section::is_serialized), in which case the server
+        // should send these bytes as they are instead of dumping content().
         void publish(xpub_message message, channel c);
 
         void start(xpub_message message);
@@ -57,9 +61,23 @@ namespace xeus
         void register_stdin_listener(const listener& l);
         void register_internal_listener(const internal_listener& l);
 
+        // Encoding of the JSON sections of the messages exchanged by the
+        // server. Servers speaking the Jupyter protocol over the wire must
+        // keep the default (text JSON); in-process and shared-memory
+        // implementations may opt into a binary encoding, see
+        // xmessage_section::serialized(message_encoding).
+        void set_message_encoding(message_encoding encoding) noexcept;
+        message_encoding get_message_encoding() const noexcept;
+
+        // Serializer shared by the server implementations to encode and
+        // decode the JSON frames of the messages, with the encoding above.
+        const xmessage_serializer& get_message_serializer() const noexcept;
+
     protected:
 
-        xserver() = default;
+        // error_handler is the handler given to the server builder by the
+        // kernel, it is used by the message serializer
+        explicit xserver(nl::json::error_handler_t error_handler = nl::json::error_handler_t::strict);
 
         void notify_shell_listener(xmessage msg);
         void notify_control_listener(xmessage msg);
@@ -84,6 +102,7 @@ namespace xeus
         listener m_control_listener;
         listener m_stdin_listener;
         internal_listener m_internal_listener;
+        xmessage_serializer m_serializer;
     };
 }
 
@@ -0,0 +1,57 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_STATUS_POLICY_HPP
+#define XEUS_STATUS_POLICY_HPP
+
+#include <chrono>
+#include <vector>
+
+#include "xeus/xmessage_type.hpp"
+
+namespace xeus
+{
+    /**
+     * @class xstatus_policy
+     * @brief Publication of the busy and idle status messages.
+     *
+     * By default, the kernel publishes a busy status before handling each
+     * request and an idle status after it, as the Jupyter messaging
+     * protocol requires.
+     *
+     * When m_quiet_threshold is positive, the busy status of the requests
+     * listed in m_quiet_requests is deferred until they publish a message
+     * on iopub, or until they send their reply after having been handled
+     * for m_quiet_threshold or longer. If such a request publishes nothing
+     * and is handled in less than m_quiet_threshold, its busy status is
+     * dropped. The idle status is always published after the reply, so
+     * that frontends waiting for it (JupyterLab resolves the future of a
+     * request on idle) are unaffected; when the busy status is published,
+     * it precedes the reply, the idle status and the messages published by
+     * the request.
+     *
+     * execute_request and the other requests whose handler replies
+     * asynchronously always get both status messages, so the ordering
+     * that frontends rely on for executions is unchanged. Some frontends
+     * wait for the idle status of other requests too (for instance,
+     * ipywidgets throttles comm_msg this way), the list of quiet requests
+     * should only hold the types that the frontend does not track.
+     */
+    struct xstatus_policy
+    {
+        std::chrono::microseconds m_quiet_threshold = std::chrono::microseconds::zero();
+        std::vector<message_type> m_quiet_requests = {
+            message_type::complete_request,
+            message_type::inspect_request,
+            message_type::is_complete_request
+        };
+    };
+}
+
+#endif
@@ -12,21 +12,64 @@
 
 #include <cstddef>
 #include <string>
-#include <sstream>
-#include <iomanip>
+
+#include "xeus/xeus.hpp"
 
 namespace xeus
 {
-    template <class B>
-    inline std::string hex_string(const B& buffer)
+    // Writes the 2 * size lowercase hexadecimal digits of the size bytes
+    // at data to out.
+    XEUS_API void hex_encode(const void* data, std::size_t size, char* out) noexcept;
+
+    // Writes the size / 2 bytes encoded by the size hexadecimal digits at
+    // data to out; digits can be lower or upper case. Returns false if size
+    // is odd or data contains a character that is not a hexadecimal digit,
+    // in which case the content of out is unspecified.
+    XEUS_API bool hex_decode(const char* data, std::size_t size, void* out) noexcept;
+
+    // Returns the position of the first character of the size characters
+    // at data that is (respectively is not) one of the set_size
+    // characters at set, or std::string::npos if there is none. The
+    // search is vectorized, with SSE2 or AVX2 instructions selected at
+    // runtime.
+    XEUS_API std::size_t find_first_of_chars(const char* data, std::size_t size,
+                                             const char* set, std::size_t set_size) noexcept;
+    XEUS_API std::size_t find_first_not_of_chars(const char* data, std::size_t size,
+                                                 const char* set, std::size_t set_size) noexcept;
+
+    // Same as above for the last character
+    XEUS_API std::size_t find_last_of_chars(const char* data, std::size_t size,
+                                            const char* set, std::size_t set_size) noexcept;
+    XEUS_API std::size_t find_last_not_of_chars(const char* data, std::size_t size,
+                                                const char* set, std::size_t set_size) noexcept;
+
+    // Returns the length of the longest prefix of the size bytes at data
+    // that is valid UTF-8. The validation is vectorized, with SSE2 or
+    // AVX2 instructions selected at runtime.
+    XEUS_API std::size_t utf8_valid_prefix(const char* data, std::size_t size) noexcept;
+
+    inline bool is_utf8_valid(const char* data, std::size_t size) noexcept
+    {
+        return utf8_valid_prefix(data, size) == size;
+    }
+
+    // Replaces each maximal invalid subpart of str with U+FFFD, as the
+    // Unicode standard recommends. Returns false, leaving str unchanged,
+    // if it is valid UTF-8. Text that goes to a JSON message must be valid,
+    // since its serialization throws otherwise.
+    XEUS_API bool repair_utf8(std::string& str);
+
+    // Returns the hexadecimal representation of a contiguous sequence of
+    // bytes, as a std::string or any string type with resize and data
+    // methods, such as xfixed_string.
+    template <class S = std::string, class B>
+    inline S hex_string(const B& buffer)
     {
-        std::ostringstream oss;
-        oss << std::hex;
-        for (std::size_t i = 0; i < buffer.size(); ++i)
-        {
-            oss << std::setw(2) << std::setfill('0') << static_cast<int>(buffer[i]);
-        }
-        return oss.str();
+        static_assert(sizeof(*buffer.data()) == 1, "hex_string requires a buffer of bytes");
+        S res;
+        res.resize(2 * buffer.size());
+        hex_encode(buffer.data(), buffer.size(), res.data());
+        return res;
     }
 }
 
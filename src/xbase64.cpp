@@ -0,0 +1,356 @@
+/***************************************************************************
+* Copyright (c) Sylvain Corlay and Johan Mabille and Wolf Vollprecht       *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "xeus/xbase64.hpp"
+
+#include "xcpu_features.hpp"
+
+namespace xeus
+{
+    namespace
+    {
+        using byte = unsigned char;
+
+        constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        // Value of each character of the alphabet, -1 for other characters
+        constexpr std::array<std::int8_t, 256> make_decode_table() noexcept
+        {
+            std::array<std::int8_t, 256> res = {};
+            for (std::size_t i = 0; i < 256; ++i)
+            {
+                res[i] = -1;
+            }
+            for (std::size_t i = 0; i < 64; ++i)
+            {
+                res[static_cast<byte>(alphabet[i])] = static_cast<std::int8_t>(i);
+            }
+            return res;
+        }
+
+        constexpr std::array<std::int8_t, 256> decode_table = make_decode_table();
+
+        /*************************
+         * Scalar implementation *
+         *************************/
+
+        void encode_scalar(const byte* src, std::size_t size, char* out) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 3 <= size; i += 3, out += 4)
+            {
+                std::uint32_t v = (std::uint32_t(src[i]) << 16) | (std::uint32_t(src[i + 1]) << 8) | src[i + 2];
+                out[0] = alphabet[v >> 18];
+                out[1] = alphabet[(v >> 12) & 0x3F];
+                out[2] = alphabet[(v >> 6) & 0x3F];
+                out[3] = alphabet[v & 0x3F];
+            }
+            std::size_t rest = size - i;
+            if (rest != 0)
+            {
+                std::uint32_t v = (std::uint32_t(src[i]) << 16) | (rest == 2 ? std::uint32_t(src[i + 1]) << 8 : 0u);
+                out[0] = alphabet[v >> 18];
+                out[1] = alphabet[(v >> 12) & 0x3F];
+                out[2] = rest == 2 ? alphabet[(v >> 6) & 0x3F] : '=';
+                out[3] = '=';
+            }
+        }
+
+        std::size_t decode_scalar(const byte* src, std::size_t size, byte* out) noexcept
+        {
+            std::size_t i = 0;
+            byte* dst = out;
+            for (; i + 4 <= size; i += 4, dst += 3)
+            {
+                int a = decode_table[src[i]];
+                int b = decode_table[src[i + 1]];
+                int c = decode_table[src[i + 2]];
+                int d = decode_table[src[i + 3]];
+                if ((a | b | c | d) < 0)
+                {
+                    break;
+                }
+                std::uint32_t v = std::uint32_t(a << 18 | b << 12 | c << 6 | d);
+                dst[0] = static_cast<byte>(v >> 16);
+                dst[1] = static_cast<byte>(v >> 8);
+                dst[2] = static_cast<byte>(v);
+            }
+
+            // Last group, ended by the end of the input or by an invalid
+            // character: 2 and 3 characters hold 1 and 2 bytes
+            std::uint32_t v = 0;
+            std::size_t count = 0;
+            for (; i < size && decode_table[src[i]] >= 0; ++i, ++count)
+            {
+                v = (v << 6) | std::uint32_t(decode_table[src[i]]);
+            }
+            if (count == 2)
+            {
+                *dst++ = static_cast<byte>(v >> 4);
+            }
+            else if (count == 3)
+            {
+                *dst++ = static_cast<byte>(v >> 10);
+                *dst++ = static_cast<byte>(v >> 2);
+            }
+            return static_cast<std::size_t>(dst - out);
+        }
+
+#ifdef XEUS_RUNTIME_DISPATCH
+
+        /************************
+         * SSSE3 implementation *
+         ************************/
+
+        // Blocks of 12 bytes are spread to 16 bytes holding 6 bits each,
+        // which are then translated to characters by adding an offset
+        // that depends on their range.
+        XEUS_TARGET("ssse3")
+        __m128i bytes_to_chars_ssse3(__m128i v) noexcept
+        {
+            v = _mm_shuffle_epi8(v, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+            __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+            __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+            __m128i values = _mm_or_si128(t0, t1);
+
+            // Index of the offset: 13 for [0, 26), 0 for [26, 52), then
+            // 1 to 12 for [52, 64)
+            __m128i index = _mm_subs_epu8(values, _mm_set1_epi8(51));
+            __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), values);
+            index = _mm_or_si128(index, _mm_and_si128(upper, _mm_set1_epi8(13)));
+            const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                  '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                  '/' - 63, 'A', 0, 0);
+            return _mm_add_epi8(values, _mm_shuffle_epi8(offsets, index));
+        }
+
+        // Translates characters to their 6-bit values, the offsets are
+        // looked up by high nibble ('/' being set apart). Characters are
+        // checked with two bitmask tables indexed by their nibbles.
+        // Returns false if v holds a character that is not in the alphabet.
+        XEUS_TARGET("ssse3")
+        bool chars_to_values_ssse3(__m128i& v) noexcept
+        {
+            const __m128i low_table = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m128i high_table = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                     0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m128i offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i slash = _mm_set1_epi8('/');
+            __m128i high = _mm_and_si128(_mm_srli_epi32(v, 4), slash);
+            __m128i low = _mm_and_si128(v, slash);
+            __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(low_table, low), _mm_shuffle_epi8(high_table, high));
+            if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0)
+            {
+                return false;
+            }
+            __m128i index = _mm_add_epi8(_mm_cmpeq_epi8(v, slash), high);
+            v = _mm_add_epi8(v, _mm_shuffle_epi8(offsets, index));
+            return true;
+        }
+
+        // Packs the 6-bit values of each group of 4 bytes to 3 bytes; the
+        // first 12 bytes of the result are the decoded ones.
+        XEUS_TARGET("ssse3")
+        __m128i values_to_bytes_ssse3(__m128i v) noexcept
+        {
+            __m128i pairs = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+            __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+            return _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        }
+
+        XEUS_TARGET("ssse3")
+        void encode_ssse3(const byte* src, std::size_t size, char* out) noexcept
+        {
+            // 16 bytes are loaded for 12 encoded ones
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 12, out += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes_to_chars_ssse3(v));
+            }
+            encode_scalar(src + i, size - i, out);
+        }
+
+        XEUS_TARGET("ssse3")
+        std::size_t decode_ssse3(const byte* src, std::size_t size, byte* out) noexcept
+        {
+            // 16 bytes are stored for 12 decoded ones; the loop stops early
+            // enough for out to have room for the 4 extra bytes. A block
+            // with an invalid character is left to the scalar decoding.
+            std::size_t i = 0;
+            std::size_t count = 0;
+            for (; i + 24 <= size; i += 16, count += 12)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                if (!chars_to_values_ssse3(v))
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), values_to_bytes_ssse3(v));
+            }
+            return count + decode_scalar(src + i, size - i, out + count);
+        }
+
+        /***********************
+         * AVX2 implementation *
+         ***********************/
+
+        // Same as the SSSE3 implementation, in each 128-bit lane
+
+        XEUS_TARGET("avx2")
+        __m256i bytes_to_chars_avx2(__m256i v) noexcept
+        {
+            const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                     1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+            v = _mm256_shuffle_epi8(v, shuffle);
+            __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+            __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+            __m256i values = _mm256_or_si256(t0, t1);
+
+            __m256i index = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+            __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), values);
+            index = _mm256_or_si256(index, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+            const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                     '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                     '/' - 63, 'A', 0, 0,
+                                                     'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                     '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                     '/' - 63, 'A', 0, 0);
+            return _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, index));
+        }
+
+        XEUS_TARGET("avx2")
+        bool chars_to_values_avx2(__m256i& v) noexcept
+        {
+            const __m256i low_table = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                       0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                                       0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                       0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m256i high_table = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                                        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m256i offsets = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                     0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m256i slash = _mm256_set1_epi8('/');
+            __m256i high = _mm256_and_si256(_mm256_srli_epi32(v, 4), slash);
+            __m256i low = _mm256_and_si256(v, slash);
+            __m256i invalid = _mm256_and_si256(_mm256_shuffle_epi8(low_table, low), _mm256_shuffle_epi8(high_table, high));
+            if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(invalid, _mm256_setzero_si256())) != 0)
+            {
+                return false;
+            }
+            __m256i index = _mm256_add_epi8(_mm256_cmpeq_epi8(v, slash), high);
+            v = _mm256_add_epi8(v, _mm256_shuffle_epi8(offsets, index));
+            return true;
+        }
+
+        // The first 24 bytes of the result are the decoded ones
+        XEUS_TARGET("avx2")
+        __m256i values_to_bytes_avx2(__m256i v) noexcept
+        {
+            const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                     2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            __m256i pairs = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+            __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+            __m256i res = _mm256_shuffle_epi8(groups, shuffle);
+            // Joins the 12 bytes of each lane
+            return _mm256_permutevar8x32_epi32(res, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        }
+
+        XEUS_TARGET("avx2")
+        void encode_avx2(const byte* src, std::size_t size, char* out) noexcept
+        {
+            // Each lane is loaded with 12 bytes to encode
+            std::size_t i = 0;
+            for (; i + 28 <= size; i += 24, out += 32)
+            {
+                __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+                __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bytes_to_chars_avx2(v));
+            }
+            // The SSSE3 code is not VEX encoded, and would be slowed down
+            // by the dirty upper halves of the registers
+            _mm256_zeroupper();
+            encode_ssse3(src + i, size - i, out);
+        }
+
+        XEUS_TARGET("avx2")
+        std::size_t decode_avx2(const byte* src, std::size_t size, byte* out) noexcept
+        {
+            std::size_t i = 0;
+            std::size_t count = 0;
+            for (; i + 48 <= size; i += 32, count += 24)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                if (!chars_to_values_avx2(v))
+                {
+                    break;
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), values_to_bytes_avx2(v));
+            }
+            _mm256_zeroupper();
+            return count + decode_ssse3(src + i, size - i, out + count);
+        }
+
+#endif
+
+        using encode_function = void (*)(const byte*, std::size_t, char*) noexcept;
+        using decode_function = std::size_t (*)(const byte*, std::size_t, byte*) noexcept;
+
+        encode_function select_encode() noexcept
+        {
+#ifdef XEUS_RUNTIME_DISPATCH
+            if (cpu_has_avx2())
+            {
+                return encode_avx2;
+            }
+            if (cpu_has_ssse3())
+            {
+                return encode_ssse3;
+            }
+#endif
+            return encode_scalar;
+        }
+
+        decode_function select_decode() noexcept
+        {
+#ifdef XEUS_RUNTIME_DISPATCH
+            if (cpu_has_avx2())
+            {
+                return decode_avx2;
+            }
+            if (cpu_has_ssse3())
+            {
+                return decode_ssse3;
+            }
+#endif
+            return decode_scalar;
+        }
+    }
+
+    void base64_encode(const void* data, std::size_t size, char* out) noexcept
+    {
+        static const encode_function encode = select_encode();
+        encode(static_cast<const byte*>(data), size, out);
+    }
+
+    std::size_t base64_decode(std::string_view input, void* out) noexcept
+    {
+        static const decode_function decode = select_decode();
+        return decode(reinterpret_cast<const byte*>(input.data()), input.size(), static_cast<byte*>(out));
+    }
+}
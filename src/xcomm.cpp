@@ -63,6 +63,21 @@ namespace xeus
         }
     }
 
+    void xtarget::publish_message(const std::string& msg_type,
+                                  nl::json metadata,
+                                  nl::json content,
+                                  chunked_buffer_sequence buffers) const
+    {
+        if (p_manager->p_kernel != nullptr)
+        {
+            p_manager->p_kernel->publish_message(
+                msg_type, p_manager->p_kernel->parent_header(),
+                std::move(metadata), std::move(content),
+                std::move(buffers), channel::SHELL
+            );
+        }
+    }
+
     /************************
      * xcomm implementation *
      ************************/
@@ -93,6 +108,7 @@ namespace xeus
                                          nl::json data,
                                          buffer_sequence buffers) const
     {
+        compress_buffers(metadata, buffers, m_buffer_codec);
         nl::json content;
         content["comm_id"] = m_id;
         content["data"] = std::move(data);
@@ -105,6 +121,7 @@ namespace xeus
                                          buffer_sequence buffers,
                                          const std::string& target_name) const
     {
+        compress_buffers(metadata, buffers, m_buffer_codec);
         nl::json content;
         content["comm_id"] = m_id;
         content["target_name"] = target_name;
@@ -112,11 +129,23 @@ namespace xeus
         target().publish_message(msg_type, std::move(metadata), std::move(content), std::move(buffers));
     }
 
+    void xcomm::send_comm_message(const std::string& msg_type,
+                                  nl::json metadata,
+                                  nl::json data,
+                                  chunked_buffer_sequence buffers) const
+    {
+        nl::json content;
+        content["comm_id"] = m_id;
+        content["data"] = std::move(data);
+        target().publish_message(msg_type, std::move(metadata), std::move(content), std::move(buffers));
+    }
+
     xcomm::xcomm(xcomm&& comm)
         : m_close_handler(std::move(comm.m_close_handler))
         , m_message_handler(std::move(comm.m_message_handler))
         , p_target(std::move(comm.p_target))
         , m_id(std::move(comm.m_id))
+        , m_buffer_codec(comm.m_buffer_codec)
         , m_moved_from(false)
     {
         comm.m_moved_from = true;
@@ -127,6 +156,7 @@ namespace xeus
     xcomm::xcomm(const xcomm& comm)
         : p_target(comm.p_target)
         , m_id(xeus::new_xguid())
+        , m_buffer_codec(comm.m_buffer_codec)
         , m_moved_from(false)
     {
         p_target->register_comm(m_id, this);
@@ -139,6 +169,7 @@ namespace xeus
         p_target = std::move(comm.p_target);
         p_target->unregister_comm(m_id);
         m_id = std::move(comm.m_id);
+        m_buffer_codec = comm.m_buffer_codec;
         m_moved_from = false;
         comm.m_moved_from = true;
         p_target->register_comm(m_id,
@@ -151,6 +182,7 @@ namespace xeus
         p_target = comm.p_target;
         p_target->unregister_comm(m_id);
         m_id = new_xguid();
+        m_buffer_codec = comm.m_buffer_codec;
         m_moved_from = false;
         p_target->register_comm(m_id, this);
         return *this;
@@ -159,6 +191,8 @@ namespace xeus
     xcomm::xcomm(const xtarget* target, xguid id)
         : p_target(target)
         , m_id(id)
+        , m_buffer_codec(buffer_codec::none)
+        , m_moved_from(false)
     {
         if (!p_target)
             throw std::runtime_error("Cannot initialize comm with null target");
@@ -192,11 +226,26 @@ namespace xeus
         send_comm_message("comm_msg", std::move(metadata), std::move(data), std::move(buffers));
     }
 
+    void xcomm::send_chunked(nl::json metadata, nl::json data, chunked_buffer_sequence buffers) const
+    {
+        send_comm_message("comm_msg", std::move(metadata), std::move(data), std::move(buffers));
+    }
+
     xguid xcomm::id() const noexcept
     {
         return m_id;
     }
 
+    void xcomm::set_buffer_codec(buffer_codec codec) noexcept
+    {
+        m_buffer_codec = codec;
+    }
+
+    buffer_codec xcomm::get_buffer_codec() const noexcept
+    {
+        return m_buffer_codec;
+    }
+
     /********************************
      * xcomm_manager implementation *
      ********************************/
@@ -206,6 +255,23 @@ namespace xeus
         p_kernel = kernel;
     }
 
+    xcomm_manager::xcomm_manager(const xcomm_manager& rhs)
+        : m_comms(rhs.m_comms)
+        , p_kernel(rhs.p_kernel)
+    {
+        for (const auto& [name, target] : rhs.m_targets)
+        {
+            m_targets.insert_or_assign(name, std::make_unique<xtarget>(*target));
+        }
+    }
+
+    xcomm_manager& xcomm_manager::operator=(const xcomm_manager& rhs)
+    {
+        xcomm_manager tmp(rhs);
+        *this = std::move(tmp);
+        return *this;
+    }
+
     nl::json xcomm_manager::get_metadata() const
     {
         // TODO: handle duplication
@@ -217,7 +283,16 @@ namespace xeus
     void xcomm_manager::register_comm_target(const std::string& target_name,
                                              const target_function_type& callback)
     {
-        m_targets.insert_or_assign(target_name, xtarget(target_name, callback, this));
+        auto position = m_targets.find(target_name);
+        if (position == m_targets.end())
+        {
+            m_targets.insert_or_assign(target_name, std::make_unique<xtarget>(target_name, callback, this));
+        }
+        else
+        {
+            // Keeps the target at the same address for existing comms
+            *(position->second) = xtarget(target_name, callback, this);
+        }
     }
 
     void xcomm_manager::unregister_comm_target(const std::string& target_name)
@@ -227,7 +302,7 @@ namespace xeus
 
     void xcomm_manager::register_comm(xguid id, xcomm* comm)
     {
-        m_comms[id] = comm;
+        m_comms.insert_or_assign(id, comm);
     }
 
     void xcomm_manager::unregister_comm(xguid id)
@@ -238,8 +313,7 @@ namespace xeus
     void xcomm_manager::comm_open(xmessage request)
     {
         const nl::json& content = request.content();
-        std::string target_name = content["target_name"];
-        auto position = m_targets.find(target_name);
+        auto position = m_targets.find(content["target_name"]);
 
         if (position == m_targets.end())
         {
@@ -253,51 +327,49 @@ namespace xeus
         }
         else
         {
-            xtarget& target = position->second;
+            xtarget& target = *(position->second);
             xguid id = content["comm_id"];
             xcomm comm = xcomm(&target, id);
-            target(std::move(comm), std::move(request));
+            target(std::move(comm), decompress_buffers(std::move(request)));
         }
     }
 
     void xcomm_manager::comm_close(xmessage request)
     {
         const nl::json& content = request.content();
-        xguid id = content["comm_id"];
-        auto position = m_comms.find(id);
+        auto position = m_comms.find(content["comm_id"]);
         if (position == m_comms.end())
         {
-            throw std::runtime_error("No such comm registered: " + std::string(id));
-        }
-        else
-        {
-            position->second->handle_close(std::move(request));
+            throw std::runtime_error("No such comm registered: " + content["comm_id"].get<std::string>());
         }
+        // The request is moved to the handler, which may also unregister
+        // the comm
+        xguid id = position->first;
+        position->second->handle_close(decompress_buffers(std::move(request)));
         m_comms.erase(id);
     }
 
     void xcomm_manager::comm_msg(xmessage request)
     {
         const nl::json& content = request.content();
-        xguid id = content["comm_id"];
-        auto position = m_comms.find(id);
+        auto position = m_comms.find(content["comm_id"]);
         if (position == m_comms.end())
         {
-            throw std::runtime_error("No such comm registered: " + std::string(id));
+            throw std::runtime_error("No such comm registered: " + content["comm_id"].get<std::string>());
         }
         else
         {
-            position->second->handle_message(std::move(request));
+            position->second->handle_message(decompress_buffers(std::move(request)));
         }
     }
 
     const xtarget* xcomm_manager::target(const std::string& target_name) const
     {
         auto iter = m_targets.find(target_name);
-        return iter == m_targets.end() ? nullptr : &(iter->second);
+        return iter == m_targets.end() ? nullptr : iter->second.get();
     }
 
-    const std::map<xguid, xcomm*>& xcomm_manager::comms() const noexcept
+    auto xcomm_manager::comms() const noexcept -> const comm_map&
     {
         return m_comms;
     }
@@ -0,0 +1,402 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xeus/xjson.hpp"
+
+#include "xeus/xcompression.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    namespace
+    {
+        // Parameters of the LZ4 block format
+        constexpr std::size_t min_match = 4;
+        // The last 5 bytes are always literals
+        constexpr std::size_t last_literals = 5;
+        // The last match starts at least 12 bytes before the end
+        constexpr std::size_t match_find_limit = 12;
+        constexpr std::size_t max_offset = 65535;
+
+        // Short copies are done with fixed-size memcpy, which may write up
+        // to copy_slack bytes past the end of the output
+        constexpr std::size_t wild_copy = 16;
+        constexpr std::size_t copy_slack = 2 * wild_copy;
+
+        // Each byte of a block decodes to at most 255 bytes, which bounds
+        // the decompressed size announced by untrusted metadata.
+        constexpr std::size_t max_expansion = 255;
+
+        constexpr unsigned int hash_log = 12;
+        // The search step grows when no match is found, so that
+        // incompressible data is skipped quickly
+        constexpr unsigned int skip_trigger = 6;
+
+        using byte = unsigned char;
+
+        std::uint32_t read32(const byte* p) noexcept
+        {
+            std::uint32_t res;
+            std::memcpy(&res, p, sizeof(res));
+            return res;
+        }
+
+        std::uint32_t hash32(std::uint32_t sequence) noexcept
+        {
+            return (sequence * 2654435761u) >> (32 - hash_log);
+        }
+
+        void write_length(byte*& op, std::size_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                *op++ = 255;
+            }
+            *op++ = static_cast<byte>(length);
+        }
+
+        void write_literals(byte*& op, const byte* literals, std::size_t length, std::size_t match_length)
+        {
+            byte* token = op++;
+            byte high = length >= 15 ? 15 : static_cast<byte>(length);
+            byte low = match_length >= 15 ? 15 : static_cast<byte>(match_length);
+            *token = static_cast<byte>((high << 4) | low);
+            if (length >= 15)
+            {
+                write_length(op, length - 15);
+            }
+            if (length != 0)
+            {
+                std::memcpy(op, literals, length);
+                op += length;
+            }
+        }
+
+        [[noreturn]] void throw_malformed()
+        {
+            throw std::runtime_error("lz4_decompress: malformed compressed buffer");
+        }
+
+        std::size_t read_length(const byte*& ip, const byte* iend)
+        {
+            std::size_t res = 0;
+            byte b = 255;
+            while (b == 255)
+            {
+                if (ip == iend)
+                {
+                    throw_malformed();
+                }
+                b = *ip++;
+                res += b;
+            }
+            return res;
+        }
+
+        const char* codec_name(buffer_codec codec) noexcept
+        {
+            return codec == buffer_codec::lz4 ? "lz4" : "none";
+        }
+    }
+
+    /****************************
+     * lz4 codec implementation *
+     ****************************/
+
+    std::size_t lz4_compress_bound(std::size_t size) noexcept
+    {
+        return size + size / 255 + 16;
+    }
+
+    // Greedy single-pass compressor, in the spirit of LZ4_compress_fast
+    binary_buffer lz4_compress(const char* data, std::size_t size)
+    {
+        std::vector<char> res(lz4_compress_bound(size));
+        const byte* src = reinterpret_cast<const byte*>(data);
+        const byte* ip = src;
+        const byte* anchor = src;
+        const byte* iend = src + size;
+        byte* op = reinterpret_cast<byte*>(res.data());
+
+        if (size > match_find_limit)
+        {
+            const byte* find_limit = iend - match_find_limit;
+            const byte* match_limit = iend - last_literals;
+            std::array<std::uint32_t, std::size_t(1) << hash_log> table = {};
+
+            ++ip;
+            while (ip <= find_limit)
+            {
+                // Find a match
+                const byte* ref = nullptr;
+                unsigned int search = 1u << skip_trigger;
+                bool found = false;
+                while (!found && ip <= find_limit)
+                {
+                    std::uint32_t sequence = read32(ip);
+                    std::uint32_t h = hash32(sequence);
+                    ref = src + table[h];
+                    table[h] = static_cast<std::uint32_t>(ip - src);
+                    found = ref < ip && static_cast<std::size_t>(ip - ref) <= max_offset && read32(ref) == sequence;
+                    if (!found)
+                    {
+                        std::size_t step = search++ >> skip_trigger;
+                        ip = step > static_cast<std::size_t>(find_limit - ip) ? find_limit + 1 : ip + step;
+                    }
+                }
+                if (!found)
+                {
+                    break;
+                }
+
+                // Extend the match backward, then forward
+                while (ip > anchor && ref > src && ip[-1] == ref[-1])
+                {
+                    --ip;
+                    --ref;
+                }
+                const byte* match_start = ip;
+                ip += min_match;
+                ref += min_match;
+                while (ip < match_limit && *ip == *ref)
+                {
+                    ++ip;
+                    ++ref;
+                }
+
+                std::size_t match_length = static_cast<std::size_t>(ip - match_start) - min_match;
+                write_literals(op, anchor, static_cast<std::size_t>(match_start - anchor), match_length);
+                std::size_t offset = static_cast<std::size_t>(ip - ref);
+                *op++ = static_cast<byte>(offset & 0xff);
+                *op++ = static_cast<byte>(offset >> 8);
+                if (match_length >= 15)
+                {
+                    write_length(op, match_length - 15);
+                }
+                anchor = ip;
+
+                if (ip <= find_limit)
+                {
+                    table[hash32(read32(ip - 2))] = static_cast<std::uint32_t>(ip - 2 - src);
+                }
+            }
+        }
+
+        write_literals(op, anchor, static_cast<std::size_t>(iend - anchor), 0);
+        res.resize(static_cast<std::size_t>(op - reinterpret_cast<byte*>(res.data())));
+        return binary_buffer(std::move(res));
+    }
+
+    binary_buffer lz4_decompress(const char* data, std::size_t size, std::size_t decompressed_size)
+    {
+        if (decompressed_size / max_expansion > size
+            || decompressed_size > std::numeric_limits<std::size_t>::max() - copy_slack)
+        {
+            throw_malformed();
+        }
+        std::vector<char> res(decompressed_size + copy_slack);
+        const byte* ip = reinterpret_cast<const byte*>(data);
+        const byte* iend = ip + size;
+        byte* dst = reinterpret_cast<byte*>(res.data());
+        byte* op = dst;
+        byte* oend = dst + decompressed_size;
+
+        while (ip < iend)
+        {
+            byte token = *ip++;
+            std::size_t length = token >> 4;
+            if (length == 15)
+            {
+                length += read_length(ip, iend);
+            }
+            if (length > static_cast<std::size_t>(iend - ip) || length > static_cast<std::size_t>(oend - op))
+            {
+                throw_malformed();
+            }
+            if (length <= wild_copy && static_cast<std::size_t>(iend - ip) >= wild_copy)
+            {
+                std::memcpy(op, ip, wild_copy);
+            }
+            else if (length != 0)
+            {
+                std::memcpy(op, ip, length);
+            }
+            ip += length;
+            op += length;
+            if (ip == iend)
+            {
+                // The last sequence has no match
+                break;
+            }
+
+            if (iend - ip < 2)
+            {
+                throw_malformed();
+            }
+            std::size_t offset = std::size_t(ip[0]) | (std::size_t(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<std::size_t>(op - dst))
+            {
+                throw_malformed();
+            }
+            std::size_t match_length = token & 15;
+            if (match_length == 15)
+            {
+                match_length += read_length(ip, iend);
+            }
+            match_length += min_match;
+            if (match_length > static_cast<std::size_t>(oend - op))
+            {
+                throw_malformed();
+            }
+            const byte* ref = op - offset;
+            if (offset >= wild_copy)
+            {
+                // The chunks do not overlap, and only read bytes that
+                // have already been written
+                for (std::size_t i = 0; i < match_length; i += wild_copy)
+                {
+                    std::memcpy(op + i, ref + i, wild_copy);
+                }
+            }
+            else if (offset >= 8)
+            {
+                for (std::size_t i = 0; i < match_length; i += 8)
+                {
+                    std::memcpy(op + i, ref + i, 8);
+                }
+            }
+            else
+            {
+                // Overlapping copy, repeats the last offset bytes
+                for (std::size_t i = 0; i < match_length; ++i)
+                {
+                    op[i] = ref[i];
+                }
+            }
+            op += match_length;
+        }
+
+        if (op != oend)
+        {
+            throw_malformed();
+        }
+        res.resize(decompressed_size);
+        return binary_buffer(std::move(res));
+    }
+
+    /*************************************
+     * buffer compression implementation *
+     *************************************/
+
+    void compress_buffers(nl::json& metadata,
+                          buffer_sequence& buffers,
+                          buffer_codec codec,
+                          std::size_t min_size)
+    {
+        if (codec == buffer_codec::none || buffers.empty())
+        {
+            return;
+        }
+
+        nl::json sizes = nl::json::array();
+        bool compressed = false;
+        for (binary_buffer& buffer : buffers)
+        {
+            if (buffer.size() >= min_size)
+            {
+                binary_buffer res = lz4_compress(buffer.data(), buffer.size());
+                if (res.size() < buffer.size())
+                {
+                    sizes.push_back(buffer.size());
+                    buffer = std::move(res);
+                    compressed = true;
+                    continue;
+                }
+            }
+            sizes.push_back(nullptr);
+        }
+
+        if (compressed)
+        {
+            metadata[buffer_compression_key] = {
+                {"codec", codec_name(codec)},
+                {"sizes", std::move(sizes)}
+            };
+        }
+    }
+
+    void decompress_buffers(const nl::json& metadata, buffer_sequence& buffers)
+    {
+        if (!metadata.is_object())
+        {
+            return;
+        }
+        auto it = metadata.find(buffer_compression_key);
+        if (it == metadata.end())
+        {
+            return;
+        }
+
+        const nl::json& description = *it;
+        std::string codec = description.value("codec", std::string());
+        if (codec != codec_name(buffer_codec::lz4))
+        {
+            throw std::runtime_error("Unsupported buffer compression codec: " + codec);
+        }
+        const nl::json& sizes = description.at("sizes");
+        if (!sizes.is_array() || sizes.size() > buffers.size())
+        {
+            throw std::runtime_error("Invalid buffer compression sizes");
+        }
+        for (std::size_t i = 0; i < sizes.size(); ++i)
+        {
+            if (!sizes[i].is_null())
+            {
+                if (!sizes[i].is_number_unsigned())
+                {
+                    throw std::runtime_error("Invalid buffer compression sizes");
+                }
+                binary_buffer& buffer = buffers[i];
+                buffer = lz4_decompress(buffer.data(), buffer.size(), sizes[i].get<std::size_t>());
+            }
+        }
+    }
+
+    xmessage decompress_buffers(xmessage message)
+    {
+        const nl::json& metadata = message.metadata();
+        if (!metadata.is_object() || !metadata.contains(buffer_compression_key))
+        {
+            return message;
+        }
+
+        buffer_sequence buffers = message.buffers();
+        decompress_buffers(metadata, buffers);
+        nl::json new_metadata = metadata;
+        new_metadata.erase(buffer_compression_key);
+        return xmessage(message.identities(),
+                        message.header_section(),
+                        message.parent_header_section(),
+                        std::move(new_metadata),
+                        message.content_section(),
+                        std::move(buffers));
+    }
+}
@@ -0,0 +1,52 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEUS_CPU_FEATURES_HPP
+#define XEUS_CPU_FEATURES_HPP
+
+// SSE2 is part of the x86-64 baseline, so it is always available there.
+// Wider instruction sets are compiled in functions marked with
+// XEUS_TARGET(isa) and only called when the CPU supports them, which
+// requires the target attribute of GCC and Clang.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define XEUS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(XEUS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define XEUS_RUNTIME_DISPATCH
+#define XEUS_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#endif
+
+namespace xeus
+{
+    inline bool cpu_has_ssse3() noexcept
+    {
+#ifdef XEUS_RUNTIME_DISPATCH
+        static const bool res = __builtin_cpu_supports("ssse3");
+        return res;
+#else
+        return false;
+#endif
+    }
+
+    inline bool cpu_has_avx2() noexcept
+    {
+#ifdef XEUS_RUNTIME_DISPATCH
+        static const bool res = __builtin_cpu_supports("avx2");
+        return res;
+#else
+        return false;
+#endif
+    }
+}
+
+#endif
@@ -7,11 +7,11 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
-#include <string>
-#include <sstream>
-#include <iomanip>
+#include <cstdint>
 
 #include "xeus/xguid.hpp"
 #include "xeus/xstring_utils.hpp"
@@ -28,71 +28,170 @@
 #include <objbase.h>
 #endif
 
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#include <pthread.h>
+#define XEUS_GUID_ATFORK
+#endif
+
 namespace xeus
 {
-    xguid new_xguid()
+    namespace
     {
-        static constexpr std::size_t GUID_SIZE = 16;
-        std::array<unsigned char, GUID_SIZE> buffer;
+        constexpr std::size_t GUID_SIZE = 16;
+        using guid_bytes = std::array<unsigned char, GUID_SIZE>;
+
+        std::atomic<xguid_generator> s_generator = xguid_generator::system;
+
+        void fill_system_guid(guid_bytes& buffer)
+        {
 #ifdef GUID_LIBUUID
-        uuid_t id;
-        uuid_generate(id);
-        std::copy(id, id + GUID_SIZE, buffer.begin());
+            uuid_t id;
+            uuid_generate(id);
+            std::copy(id, id + GUID_SIZE, buffer.begin());
 #endif
 
 #ifdef GUID_CFUUID
-        auto id = CFUUIDCreate(NULL);
-        auto bytes = CFUUIDGetUUIDBytes(id);
-        CFRelease(id);
+            auto id = CFUUIDCreate(NULL);
+            auto bytes = CFUUIDGetUUIDBytes(id);
+            CFRelease(id);
 
-        buffer =
-        {
-            bytes.byte0,
-            bytes.byte1,
-            bytes.byte2,
-            bytes.byte3,
-            bytes.byte4,
-            bytes.byte5,
-            bytes.byte6,
-            bytes.byte7,
-            bytes.byte8,
-            bytes.byte9,
-            bytes.byte10,
-            bytes.byte11,
-            bytes.byte12,
-            bytes.byte13,
-            bytes.byte14,
-            bytes.byte15
-        };
+            buffer =
+            {
+                bytes.byte0,
+                bytes.byte1,
+                bytes.byte2,
+                bytes.byte3,
+                bytes.byte4,
+                bytes.byte5,
+                bytes.byte6,
+                bytes.byte7,
+                bytes.byte8,
+                bytes.byte9,
+                bytes.byte10,
+                bytes.byte11,
+                bytes.byte12,
+                bytes.byte13,
+                bytes.byte14,
+                bytes.byte15
+            };
 #endif
 
 #ifdef GUID_WINDOWS
-        GUID id;
-        CoCreateGuid(&id);
+            GUID id;
+            CoCreateGuid(&id);
+
+            using uchar = unsigned char;
 
-        using uchar = unsigned char;
+            buffer =
+            {
+                uchar(id.Data1 >> 24 & 0xFF),
+                uchar(id.Data1 >> 16 & 0xFF),
+                uchar(id.Data1 >> 8 & 0xFF),
+                uchar(id.Data1 & 0xFF),
+                uchar(id.Data2 >> 8 & 0xFF),
+                uchar(id.Data2 & 0xFF),
+                uchar(id.Data3 >> 8 & 0xFF),
+                uchar(id.Data3 & 0xFF),
+                id.Data4[0],
+                id.Data4[1],
+                id.Data4[2],
+                id.Data4[3],
+                id.Data4[4],
+                id.Data4[5],
+                id.Data4[6],
+                id.Data4[7]
+            };
+#endif
+        }
 
-        buffer =
+        void store_big_endian(std::uint64_t value, unsigned char* out) noexcept
         {
-            uchar(id.Data1 >> 24 & 0xFF),
-            uchar(id.Data1 >> 16 & 0xFF),
-            uchar(id.Data1 >> 8 & 0xFF),
-            uchar(id.Data1 & 0xFF),
-            uchar(id.Data2 >> 8 & 0xFF),
-            uchar(id.Data2 & 0xFF),
-            uchar(id.Data3 >> 8 & 0xFF),
-            uchar(id.Data3 & 0xFF),
-            id.Data4[0],
-            id.Data4[1],
-            id.Data4[2],
-            id.Data4[3],
-            id.Data4[4],
-            id.Data4[5],
-            id.Data4[6],
-            id.Data4[7]
-        };
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                out[i] = static_cast<unsigned char>(value >> (56 - 8 * i));
+            }
+        }
+
+        std::uint64_t load_big_endian(const unsigned char* in) noexcept
+        {
+            std::uint64_t res = 0;
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                res = (res << 8) | in[i];
+            }
+            return res;
+        }
+
+        // A forked child inherits the state of the forking thread, and would
+        // generate the same ids as its parent; the epoch is incremented in
+        // the child so that its threads draw a new prefix.
+        std::atomic<unsigned int> s_fork_epoch = 0;
+
+        bool register_fork_handler()
+        {
+#ifdef XEUS_GUID_ATFORK
+            pthread_atfork(nullptr, nullptr, []() { ++s_fork_epoch; });
 #endif
+            return true;
+        }
+
+        struct fast_guid_state
+        {
+            std::uint64_t m_prefix = 0;
+            std::uint64_t m_counter = 0;
+            unsigned int m_epoch = 0;
+            bool m_seeded = false;
+        };
+
+        xguid new_fast_xguid()
+        {
+            static const bool fork_handler_registered = register_fork_handler();
+            (void)fork_handler_registered;
+
+            thread_local fast_guid_state state;
+            unsigned int epoch = s_fork_epoch.load(std::memory_order_relaxed);
+            if (!state.m_seeded || state.m_epoch != epoch)
+            {
+                // The counter starts at a random value too, so that two
+                // threads sharing a prefix are unlikely to share ids
+                guid_bytes seed;
+                fill_system_guid(seed);
+                state.m_prefix = load_big_endian(seed.data());
+                state.m_counter = load_big_endian(seed.data() + 8);
+                state.m_epoch = epoch;
+                state.m_seeded = true;
+            }
+
+            guid_bytes buffer;
+            store_big_endian(state.m_prefix, buffer.data());
+            store_big_endian(state.m_counter++, buffer.data() + 8);
+            return hex_string<xguid>(buffer);
+        }
+    }
+
+    void set_xguid_generator(xguid_generator generator) noexcept
+    {
+        s_generator.store(generator, std::memory_order_relaxed);
+    }
 
-        return xguid(hex_string(buffer));
+    xguid_generator get_xguid_generator() noexcept
+    {
+        return s_generator.load(std::memory_order_relaxed);
+    }
+
+    xguid new_xguid()
+    {
+        return new_xguid(get_xguid_generator());
+    }
+
+    xguid new_xguid(xguid_generator generator)
+    {
+        if (generator == xguid_generator::fast)
+        {
+            return new_fast_xguid();
+        }
+        guid_bytes buffer;
+        fill_system_guid(buffer);
+        return hex_string<xguid>(buffer);
     }
 }
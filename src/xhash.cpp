@@ -0,0 +1,295 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "xeus/xhash.hpp"
+
+#include "xcpu_features.hpp"
+
+namespace xeus
+{
+    namespace detail
+    {
+        namespace
+        {
+            using byte = unsigned char;
+
+            // Long inputs are processed in stripes of 64 bytes, mixed into
+            // 8 accumulators. Each stripe of a block uses a different
+            // window of the keys; the accumulators are scrambled after
+            // each block.
+            constexpr std::size_t lane_count = 8;
+            constexpr std::size_t stripe_size = 64;
+            constexpr std::size_t stripes_per_block = 16;
+            constexpr uint64_t prime32 = 0x9E3779B1u;
+
+            using accumulators = std::array<uint64_t, lane_count>;
+
+            struct long_hash_keys
+            {
+                uint64_t m_stripe[lane_count + stripes_per_block - 1];
+                uint64_t m_scramble[lane_count];
+                uint64_t m_init[lane_count];
+                uint64_t m_merge[2][lane_count];
+            };
+
+            constexpr long_hash_keys make_keys() noexcept
+            {
+                // splitmix64 sequence
+                long_hash_keys res = {};
+                uint64_t state = 0x9E3779B97F4A7C15ull;
+                auto next = [&state]()
+                {
+                    state += 0x9E3779B97F4A7C15ull;
+                    uint64_t z = state;
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                    return z ^ (z >> 31);
+                };
+                for (uint64_t& k : res.m_stripe)
+                {
+                    k = next();
+                }
+                for (std::size_t i = 0; i < lane_count; ++i)
+                {
+                    res.m_scramble[i] = next();
+                    res.m_init[i] = next();
+                    res.m_merge[0][i] = next();
+                    res.m_merge[1][i] = next();
+                }
+                return res;
+            }
+
+            constexpr long_hash_keys keys = make_keys();
+
+#ifndef XEUS_SSE2
+
+            /***********************
+             * Scalar accumulation *
+             ***********************/
+
+            void stripe_scalar(accumulators& acc, const byte* p, const uint64_t* key) noexcept
+            {
+                for (std::size_t i = 0; i < lane_count; ++i)
+                {
+                    uint64_t data = wyread8(p + 8 * i);
+                    uint64_t data_key = data ^ key[i];
+                    acc[i ^ 1] += data;
+                    acc[i] += (data_key & 0xFFFFFFFFu) * (data_key >> 32);
+                }
+            }
+
+            void accumulate_scalar(accumulators& acc, const byte* p, std::size_t stripes) noexcept
+            {
+                for (; stripes >= stripes_per_block; stripes -= stripes_per_block)
+                {
+                    for (std::size_t n = 0; n < stripes_per_block; ++n, p += stripe_size)
+                    {
+                        stripe_scalar(acc, p, keys.m_stripe + n);
+                    }
+                    for (std::size_t i = 0; i < lane_count; ++i)
+                    {
+                        acc[i] = (acc[i] ^ (acc[i] >> 47) ^ keys.m_scramble[i]) * prime32;
+                    }
+                }
+                for (std::size_t n = 0; n < stripes; ++n, p += stripe_size)
+                {
+                    stripe_scalar(acc, p, keys.m_stripe + n);
+                }
+            }
+
+#else
+
+            /*********************
+             * SSE2 accumulation *
+             *********************/
+
+            inline void stripe_sse2(__m128i* acc, const byte* p, const uint64_t* key) noexcept
+            {
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * j));
+                    __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 2 * j));
+                    __m128i data_key = _mm_xor_si128(data, k);
+                    __m128i product = _mm_mul_epu32(data_key, _mm_srli_epi64(data_key, 32));
+                    __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                    acc[j] = _mm_add_epi64(acc[j], _mm_add_epi64(product, swapped));
+                }
+            }
+
+            void accumulate_sse2(accumulators& acc, const byte* p, std::size_t stripes) noexcept
+            {
+                __m128i a[4];
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    a[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc.data() + 2 * j));
+                }
+                const __m128i prime = _mm_set1_epi32(static_cast<int>(prime32));
+                for (; stripes >= stripes_per_block; stripes -= stripes_per_block)
+                {
+                    for (std::size_t n = 0; n < stripes_per_block; ++n, p += stripe_size)
+                    {
+                        stripe_sse2(a, p, keys.m_stripe + n);
+                    }
+                    for (std::size_t j = 0; j < 4; ++j)
+                    {
+                        __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys.m_scramble + 2 * j));
+                        __m128i v = _mm_xor_si128(_mm_xor_si128(a[j], _mm_srli_epi64(a[j], 47)), k);
+                        __m128i low = _mm_mul_epu32(v, prime);
+                        __m128i high = _mm_mul_epu32(_mm_srli_epi64(v, 32), prime);
+                        a[j] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+                    }
+                }
+                for (std::size_t n = 0; n < stripes; ++n, p += stripe_size)
+                {
+                    stripe_sse2(a, p, keys.m_stripe + n);
+                }
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc.data() + 2 * j), a[j]);
+                }
+            }
+
+#endif
+
+#ifdef XEUS_RUNTIME_DISPATCH
+
+            /*********************
+             * AVX2 accumulation *
+             *********************/
+
+            XEUS_TARGET("avx2")
+            inline void stripe_avx2(__m256i* acc, const byte* p, const uint64_t* key) noexcept
+            {
+                for (std::size_t j = 0; j < 2; ++j)
+                {
+                    __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * j));
+                    __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + 4 * j));
+                    __m256i data_key = _mm256_xor_si256(data, k);
+                    __m256i product = _mm256_mul_epu32(data_key, _mm256_srli_epi64(data_key, 32));
+                    __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                    acc[j] = _mm256_add_epi64(acc[j], _mm256_add_epi64(product, swapped));
+                }
+            }
+
+            XEUS_TARGET("avx2")
+            void accumulate_avx2(accumulators& acc, const byte* p, std::size_t stripes) noexcept
+            {
+                __m256i a[2];
+                for (std::size_t j = 0; j < 2; ++j)
+                {
+                    a[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc.data() + 4 * j));
+                }
+                const __m256i prime = _mm256_set1_epi32(static_cast<int>(prime32));
+                for (; stripes >= stripes_per_block; stripes -= stripes_per_block)
+                {
+                    for (std::size_t n = 0; n < stripes_per_block; ++n, p += stripe_size)
+                    {
+                        stripe_avx2(a, p, keys.m_stripe + n);
+                    }
+                    for (std::size_t j = 0; j < 2; ++j)
+                    {
+                        __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys.m_scramble + 4 * j));
+                        __m256i v = _mm256_xor_si256(_mm256_xor_si256(a[j], _mm256_srli_epi64(a[j], 47)), k);
+                        __m256i low = _mm256_mul_epu32(v, prime);
+                        __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(v, 32), prime);
+                        a[j] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+                    }
+                }
+                for (std::size_t n = 0; n < stripes; ++n, p += stripe_size)
+                {
+                    stripe_avx2(a, p, keys.m_stripe + n);
+                }
+                for (std::size_t j = 0; j < 2; ++j)
+                {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc.data() + 4 * j), a[j]);
+                }
+            }
+
+#endif
+
+            using accumulate_function = void (*)(accumulators&, const byte*, std::size_t) noexcept;
+
+            accumulate_function select_accumulate() noexcept
+            {
+#ifdef XEUS_RUNTIME_DISPATCH
+                if (cpu_has_avx2())
+                {
+                    return accumulate_avx2;
+                }
+#endif
+#ifdef XEUS_SSE2
+                return accumulate_sse2;
+#else
+                return accumulate_scalar;
+#endif
+            }
+
+            accumulators accumulate(const byte* p, std::size_t stripes, uint64_t seed) noexcept
+            {
+                static const accumulate_function f = select_accumulate();
+                accumulators acc;
+                for (std::size_t i = 0; i < lane_count; ++i)
+                {
+                    acc[i] = keys.m_init[i] ^ seed;
+                }
+                f(acc, p, stripes);
+                return acc;
+            }
+
+            // Merges the accumulators, then mixes the last bytes as wyhash
+            // does. At least 16 bytes precede end.
+            uint64_t finalize(const accumulators& acc,
+                              const uint64_t* merge_keys,
+                              const byte* tail,
+                              const byte* end,
+                              std::size_t length) noexcept
+            {
+                const uint64_t* secret = wyhash_secret;
+                uint64_t seed = length * secret[0];
+                for (std::size_t i = 0; i < lane_count; i += 2)
+                {
+                    seed += wymix(acc[i] ^ merge_keys[i], acc[i + 1] ^ merge_keys[i + 1]);
+                }
+                std::size_t i = static_cast<std::size_t>(end - tail);
+                while (i > 16)
+                {
+                    seed = wymix(wyread8(tail) ^ secret[1], wyread8(tail + 8) ^ seed);
+                    i -= 16;
+                    tail += 16;
+                }
+                uint64_t a = wyread8(end - 16) ^ secret[1];
+                uint64_t b = wyread8(end - 8) ^ seed;
+                multiply128(a, b);
+                return wymix(a ^ secret[0] ^ length, b ^ secret[1]);
+            }
+        }
+
+        uint64_t hash64_long(const void* buffer, std::size_t length, uint64_t seed) noexcept
+        {
+            const byte* p = static_cast<const byte*>(buffer);
+            std::size_t stripes = length / stripe_size;
+            accumulators acc = accumulate(p, stripes, seed);
+            return finalize(acc, keys.m_merge[0], p + stripes * stripe_size, p + length, length);
+        }
+
+        xhash128 hash128_long(const void* buffer, std::size_t length, uint64_t seed) noexcept
+        {
+            const byte* p = static_cast<const byte*>(buffer);
+            std::size_t stripes = length / stripe_size;
+            accumulators acc = accumulate(p, stripes, seed);
+            const byte* tail = p + stripes * stripe_size;
+            return {finalize(acc, keys.m_merge[0], tail, p + length, length),
+                    finalize(acc, keys.m_merge[1], tail, p + length, length)};
+        }
+    }
+}
@@ -1,4 +1,6 @@
 #include <string>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "nlohmann/json.hpp"
@@ -61,96 +63,121 @@ namespace xeus
         return false;
     }
 
+    namespace
+    {
+        nl::json make_string_array(std::vector<std::string>&& values)
+        {
+            nl::json::array_t res;
+            res.reserve(values.size());
+            for (std::string& value : values)
+            {
+                res.emplace_back(std::move(value));
+            }
+            return nl::json(std::move(res));
+        }
+    }
+
     // Helpers that create replies to the server
-    nl::json create_error_reply(const std::string& ename,
-                                const std::string& evalue,
-                                const nl::json& trace_back)
+    nl::json create_error_reply(std::string ename,
+                                std::string evalue,
+                                nl::json trace_back)
     {
         nl::json kernel_res;
         kernel_res["status"] = "error";
-        kernel_res["ename"] = ename;
-        kernel_res["evalue"] = evalue;
-        kernel_res["traceback"] = trace_back;
+        kernel_res["ename"] = std::move(ename);
+        kernel_res["evalue"] = std::move(evalue);
+        kernel_res["traceback"] = std::move(trace_back);
         return kernel_res;
     }
 
-    nl::json create_successful_reply(const nl::json& payload,
-                                     const nl::json& user_expressions)
+    nl::json create_successful_reply(nl::json payload,
+                                     nl::json user_expressions)
     {
         nl::json kernel_res;
         kernel_res["status"] = "ok";
-        kernel_res["payload"] = payload;
-        kernel_res["user_expressions"] = user_expressions;
+        kernel_res["payload"] = std::move(payload);
+        kernel_res["user_expressions"] = std::move(user_expressions);
         return kernel_res;
     }
 
-    nl::json create_complete_reply(const nl::json& matches,
-                                   const int& cursor_start,
-                                   const int& cursor_end,
-                                   const nl::json& metadata)
+    nl::json create_complete_reply(nl::json matches,
+                                   int cursor_start,
+                                   int cursor_end,
+                                   nl::json metadata)
     {
         nl::json kernel_res;
         kernel_res["status"] = "ok";
-        kernel_res["matches"] = matches;
+        kernel_res["matches"] = std::move(matches);
         kernel_res["cursor_start"] = cursor_start;
         kernel_res["cursor_end"] = cursor_end;
-        kernel_res["metadata"] = metadata;
+        kernel_res["metadata"] = std::move(metadata);
         return kernel_res;
     }
 
-    nl::json create_inspect_reply(const bool found,
-                                  const nl::json& data,
-                                  const nl::json& metadata)
+    nl::json create_complete_reply(complete_reply_content&& reply)
+    {
+        return create_complete_reply(make_string_array(std::move(reply.m_matches)),
+                                     reply.m_cursor_start,
+                                     reply.m_cursor_end,
+                                     std::move(reply.m_metadata));
+    }
+
+    nl::json create_inspect_reply(bool found,
+                                  nl::json data,
+                                  nl::json metadata)
     {
         nl::json kernel_res;
         kernel_res["status"] = "ok";
         kernel_res["found"] = found;
-        kernel_res["data"] = data;
-        kernel_res["metadata"] = metadata;
+        kernel_res["data"] = std::move(data);
+        kernel_res["metadata"] = std::move(metadata);
         return kernel_res;
     }
 
-    nl::json create_is_complete_reply(const std::string& status,
-                                      const std::string& indent)
+    nl::json create_is_complete_reply(std::string status,
+                                      std::string indent)
     {
         nl::json kernel_res;
-        kernel_res["status"] = status;
-        kernel_res["indent"] = indent;
+        kernel_res["status"] = std::move(status);
+        kernel_res["indent"] = std::move(indent);
         return kernel_res;
     }
 
-    nl::json create_info_reply(const std::string& implementation,
-                               const std::string& implementation_version,
-                               const std::string& language_name,
-                               const std::string& language_version,
-                               const std::string& language_mimetype,
-                               const std::string& language_file_extension,
-                               const std::string& language_pygments_lexer,
+    nl::json create_info_reply(std::string implementation,
+                               std::string implementation_version,
+                               std::string language_name,
+                               std::string language_version,
+                               std::string language_mimetype,
+                               std::string language_file_extension,
+                               std::string language_pygments_lexer,
                                codemirror_mode_t language_codemirror_mode,
-                               const std::string& language_nbconvert_exporter,
-                               const std::string& banner,
-                               const nl::json& help_links,
-                               const std::vector<std::string>& supported_features)
+                               std::string language_nbconvert_exporter,
+                               std::string banner,
+                               nl::json help_links,
+                               std::vector<std::string> supported_features)
     {
+        nl::json language_info;
+        language_info["name"] = std::move(language_name);
+        language_info["version"] = std::move(language_version);
+        language_info["mimetype"] = std::move(language_mimetype);
+        language_info["file_extension"] = std::move(language_file_extension);
+        language_info["pygments_lexer"] = std::move(language_pygments_lexer);
+        std::visit([&language_info](auto&& arg)
+        {
+            language_info["codemirror_mode"] = std::move(arg);
+        }, std::move(language_codemirror_mode));
+        language_info["nbconvert_exporter"] = std::move(language_nbconvert_exporter);
+
         nl::json kernel_res;
         // kernel_res["protocol_version"] is set in xkernel_core::kernel_info_request
         // to ensure the same version for all the xeus-based kernels
         kernel_res["status"] = "ok";
-        kernel_res["implementation"] = implementation;
-        kernel_res["implementation_version"] = implementation_version;
-        kernel_res["language_info"]["name"] = language_name;
-        kernel_res["language_info"]["version"] = language_version;
-        kernel_res["language_info"]["mimetype"] = language_mimetype;
-        kernel_res["language_info"]["file_extension"] = language_file_extension;
-        kernel_res["language_info"]["pygments_lexer"] = language_pygments_lexer;
-        std::visit([&kernel_res](auto&& arg)
-        {
-            kernel_res["language_info"]["codemirror_mode"] = std::move(arg);
-        }, std::move(language_codemirror_mode));
-        kernel_res["language_info"]["nbconvert_exporter"] = language_nbconvert_exporter;
-        kernel_res["banner"] = banner;
-        kernel_res["help_links"] = help_links;
-        kernel_res["supported_features"] = supported_features;
+        kernel_res["implementation"] = std::move(implementation);
+        kernel_res["implementation_version"] = std::move(implementation_version);
+        kernel_res["language_info"] = std::move(language_info);
+        kernel_res["banner"] = std::move(banner);
+        kernel_res["help_links"] = std::move(help_links);
+        kernel_res["supported_features"] = make_string_array(std::move(supported_features));
         return kernel_res;
     }
 
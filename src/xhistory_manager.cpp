@@ -35,40 +35,29 @@ namespace xeus
     }
 
     nl::json xhistory_manager::process_request(const nl::json& content) const
+    {
+        return process_request(decode_content<history_request_content>(content));
+    }
+
+    nl::json xhistory_manager::process_request(const history_request_content& content) const
     {
         nl::json history;
 
-        std::string hist_access_type = content.value("hist_access_type", "tail");
+        const std::string& hist_access_type = content.m_hist_access_type;
 
-        if (hist_access_type.compare("tail") == 0)
+        if (hist_access_type == "tail")
         {
-            int n = content.value("n", 10);
-            bool raw = content.value("raw", true);
-            bool output = content.value("output", false);
-
-            history = get_tail(n, raw, output);
+            history = get_tail(content.m_n, content.m_raw, content.m_output);
         }
 
-        if (hist_access_type.compare("search") == 0)
+        if (hist_access_type == "search")
         {
-            std::string pattern = content.value("pattern", "*");
-            bool raw = content.value("raw", true);
-            bool output = content.value("output", false);
-            int n = content.value("n", 10);
-            bool unique = content.value("unique", false);
-
-            history = search(pattern, raw, output, n, unique);
+            history = search(content.m_pattern, content.m_raw, content.m_output, content.m_n, content.m_unique);
         }
 
-        if (hist_access_type.compare("range") == 0)
+        if (hist_access_type == "range")
         {
-            int session = content.value("session", 0);
-            int start = content.value("start", 1);
-            int stop = content.value("stop", 10);
-            bool raw = content.value("raw", true);
-            bool output = content.value("output", false);
-
-            history = get_range(session, start, stop, raw, output);
+            history = get_range(content.m_session, content.m_start, content.m_stop, content.m_raw, content.m_output);
         }
 
         return history;
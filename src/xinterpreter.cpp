@@ -14,11 +14,32 @@
 #include "nlohmann/json.hpp"
 
 #include "xeus/xinterpreter.hpp"
+#include "xeus/xstring_utils.hpp"
 
 namespace nl = nlohmann;
 
 namespace xeus
 {
+    namespace
+    {
+        // Interpreters publish raw output, which may not be valid UTF-8;
+        // the serialization of the message would then throw.
+        void repair_utf8_strings(nl::json& j)
+        {
+            if (j.is_string())
+            {
+                repair_utf8(j.get_ref<std::string&>());
+            }
+            else if (j.is_structured())
+            {
+                for (nl::json& item : j)
+                {
+                    repair_utf8_strings(item);
+                }
+            }
+        }
+    }
+
     xinterpreter::xinterpreter()
         : m_execution_count(0)
     {
@@ -99,13 +120,41 @@ namespace xeus
         m_publisher = publisher;
     }
 
-    void xinterpreter::publish_stream(const std::string& name, const std::string& text)
+    void xinterpreter::publish_serialized_content(std::string_view msg_type,
+                                                  nl::json metadata,
+                                                  binary_buffer content,
+                                                  buffer_sequence buffers)
+    {
+        if (m_publisher)
+        {
+            m_publisher(
+                get_request_context(),
+                msg_type,
+                std::move(metadata),
+                xmessage_section(std::move(content)),
+                std::move(buffers)
+            );
+        }
+    }
+
+    void xinterpreter::publish_stream(std::string_view name, std::string_view text)
+    {
+        publish_stream(name, std::string(text));
+    }
+
+    void xinterpreter::publish_stream(std::string_view name, const char* text)
+    {
+        publish_stream(name, std::string(text));
+    }
+
+    void xinterpreter::publish_stream(std::string_view name, std::string&& text)
     {
         if (m_publisher)
         {
+            repair_utf8(text);
             nl::json content;
             content["name"] = name;
-            content["text"] = text;
+            content["text"] = std::move(text);
             m_publisher(
                 get_request_context(),
                 "stream",
@@ -144,7 +193,7 @@ namespace xeus
         }
     }
 
-    void xinterpreter::publish_execution_input(const std::string& code, int execution_count)
+    void xinterpreter::publish_execution_input(std::string_view code, int execution_count)
     {
         if (m_publisher)
         {
@@ -179,16 +228,21 @@ namespace xeus
         }
     }
 
-    void xinterpreter::publish_execution_error(const std::string& ename,
-                                               const std::string& evalue,
-                                               const std::vector<std::string>& trace_back)
+    void xinterpreter::publish_execution_error(std::string_view ename,
+                                               std::string_view evalue,
+                                               std::vector<std::string> trace_back)
     {
         if (m_publisher)
         {
             nl::json content;
             content["ename"] = ename;
             content["evalue"] = evalue;
-            content["traceback"] = trace_back;
+            // Converting the vector would copy its strings
+            nl::json& traceback = content["traceback"] = nl::json::array();
+            for (std::string& line : trace_back)
+            {
+                traceback.push_back(std::move(line));
+            }
             m_publisher(
                 get_request_context(),
                 "error",
@@ -256,7 +310,7 @@ namespace xeus
         return *p_messenger;
     }
 
-    void xinterpreter::input_request(const std::string& prompt, bool pwd)
+    void xinterpreter::input_request(std::string_view prompt, bool pwd)
     {
         if (m_stdin)
         {
@@ -291,6 +345,7 @@ namespace xeus
     nl::json xinterpreter::build_display_content(nl::json data, nl::json metadata, nl::json transient)
     {
         nl::json res;
+        repair_utf8_strings(data);
         res["data"] = std::move(data);
         res["metadata"] = std::move(metadata);
         res["transient"] = std::move(transient);
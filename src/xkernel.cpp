@@ -81,9 +81,10 @@ namespace xeus
                      logger_ptr logger,
                      debugger_builder dbuilder,
                      nl::json debugger_config,
-                     nl::json::error_handler_t eh)
-        : m_kernel_id(new_xguid())
-        , m_session_id(new_xguid())
+                     nl::json::error_handler_t eh,
+                     std::optional<xguid_generator> guid_generator)
+        : m_kernel_id(new_xguid(xguid_generator::system))
+        , m_session_id(new_xguid(xguid_generator::system))
         , m_user_name(user_name)
         , p_context(std::move(context))
         , p_interpreter(std::move(interpreter))
@@ -91,12 +92,14 @@ namespace xeus
         , p_logger(std::move(logger))
         , m_debugger_config(debugger_config)
         , m_error_handler(eh)
+        , m_guid_generator(guid_generator)
     {
         std::visit([this](auto& arg)
         {
             if (arg.m_key.size() == 0)
             {
-                arg.m_key = new_xguid();
+                // The key signs the messages, it must not be predictable
+                arg.m_key = new_xguid(xguid_generator::system);
             }
             m_config.m_transport = arg.m_transport;
             m_config.m_ip = arg.m_ip;
@@ -121,7 +124,8 @@ namespace xeus
                                                 p_server.get(),
                                                 p_interpreter.get(),
                                                 p_history_manager.get(),
-                                                p_debugger.get());
+                                                p_debugger.get(),
+                                                m_guid_generator);
 
         xcontrol_messenger& messenger = p_server->get_control_messenger();
 
@@ -143,7 +147,8 @@ namespace xeus
                      logger_ptr logger,
                      debugger_builder dbuilder,
                      nl::json debugger_config,
-                     nl::json::error_handler_t eh)
+                     nl::json::error_handler_t eh,
+                     std::optional<xguid_generator> guid_generator)
         : xkernel(
             xkernel_configuration{},
             user_name,
@@ -154,7 +159,8 @@ namespace xeus
             std::move(logger),
             std::move(dbuilder),
             debugger_config,
-            eh)
+            eh,
+            guid_generator)
     {
     }
 
@@ -183,4 +189,9 @@ namespace xeus
     {
         return *p_server;
     }
+
+    void xkernel::set_status_policy(const xstatus_policy& policy)
+    {
+        p_core->set_status_policy(policy);
+    }
 }
@@ -7,10 +7,13 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 
@@ -18,6 +21,7 @@
 
 #include "xkernel_core.hpp"
 #include "xeus/xhistory_manager.hpp"
+#include "xeus/xrequest_content.hpp"
 #include "xeus/xrequest_context.hpp"
 
 using namespace std::placeholders;
@@ -31,10 +35,15 @@ namespace xeus
                                server_ptr server,
                                interpreter_ptr interpreter,
                                history_manager_ptr history_manager,
-                               debugger_ptr debugger)
+                               debugger_ptr debugger,
+                               std::optional<xguid_generator> guid_generator)
         : m_kernel_id(std::move(kernel_id))
-        , m_user_name(std::move(user_name))
-        , m_session_id(std::move(session_id))
+        , m_header_factory(user_name, session_id, guid_generator)
+        , m_topic_prefix("kernel_core." + m_kernel_id + ".")
+        , m_handler()
+        , m_quiet_threshold(std::chrono::microseconds::zero())
+        , m_quiet_requests()
+        , m_deferred_count(0)
         , m_comm_manager(this)
         , p_logger(logger)
         , p_server(server)
@@ -43,19 +52,19 @@ namespace xeus
         , p_debugger(debugger)
     {
         // Request handlers (all but execute_request are blocking)
-        m_handler["execute_request"] = handler_type{&xkernel_core::execute_request, /*blocking*/ false};
-        m_handler["complete_request"] = handler_type{&xkernel_core::complete_request, true};
-        m_handler["inspect_request"] = handler_type{&xkernel_core::inspect_request, true};
-        m_handler["history_request"] = handler_type{&xkernel_core::history_request, true};
-        m_handler["is_complete_request"] = handler_type{&xkernel_core::is_complete_request, true};
-        m_handler["comm_info_request"] = handler_type{&xkernel_core::comm_info_request, true};
-        m_handler["comm_open"] = handler_type{&xkernel_core::comm_open, true};
-        m_handler["comm_close"] = handler_type{&xkernel_core::comm_close, true};
-        m_handler["comm_msg"] = handler_type{&xkernel_core::comm_msg, true};
-        m_handler["kernel_info_request"] = handler_type{&xkernel_core::kernel_info_request, true};
-        m_handler["shutdown_request"] = handler_type{&xkernel_core::shutdown_request, true};
-        m_handler["interrupt_request"] = handler_type{&xkernel_core::interrupt_request, true};
-        m_handler["debug_request"] = handler_type{&xkernel_core::debug_request, true};
+        register_handler(message_type::execute_request, &xkernel_core::execute_request, /*blocking*/ false);
+        register_handler(message_type::complete_request, &xkernel_core::complete_request, true);
+        register_handler(message_type::inspect_request, &xkernel_core::inspect_request, true);
+        register_handler(message_type::history_request, &xkernel_core::history_request, true);
+        register_handler(message_type::is_complete_request, &xkernel_core::is_complete_request, true);
+        register_handler(message_type::comm_info_request, &xkernel_core::comm_info_request, true);
+        register_handler(message_type::comm_open, &xkernel_core::comm_open, true);
+        register_handler(message_type::comm_close, &xkernel_core::comm_close, true);
+        register_handler(message_type::comm_msg, &xkernel_core::comm_msg, true);
+        register_handler(message_type::kernel_info_request, &xkernel_core::kernel_info_request, true);
+        register_handler(message_type::shutdown_request, &xkernel_core::shutdown_request, true);
+        register_handler(message_type::interrupt_request, &xkernel_core::interrupt_request, true);
+        register_handler(message_type::debug_request, &xkernel_core::debug_request, true);
 
         // Server bindings
         p_server->register_shell_listener(std::bind(&xkernel_core::dispatch_shell, this, _1));
@@ -65,9 +74,9 @@ namespace xeus
 
         // Interpreter bindings
         p_interpreter->register_publisher([this](xrequest_context request_context,
-                                                 const std::string& msg_type,
+                                                 std::string_view msg_type,
                                                  nl::json metadata,
-                                                 nl::json content,
+                                                 xmessage_section content,
                                                  buffer_sequence buffers)
         {
             this->publish_message(msg_type, request_context.header(), std::move(metadata), std::move(content), std::move(buffers),
@@ -75,7 +84,7 @@ namespace xeus
         });
 
         p_interpreter->register_stdin_sender([this](xrequest_context request_context,
-                                                   const std::string& msg_type,
+                                                   std::string_view msg_type,
                                                    nl::json metadata,
                                                    nl::json content)
         {
@@ -93,12 +102,12 @@ namespace xeus
 
     xpub_message xkernel_core::build_start_msg() const
     {
-        std::string topic = "kernel_core." + m_kernel_id + ".status";
+        std::string topic = get_topic(to_string(message_type::status));
         nl::json content;
         content["execution_state"] = "starting";
 
         xpub_message msg(topic,
-                         make_header("status", m_user_name, m_session_id),
+                         m_header_factory.make_typed_header("status"),
                          nl::json::object(),
                          nl::json::object(),
                          std::move(content),
@@ -139,31 +148,48 @@ namespace xeus
         return rep;
     }
 
-    void xkernel_core::publish_message(const std::string& msg_type,
+    void xkernel_core::publish_message(std::string_view msg_type,
                                        nl::json parent_header,
                                        nl::json metadata,
-                                       nl::json content,
+                                       xmessage_section content,
                                        buffer_sequence buffers,
                                        channel c)
     {
-        xpub_message msg(get_topic(msg_type),
-                         make_header(msg_type, m_user_name, m_session_id),
-                         std::move(parent_header),
-                         std::move(metadata),
-                         std::move(content),
-                         std::move(buffers));
-        p_logger->log_iopub_message(msg);
-        p_server->publish(std::move(msg), c);
+        flush_deferred_status();
+        send_iopub(xpub_message(get_topic(msg_type),
+                                m_header_factory.make_typed_header(msg_type),
+                                std::move(parent_header),
+                                std::move(metadata),
+                                std::move(content),
+                                std::move(buffers)),
+                   c);
+    }
+
+    void xkernel_core::publish_message(std::string_view msg_type,
+                                       nl::json parent_header,
+                                       nl::json metadata,
+                                       xmessage_section content,
+                                       chunked_buffer_sequence buffers,
+                                       channel c)
+    {
+        flush_deferred_status();
+        send_iopub(xpub_message(get_topic(msg_type),
+                                m_header_factory.make_typed_header(msg_type),
+                                std::move(parent_header),
+                                std::move(metadata),
+                                std::move(content),
+                                std::move(buffers)),
+                   c);
     }
 
-    void xkernel_core::send_stdin(const std::string& msg_type,
+    void xkernel_core::send_stdin(std::string_view msg_type,
                                   const guid_list& id_list,
                                   nl::json parent_header,
                                   nl::json metadata,
                                   nl::json content)
     {
         xmessage msg(id_list,
-                     make_header(msg_type, m_user_name, m_session_id),
+                     m_header_factory.make_typed_header(msg_type),
                      std::move(parent_header),
                      std::move(metadata),
                      std::move(content),
@@ -194,44 +220,77 @@ namespace xeus
 
     void xkernel_core::dispatch(xmessage msg, channel c)
     {
-        p_logger->log_received_message(msg, c == channel::SHELL ? xlogger::shell : xlogger::control);
         // Copy because the msg is moved after, and we may need the header
-        // for publishing the status.
-        nl::json header = msg.header();
-        publish_status(header, "busy", c);
+        // for publishing the status. The other sections of the message are
+        // only parsed if the handler accesses them.
+        nl::json header;
+        try
+        {
+            header = msg.header();
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "ERROR: received message with invalid header: " << e.what() << std::endl;
+            return;
+        }
+        try
+        {
+            // Logging may parse the other sections of the message
+            p_logger->log_received_message(msg, c == channel::SHELL ? xlogger::shell : xlogger::control);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "ERROR: could not log received message: " << e.what() << std::endl;
+        }
+        message_type msg_type = to_message_type(msg.msg_type());
+        const handler_type* handler = get_handler(msg_type);
+        bool blocking = handler == nullptr || handler->blocking;
 
-        std::string msg_type = header.value("msg_type", "");
-        handler_type handler = get_handler(msg_type);
-        if (handler.fptr == nullptr)
+        bool deferred = blocking && handler != nullptr && defer_status(header, msg_type, c);
+        if (!deferred)
+        {
+            publish_status(header, "busy", c);
+        }
+        if (handler == nullptr || handler->fptr == nullptr)
         {
             std::cerr << "ERROR: received unknown message" << std::endl;
-            std::cerr << "Message type: " << msg_type << std::endl;
+            std::cerr << "Message type: " << msg.msg_type() << std::endl;
         }
         else
         {
             try
             {
-                (this->*(handler.fptr))(std::move(msg), c);
+                (this->*(handler->fptr))(std::move(msg), c);
             }
             catch (std::exception& e)
             {
                 std::cerr << "ERROR: received bad message: " << e.what() << std::endl;
-                std::cerr << "Message type: " << msg_type << std::endl;
+                std::cerr << "Message type: " << to_string(msg_type) << std::endl;
             }
         }
 
+        if (deferred)
+        {
+            // Short requests that published nothing get no busy status
+            publish_late_status(c, true);
+        }
+
         // async handlers need to set the idle status themselves
-        if(handler.blocking)
+        if(blocking)
         {
             publish_status(header, "idle", c);
         }
     }
 
-    auto xkernel_core::get_handler(const std::string& msg_type) -> handler_type
+    void xkernel_core::register_handler(message_type msg_type, handler_fptr_type fptr, bool blocking)
+    {
+        m_handler[static_cast<std::size_t>(msg_type)] = handler_type{fptr, blocking};
+    }
+
+    auto xkernel_core::get_handler(message_type msg_type) const -> const handler_type*
     {
-        auto iter = m_handler.find(msg_type);
-        handler_type res = (iter == m_handler.end()) ? handler_type{nullptr} : iter->second;
-        return res;
+        auto index = static_cast<std::size_t>(msg_type);
+        return index < m_handler.size() ? &m_handler[index] : nullptr;
     }
 
     void xkernel_core::execute_request(xmessage request, channel)
@@ -239,19 +298,15 @@ namespace xeus
         // xeus assumes execute_request will be executed on SHELL only
         try
         {
-            const nl::json& content = request.content();
-            std::string code = content.value("code", "");
-            bool silent = content.value("silent", false);
-            bool store_history = content.value("store_history", true);
-            store_history = store_history && !silent;
-            nl::json user_expression = content.value("user_expressions", nl::json::object());
-            bool allow_stdin = content.value("allow_stdin", true);
-            bool stop_on_error = content.value("stop_on_error", false);
+            // Shared with the reply callback so that the code is not copied
+            auto content = std::make_shared<execute_request_content>();
+            decode_content(request.content_section(), *content);
+            bool store_history = content->m_store_history && !content->m_silent;
 
             xrequest_context request_context(request.header(), request.identities());
-            execute_request_config config { silent, store_history, allow_stdin };
+            execute_request_config config { content->m_silent, store_history, content->m_allow_stdin };
 
-            auto reply_callback = [this, request_context, config, stop_on_error, code](nl::json reply)
+            auto reply_callback = [this, request_context, config, content](nl::json reply)
             {
                 int execution_count = 1;
                 execution_count = reply.value("execution_count", 1);
@@ -261,7 +316,7 @@ namespace xeus
 
                 send_reply(
                     request_context.id(),
-                    "execute_reply", 
+                    message_type::execute_reply,
                     request_context.header(),
                     std::move(metadata), 
                     std::move(reply), 
@@ -270,9 +325,9 @@ namespace xeus
 
                 if (!config.silent && config.store_history)
                 {
-                    p_history_manager->store_inputs(0, execution_count, code);
+                    p_history_manager->store_inputs(0, execution_count, content->m_code);
                 }
-                if (!config.silent && status == "error" && stop_on_error)
+                if (!config.silent && status == "error" && content->m_stop_on_error)
                 {
                     constexpr long polling_interval = 50;
                     p_server->abort_queue(std::bind(&xkernel_core::abort_request, this, _1), polling_interval);
@@ -285,9 +340,9 @@ namespace xeus
             p_interpreter->execute_request(
                 std::move(request_context),
                 std::move(reply_callback),
-                code,
+                content->m_code,
                 config,
-                std::move(user_expression)
+                std::move(content->m_user_expressions)
             );
         }
         catch (std::exception& e)
@@ -299,39 +354,33 @@ namespace xeus
 
     void xkernel_core::complete_request(xmessage request, channel c)
     {
-        const nl::json& content = request.content();
-        std::string code = content.value("code", "");
-        int cursor_pos = content.value("cursor_pos", -1);
-        nl::json reply = p_interpreter->complete_request(code, cursor_pos);
-        send_reply(request.identities(), "complete_reply", request.header(),
+        auto content = decode_content<complete_request_content>(request.content_section());
+        nl::json reply = p_interpreter->complete_request(content.m_code, content.m_cursor_pos);
+        send_reply(request.identities(), message_type::complete_reply, request.header(),
             nl::json::object(), std::move(reply), c);
     }
 
     void xkernel_core::inspect_request(xmessage request, channel c)
     {
-        const nl::json& content = request.content();
-        std::string code = content.value("code", "");
-        int cursor_pos = content.value("cursor_pos", -1);
-        int detail_level = content.value("detail_level", 0);
-        nl::json reply = p_interpreter->inspect_request(code, cursor_pos, detail_level);
-        send_reply(request.identities(), "inspect_reply", request.header(), nl::json::object(), std::move(reply), c);
+        auto content = decode_content<inspect_request_content>(request.content_section());
+        nl::json reply = p_interpreter->inspect_request(content.m_code, content.m_cursor_pos, content.m_detail_level);
+        send_reply(request.identities(), message_type::inspect_reply, request.header(), nl::json::object(), std::move(reply), c);
     }
 
     void xkernel_core::history_request(xmessage request, channel c)
     {
-        const nl::json& content = request.content();
+        auto content = decode_content<history_request_content>(request.content_section());
 
         nl::json history = p_history_manager->process_request(content);
 
-        send_reply(request.identities(), "history_reply",  request.header(), nl::json::object(), std::move(history), c);
+        send_reply(request.identities(), message_type::history_reply, request.header(), nl::json::object(), std::move(history), c);
     }
 
     void xkernel_core::is_complete_request(xmessage request, channel c)
     {
-        const nl::json& content = request.content();
-        std::string code = content.value("code", "");
-        nl::json reply = p_interpreter->is_complete_request(code);
-        send_reply(request.identities(), "is_complete_reply", request.header(), nl::json::object(), std::move(reply), c);
+        auto content = decode_content<is_complete_request_content>(request.content_section());
+        nl::json reply = p_interpreter->is_complete_request(content.m_code);
+        send_reply(request.identities(), message_type::is_complete_reply, request.header(), nl::json::object(), std::move(reply), c);
     }
 
     void xkernel_core::comm_info_request(xmessage request, channel c)
@@ -356,14 +405,14 @@ namespace xeus
         nl::json reply;
         reply["comms"] = comms;
         reply["status"] = "ok";
-        send_reply(request.identities(), "comm_info_reply",request.header(), nl::json::object(), std::move(reply), c);
+        send_reply(request.identities(), message_type::comm_info_reply, request.header(), nl::json::object(), std::move(reply), c);
     }
 
     void xkernel_core::kernel_info_request(xmessage request, channel c)
     {
         nl::json reply = p_interpreter->kernel_info_request();
         reply["protocol_version"] = get_protocol_version();
-        send_reply(request.identities(), "kernel_info_reply", request.header(), nl::json::object(), std::move(reply), c);
+        send_reply(request.identities(), message_type::kernel_info_reply, request.header(), nl::json::object(), std::move(reply), c);
     }
 
     void xkernel_core::shutdown_request(xmessage request, channel c)
@@ -373,7 +422,7 @@ namespace xeus
         nl::json reply = p_interpreter->shutdown_request(restart);
         std::string reply_status = reply["status"];
         publish_message("shutdown", request.header(), nl::json::object(), reply, buffer_sequence(), channel::CONTROL);
-        send_reply(request.identities(), "shutdown_reply", request.header(), nl::json::object(), std::move(reply), c);
+        send_reply(request.identities(), message_type::shutdown_reply, request.header(), nl::json::object(), std::move(reply), c);
         if (reply_status == "ok")
         {
             p_server->stop();
@@ -385,7 +434,7 @@ namespace xeus
         nl::json reply = p_interpreter->interrupt_request();
         std::string reply_status = reply["status"];
         publish_message("interrupt", request.header(), nl::json::object(), reply, buffer_sequence(), channel::CONTROL);
-        send_reply(request.identities(), "interrupt_reply", request.header(), nl::json::object(), std::move(reply), c);
+        send_reply(request.identities(), message_type::interrupt_reply, request.header(), nl::json::object(), std::move(reply), c);
     }
 
     void xkernel_core::debug_request(xmessage request, channel c)
@@ -394,15 +443,113 @@ namespace xeus
         {
             nl::json reply = p_debugger->process_request(request.header(), request.content());
             nl::json metadata = get_metadata();
-            send_reply(request.identities(), "debug_reply", request.header(), std::move(metadata), std::move(reply), c);
+            send_reply(request.identities(), message_type::debug_reply, request.header(), std::move(metadata), std::move(reply), c);
         }
     }
 
     void xkernel_core::publish_status(nl::json parent_header, const std::string& status, channel c)
+    {
+        flush_deferred_status();
+        send_iopub(build_status_message(std::move(parent_header), status), c);
+    }
+
+    xpub_message xkernel_core::build_status_message(nl::json parent_header, const std::string& status)
     {
         nl::json content;
         content["execution_state"] = status;
-        publish_message("status", parent_header, nl::json::object(), std::move(content), buffer_sequence(), c);
+        return xpub_message(get_topic("status"),
+                            m_header_factory.make_typed_header("status"),
+                            std::move(parent_header),
+                            nl::json::object(),
+                            std::move(content),
+                            buffer_sequence());
+    }
+
+    void xkernel_core::set_status_policy(const xstatus_policy& policy)
+    {
+        m_quiet_threshold = policy.m_quiet_threshold;
+        m_quiet_requests.reset();
+        for (message_type type : policy.m_quiet_requests)
+        {
+            auto index = static_cast<std::size_t>(type);
+            if (index < m_quiet_requests.size())
+            {
+                m_quiet_requests.set(index);
+            }
+        }
+    }
+
+    void xkernel_core::send_iopub(xpub_message msg, channel c)
+    {
+        p_logger->log_iopub_message(msg);
+        p_server->publish(std::move(msg), c);
+    }
+
+    bool xkernel_core::defer_status(const nl::json& parent_header, message_type msg_type, channel c)
+    {
+        auto index = static_cast<std::size_t>(msg_type);
+        if (m_quiet_threshold <= std::chrono::microseconds::zero() || index >= m_quiet_requests.size() || !m_quiet_requests[index])
+        {
+            return false;
+        }
+        deferred_status& status = m_deferred_status[static_cast<std::size_t>(c)];
+        std::lock_guard<std::mutex> lock(status.m_mutex);
+        status.p_parent_header = &parent_header;
+        status.m_start = std::chrono::steady_clock::now();
+        m_deferred_count.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    // Publishes the deferred busy status of the request of channel c if
+    // it has been handled for m_quiet_threshold or longer, so that a slow
+    // request gets its busy status before its reply and its idle status.
+    // When end is true, the status of the request is not deferred anymore.
+    void xkernel_core::publish_late_status(channel c, bool end)
+    {
+        if (m_deferred_count.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+        deferred_status& status = m_deferred_status[static_cast<std::size_t>(c)];
+        std::lock_guard<std::mutex> lock(status.m_mutex);
+        if (status.p_parent_header == nullptr)
+        {
+            return;
+        }
+        bool late = std::chrono::steady_clock::now() - status.m_start >= m_quiet_threshold;
+        if (late)
+        {
+            send_iopub(build_status_message(*status.p_parent_header, "busy"), c);
+        }
+        if (late || end)
+        {
+            status.p_parent_header = nullptr;
+            m_deferred_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Publishes the deferred busy statuses before any other message, so
+    // that the frontend never receives the output of a request before the
+    // kernel is busy with it. Messages may be published from another thread
+    // than the one handling the request, hence the statuses of both
+    // channels are flushed.
+    void xkernel_core::flush_deferred_status()
+    {
+        if (m_deferred_count.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+        for (std::size_t i = 0; i < m_deferred_status.size(); ++i)
+        {
+            deferred_status& status = m_deferred_status[i];
+            std::lock_guard<std::mutex> lock(status.m_mutex);
+            if (status.p_parent_header != nullptr)
+            {
+                send_iopub(build_status_message(*status.p_parent_header, "busy"), static_cast<channel>(i));
+                status.p_parent_header = nullptr;
+                m_deferred_count.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
     }
 
     void xkernel_core::publish_execute_input(nl::json parent_header,
@@ -420,6 +567,21 @@ namespace xeus
                          channel::SHELL);
     }
 
+    void xkernel_core::send_reply(const guid_list& id_list,
+                                  message_type reply_type,
+                                  nl::json parent_header,
+                                  nl::json metadata,
+                                  nl::json reply_content,
+                                  channel c)
+    {
+        send_reply(id_list,
+                   std::string(to_string(reply_type)),
+                   std::move(parent_header),
+                   std::move(metadata),
+                   std::move(reply_content),
+                   c);
+    }
+
     void xkernel_core::send_reply(const guid_list& id_list,
                                   const std::string& reply_type,
                                   nl::json parent_header,
@@ -428,11 +590,12 @@ namespace xeus
                                   channel c)
     {
         xmessage reply(id_list,
-                       make_header(reply_type, m_user_name, m_session_id),
+                       m_header_factory.make_typed_header(reply_type),
                        std::move(parent_header),
                        std::move(metadata),
                        std::move(reply_content),
                        buffer_sequence());
+        publish_late_status(c, false);
         p_logger->log_sent_message(reply, c == channel::SHELL ? xlogger::shell : xlogger::control);
         if (c == channel::SHELL)
         {
@@ -447,22 +610,41 @@ namespace xeus
     void xkernel_core::abort_request(xmessage msg)
     {
         const nl::json& header = msg.header();
-        std::string msg_type = header.value("msg_type", "");
-        // replace "_request" part of message type by "_reply"
-        msg_type.replace(msg_type.find_last_of('_'), 8, "_reply");
+        const std::string& request_type = msg.msg_type();
         nl::json content;
         content["status"] = "error";
-        send_reply(msg.identities(),
-                   msg_type,
-                   nl::json(header),
-                   nl::json::object(),
-                   std::move(content),
-                   channel::SHELL);
+        message_type msg_type = reply_type(to_message_type(request_type));
+        if (msg_type != message_type::unknown)
+        {
+            send_reply(msg.identities(),
+                       msg_type,
+                       nl::json(header),
+                       nl::json::object(),
+                       std::move(content),
+                       channel::SHELL);
+        }
+        else
+        {
+            // Custom message type: replace "_request" part of message
+            // type by "_reply"
+            std::string custom_reply_type = request_type;
+            auto pos = custom_reply_type.find_last_of('_');
+            custom_reply_type.replace(pos == std::string::npos ? custom_reply_type.size() : pos, 8, "_reply");
+            send_reply(msg.identities(),
+                       custom_reply_type,
+                       nl::json(header),
+                       nl::json::object(),
+                       std::move(content),
+                       channel::SHELL);
+        }
     }
 
-    std::string xkernel_core::get_topic(const std::string& msg_type) const
+    std::string xkernel_core::get_topic(std::string_view msg_type) const
     {
-        return "kernel_core." + m_kernel_id + "." + msg_type;
+        std::string topic;
+        topic.reserve(m_topic_prefix.size() + msg_type.size());
+        topic.append(m_topic_prefix).append(msg_type);
+        return topic;
     }
 
     nl::json xkernel_core::get_metadata() const
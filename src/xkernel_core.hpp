@@ -10,8 +10,14 @@
 #ifndef XEUS_KERNEL_CORE_HPP
 #define XEUS_KERNEL_CORE_HPP
 
-#include <map>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "nlohmann/json.hpp"
 
@@ -21,7 +27,9 @@
 #include "xeus/xhistory_manager.hpp"
 #include "xeus/xdebugger.hpp"
 #include "xeus/xmessage.hpp"
+#include "xeus/xmessage_type.hpp"
 #include "xeus/xlogger.hpp"
+#include "xeus/xstatus_policy.hpp"
 
 namespace nl = nlohmann;
 
@@ -45,7 +53,8 @@ namespace xeus
                      server_ptr server,
                      interpreter_ptr p_interpreter,
                      history_manager_ptr p_history_manager,
-                     debugger_ptr debugger);
+                     debugger_ptr debugger,
+                     std::optional<xguid_generator> guid_generator);
 
         ~xkernel_core();
 
@@ -56,14 +65,24 @@ namespace xeus
         void dispatch_stdin(xmessage msg);
         nl::json dispatch_internal(nl::json msg);
  
-        void publish_message(const std::string& msg_type,
+        // content can be built from a serialized JSON object, in which case
+        // it is handed to the server without being parsed.
+        void publish_message(std::string_view msg_type,
                              nl::json parent_header,
                              nl::json metadata,
-                             nl::json content,
+                             xmessage_section content,
                              buffer_sequence buffers,
                              channel origin);
+        // Chunked buffers are handed to the server as they are, so that
+        // it can stream their segments.
+        void publish_message(std::string_view msg_type,
+                             nl::json parent_header,
+                             nl::json metadata,
+                             xmessage_section content,
+                             chunked_buffer_sequence buffers,
+                             channel origin);
 
-        void send_stdin(const std::string& msg_type, const guid_list& id_list, nl::json parent_header, nl::json metadata, nl::json content);
+        void send_stdin(std::string_view msg_type, const guid_list& id_list, nl::json parent_header, nl::json metadata, nl::json content);
 
         xcomm_manager& comm_manager() & noexcept;
         const xcomm_manager& comm_manager() const & noexcept;
@@ -71,6 +90,9 @@ namespace xeus
 
         const nl::json& parent_header() const noexcept;
 
+        // Must be called before the kernel receives requests
+        void set_status_policy(const xstatus_policy& policy);
+
     private:
 
         using handler_fptr_type = void (xkernel_core::*)(xmessage, channel);
@@ -79,11 +101,14 @@ namespace xeus
             handler_fptr_type fptr = nullptr;
             bool blocking = true;
         };
-        
+
+        using handler_table = std::array<handler_type, message_type_count>;
 
         void dispatch(xmessage msg, channel c);
 
-        handler_type get_handler(const std::string& msg_type);
+        void register_handler(message_type msg_type, handler_fptr_type fptr, bool blocking);
+        // Returns nullptr for custom message types
+        const handler_type* get_handler(message_type msg_type) const;
 
         void execute_request(xmessage request, channel c);
         void complete_request(xmessage request, channel c);
@@ -101,8 +126,20 @@ namespace xeus
         void debug_request(xmessage request, channel c);
 
         void publish_status(nl::json parent_header, const std::string& status, channel c);
+        xpub_message build_status_message(nl::json parent_header, const std::string& status);
+        void send_iopub(xpub_message msg, channel c);
+        bool defer_status(const nl::json& parent_header, message_type msg_type, channel c);
+        void publish_late_status(channel c, bool end);
+        void flush_deferred_status();
         void publish_execute_input(nl::json parent_header, const std::string& code, int execution_count);
 
+        void send_reply(const guid_list& id_list,
+                        message_type reply_type,
+                        nl::json parent_header,
+                        nl::json metadata,
+                        nl::json reply_content,
+                        channel c);
+
         void send_reply(const guid_list& id_list,
                         const std::string& reply_type,
                         nl::json parent_header,
@@ -112,15 +149,31 @@ namespace xeus
 
         void abort_request(xmessage msg);
 
-        std::string get_topic(const std::string& msg_type) const;
+        std::string get_topic(std::string_view msg_type) const;
         nl::json get_metadata() const;
 
 
         std::string m_kernel_id;
-        std::string m_user_name;
-        std::string m_session_id;
+        xheader_factory m_header_factory;
+        std::string m_topic_prefix;
+
+        handler_table m_handler;
+
+        // A request of the shell or control channel whose busy status is
+        // deferred, see xstatus_policy. The mutex is held while the busy
+        // status is published, so that the dispatching thread neither
+        // publishes the idle status before it nor destroys the header.
+        struct deferred_status
+        {
+            std::mutex m_mutex;
+            const nl::json* p_parent_header = nullptr;
+            std::chrono::steady_clock::time_point m_start;
+        };
 
-        std::map<std::string, handler_type> m_handler;
+        std::chrono::microseconds m_quiet_threshold;
+        std::bitset<message_type_count> m_quiet_requests;
+        std::array<deferred_status, 2> m_deferred_status;
+        std::atomic<int> m_deferred_count;
         xcomm_manager m_comm_manager;
         logger_ptr p_logger;
         server_ptr p_server;
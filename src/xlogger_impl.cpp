@@ -7,11 +7,13 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 
 #include "xeus/xjson.hpp"
 #include "xeus/xmessage.hpp"
+#include "xeus/xstring_utils.hpp"
 #include "xlogger_impl.hpp"
 
 namespace nl = nlohmann;
@@ -51,56 +53,63 @@ namespace xeus
     {
         const std::array<std::string, xlogger::CHANNEL_SIZE> channel_str = { "shell", "control", "stdin", "heartbeat" };
 
-
-    
-        /**
-         * @copyright Copyright (c) 2008-2009 Bjoern Hoehrmann <bjoern@hoehrmann.de>
-         * @sa http://bjoern.hoehrmann.de/utf-8/decoder/dfa/
-         */
-        std::uint8_t decode_utf8(std::uint8_t& state, std::uint32_t& codep, const std::uint8_t byte) noexcept
+        // The sections of a message given as JSON values, with the
+        // interface of xmessage_base used by build_json_message.
+        struct json_sections
         {
-            static const uint8_t UTF8_ACCEPT = 0;
-            static const std::array<std::uint8_t, 400> utf8d =
+            std::string msg_type() const { return m_header.value("msg_type", ""); }
+            const nl::json& header() const { return m_header; }
+            const nl::json& parent_header() const { return m_parent_header; }
+            const nl::json& metadata() const { return m_metadata; }
+            const nl::json& content() const { return m_content; }
+
+            const nl::json& m_header;
+            const nl::json& m_parent_header;
+            const nl::json& m_metadata;
+            const nl::json& m_content;
+        };
+
+        // A section that cannot be parsed is logged as a placeholder, so
+        // that logging a malformed message does not throw.
+        template <class F>
+        nl::json logged_section(F section)
+        {
+            try
             {
-                {
-                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 00..1F
-                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 20..3F
-                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 40..5F
-                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 60..7F
-                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, // 80..9F
-                    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, // A0..BF
-                    8, 8, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, // C0..DF
-                    0xA, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x3, 0x4, 0x3, 0x3, // E0..EF
-                    0xB, 0x6, 0x6, 0x6, 0x5, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, // F0..FF
-                    0x0, 0x1, 0x2, 0x3, 0x5, 0x8, 0x7, 0x1, 0x1, 0x1, 0x4, 0x6, 0x1, 0x1, 0x1, 0x1, // s0..s0
-                    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1, 0, 1, 1, 1, 1, 1, 1, // s1..s2
-                    1, 2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, // s3..s4
-                    1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 1, 3, 1, 1, 1, 1, 1, 1, // s5..s6
-                    1, 3, 1, 1, 1, 1, 1, 3, 1, 3, 1, 1, 1, 1, 1, 1, 1, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 // s7..s8
-                }
-            };
-
-            const std::uint8_t type = utf8d[byte];
-
-            codep = (state != UTF8_ACCEPT)
-                    ? (byte & 0x3fu) | (codep << 6u)
-                    : (0xFFu >> type) & (byte);
-
-            state = utf8d[256u + state * 16u + type];
-            return state;
+                return section();
+            }
+            catch (nl::json::parse_error&)
+            {
+                return "<unparsable section>";
+            }
         }
 
-        bool is_utf8_valid(const std::string& str)
+        // Only accesses the sections required by the log level, so that
+        // sections of messages built from serialized frames are not parsed
+        // for nothing.
+        template <class M>
+        nl::json build_json_message(const M& message, xlogger::level l)
         {
-            std::uint32_t codepoint(0);
-            std::uint8_t state(0);
-
-            for (std::size_t i = 0; i < str.size(); ++i)
+            nl::json json_message;
+            json_message["msg_type"] = message.msg_type();
+            switch(l)
             {
-                auto byte = static_cast<uint8_t>(str[i]);
-                decode_utf8(state, codepoint, byte);
+            case xlogger::msg_type:
+                break;
+            case xlogger::content:
+                json_message["content"] = logged_section([&message]() { return message.content(); });
+                break;
+            case xlogger::full:
+            default:
+                {
+                    json_message["header"] = logged_section([&message]() { return message.header(); });
+                    json_message["parent_header"] = logged_section([&message]() { return message.parent_header(); });
+                    json_message["metadata"] = logged_section([&message]() { return message.metadata(); });
+                    json_message["content"] = logged_section([&message]() { return message.content(); });
+                }
+                break;
             }
-            return !state;
+            return json_message;
         }
     }
 
@@ -119,12 +128,9 @@ namespace xeus
         std::string id = message.identities()[0];
         std::string socket_info = "XEUS: received message on "
                                 + channel_str[c] + " - "
-                                + (is_utf8_valid(id) ? id : "invalid UTF8");
-        xlogger::log_message(socket_info,
-                             message.header(),
-                             message.parent_header(),
-                             message.metadata(),
-                             message.content());
+                                + (is_utf8_valid(id.data(), id.size()) ? id : "invalid UTF8");
+        log_json_message(socket_info, build_json_message(message, m_level));
+        p_next_logger->log_received_message(message, c);
     }
 
     void xlogger_common::log_sent_message_impl(const xmessage& message, xlogger::channel c) const
@@ -132,23 +138,17 @@ namespace xeus
         std::string id = message.identities()[0];
         std::string socket_info = "XEUS: sent message on "
                                 + channel_str[c] + " - "
-                                + (is_utf8_valid(id) ? id : "invalid UTF8");
-        xlogger::log_message(socket_info,
-                             message.header(),
-                             message.parent_header(),
-                             message.metadata(),
-                             message.content());
+                                + (is_utf8_valid(id.data(), id.size()) ? id : "invalid UTF8");
+        log_json_message(socket_info, build_json_message(message, m_level));
+        p_next_logger->log_sent_message(message, c);
     }
 
     void xlogger_common::log_iopub_message_impl(const xpub_message& message) const
     {
         std::string socket_info = "XEUS: sent message on iopub - "
                                 + message.topic();
-        xlogger::log_message(socket_info,
-                             message.header(),
-                             message.parent_header(),
-                             message.metadata(),
-                             message.content());
+        log_json_message(socket_info, build_json_message(message, m_level));
+        p_next_logger->log_iopub_message(message);
     }
     
     void xlogger_common::log_message_impl(const std::string& socket_info,
@@ -157,27 +157,8 @@ namespace xeus
                                           const nl::json& metadata,
                                           const nl::json& json_content) const
     {
-        nl::json message;
-        message["msg_type"] = header.value("msg_type", "");
-        switch(m_level)
-        {
-        case msg_type:
-            break;
-        case content:
-            message["content"] = json_content;
-            break;
-        case full:
-        default:
-            {
-                message["header"] = header;
-                message["parent_header"] = parent_header;
-                message["metadata"] = metadata;
-                message["content"] = json_content;
-            }
-            break;
-        }
-
-        log_json_message(socket_info, message);
+        json_sections message{ header, parent_header, metadata, json_content };
+        log_json_message(socket_info, build_json_message(message, m_level));
         p_next_logger->log_message(socket_info, header, parent_header, metadata, json_content);
     }
 
@@ -203,21 +184,43 @@ namespace xeus
 
     xlogger_file::xlogger_file(xlogger::level l,
                                const std::string& file_name,
-                               xlogger_ptr next_logger)
+                               xlogger_ptr next_logger,
+                               message_encoding encoding)
         : xlogger_common(l, std::move(next_logger))
         , m_file_name(file_name)
+        , m_encoding(encoding)
     {
     }
 
+    // With a binary encoding, each record is written as its size on four
+    // bytes (little endian) followed by the encoded record.
     void xlogger_file::log_json_message(const std::string& socket_info,
                                         const nl::json& json_message) const
     {
         nl::json log;
         log["info"] = socket_info;
         log["message"] = json_message;
-        std::lock_guard<std::mutex> lock(m_mutex);
-        std::ofstream out(m_file_name, std::ios_base::app);
-        out << log.dump(4) << std::endl;
+        if (m_encoding == message_encoding::json)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::ofstream out(m_file_name, std::ios_base::app);
+            out << log.dump(4) << std::endl;
+        }
+        else
+        {
+            binary_buffer record = serialize_json(log, m_encoding);
+            auto size = static_cast<std::uint32_t>(record.size());
+            char size_bytes[4] = {
+                static_cast<char>(size & 0xFF),
+                static_cast<char>((size >> 8) & 0xFF),
+                static_cast<char>((size >> 16) & 0xFF),
+                static_cast<char>((size >> 24) & 0xFF)
+            };
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::ofstream out(m_file_name, std::ios_base::app | std::ios_base::binary);
+            out.write(size_bytes, sizeof(size_bytes));
+            out.write(record.data(), static_cast<std::streamsize>(record.size()));
+        }
     }
 
     /************************************
@@ -232,9 +235,10 @@ namespace xeus
 
     std::unique_ptr<xlogger> make_file_logger(xlogger::level log_level,
                                               const std::string& file_name,
-                                              std::unique_ptr<xlogger> next_logger)
+                                              std::unique_ptr<xlogger> next_logger,
+                                              message_encoding encoding)
     {
-        return std::make_unique<xlogger_file>(log_level, file_name, std::move(next_logger));
+        return std::make_unique<xlogger_file>(log_level, file_name, std::move(next_logger), encoding);
     }
 }
 
@@ -111,7 +111,8 @@ namespace xeus
 
         xlogger_file(xlogger::level l,
                      const std::string& file_name,
-                     xlogger_ptr next_logger = nullptr);
+                     xlogger_ptr next_logger = nullptr,
+                     message_encoding encoding = message_encoding::json);
         virtual ~xlogger_file() = default;
 
     private:
@@ -120,6 +121,7 @@ namespace xeus
                               const nl::json& json_message) const override;
 
         std::string m_file_name;
+        message_encoding m_encoding;
         mutable std::mutex m_mutex;
     };
 }
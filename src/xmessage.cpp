@@ -9,13 +9,16 @@
 
 #include <chrono>
 #include <cstddef>
-#include <iomanip>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <memory>
 #include <stdexcept>
-#include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
-#include "nlohmann/json.hpp"
+#include "xeus/xjson.hpp"
 
 #include "xeus/xguid.hpp"
 #include "xeus/xmessage.hpp"
@@ -24,8 +27,382 @@ namespace nl = nlohmann;
 
 namespace xeus
 {
-    xmessage_base::xmessage_base(
-        nl::json header, nl::json parent_header, nl::json metadata, nl::json content, buffer_sequence buffers)
+    namespace
+    {
+        // Appends str as a JSON string, escaped the same way as nl::json::dump.
+        // Characters that need no escaping are appended by runs.
+        template <class O>
+        void append_json_string(O& out, const char* str, std::size_t size)
+        {
+            static constexpr char hex_digits[] = "0123456789abcdef";
+            out.push_back('"');
+            const char* run = str;
+            for (const char* end = str + size; str != end; ++str)
+            {
+                char c = *str;
+                auto uc = static_cast<unsigned char>(c);
+                if (c != '"' && c != '\\' && uc >= 0x20)
+                {
+                    continue;
+                }
+                if (str != run)
+                {
+                    out.append(run, static_cast<std::size_t>(str - run));
+                }
+                run = str + 1;
+                switch (c)
+                {
+                case '"':
+                    out.append("\\\"");
+                    break;
+                case '\\':
+                    out.append("\\\\");
+                    break;
+                case '\b':
+                    out.append("\\b");
+                    break;
+                case '\f':
+                    out.append("\\f");
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\r':
+                    out.append("\\r");
+                    break;
+                case '\t':
+                    out.append("\\t");
+                    break;
+                default:
+                    out.append("\\u00");
+                    out.push_back(hex_digits[uc >> 4]);
+                    out.push_back(hex_digits[uc & 0x0F]);
+                    break;
+                }
+            }
+            if (str != run)
+            {
+                out.append(run, static_cast<std::size_t>(str - run));
+            }
+            out.push_back('"');
+        }
+
+        // Number of days between 1970-01-01 and the given date of the
+        // proleptic Gregorian calendar,
+        // see http://howardhinnant.github.io/date_algorithms.html
+        long days_from_civil(long y, long m, long d) noexcept
+        {
+            y -= m <= 2 ? 1 : 0;
+            const long era = (y >= 0 ? y : y - 399) / 400;
+            const long yoe = y - era * 400;
+            const long doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+            const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + doe - 719468;
+        }
+
+        // Inverse of days_from_civil
+        void civil_from_days(long long z, long long& y, unsigned& m, unsigned& d) noexcept
+        {
+            z += 719468;
+            const long long era = (z >= 0 ? z : z - 146096) / 146097;
+            const auto doe = static_cast<unsigned>(z - era * 146097);
+            const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const unsigned mp = (5 * doy + 2) / 153;
+            d = doy - (153 * mp + 2) / 5 + 1;
+            m = mp < 10 ? mp + 3 : mp - 9;
+            y = static_cast<long long>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+        }
+
+        // Writes the count last decimal digits of value
+        void write_digits(char* out, unsigned long long value, std::size_t count) noexcept
+        {
+            for (std::size_t i = count; i != 0; --i)
+            {
+                out[i - 1] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+
+        template <class O>
+        void append_iso8601(O& out, std::chrono::system_clock::time_point tp)
+        {
+            char buffer[iso8601_size];
+            format_iso8601(tp, buffer);
+            out.append(buffer, iso8601_size);
+        }
+
+        bool read_number(const std::string& str, std::size_t& pos, std::size_t count, long& value)
+        {
+            if (pos + count > str.size())
+            {
+                return false;
+            }
+            value = 0;
+            for (std::size_t i = pos; i < pos + count; ++i)
+            {
+                if (str[i] < '0' || str[i] > '9')
+                {
+                    return false;
+                }
+                value = value * 10 + (str[i] - '0');
+            }
+            pos += count;
+            return true;
+        }
+
+        bool read_char(const std::string& str, std::size_t& pos, const char* expected)
+        {
+            if (pos < str.size() && std::strchr(expected, str[pos]) != nullptr)
+            {
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    /**********************************
+     * xmessage_header implementation *
+     **********************************/
+
+    namespace
+    {
+        const std::string& empty_string() noexcept
+        {
+            static const std::string res;
+            return res;
+        }
+
+        // Writes the fields that come last in the serialized header,
+        // keys are written in the same order as nl::json, i.e.
+        // lexicographical order.
+        template <class O>
+        void append_header_fields(O& out, const std::string& session, const std::string& username, const std::string& version)
+        {
+            out.append(",\"session\":");
+            append_json_string(out, session.data(), session.size());
+            out.append(",\"username\":");
+            append_json_string(out, username.data(), username.size());
+            out.append(",\"version\":");
+            append_json_string(out, version.data(), version.size());
+            out.push_back('}');
+        }
+
+        template <class O>
+        void append_header(O& out, const xmessage_header& header)
+        {
+            out.append("{\"date\":\"");
+            append_iso8601(out, header.m_date);
+            out.append("\",\"msg_id\":");
+            append_json_string(out, header.m_msg_id.data(), header.m_msg_id.size());
+            out.append(",\"msg_type\":");
+            append_json_string(out, header.m_msg_type.data(), header.m_msg_type.size());
+            if (header.p_fields != nullptr && !header.p_fields->m_serialized.empty())
+            {
+                const std::string& fields = header.p_fields->m_serialized;
+                out.append(fields.data(), fields.size());
+            }
+            else
+            {
+                append_header_fields(out, header.session(), header.username(), header.version());
+            }
+        }
+    }
+
+    const std::string& xmessage_header::username() const noexcept
+    {
+        return p_fields != nullptr ? p_fields->m_username : empty_string();
+    }
+
+    const std::string& xmessage_header::session() const noexcept
+    {
+        return p_fields != nullptr ? p_fields->m_session : empty_string();
+    }
+
+    const std::string& xmessage_header::version() const noexcept
+    {
+        return p_fields != nullptr ? p_fields->m_version : empty_string();
+    }
+
+    void to_json(nl::json& j, const xmessage_header& header)
+    {
+        j = nl::json::object();
+        j["msg_id"] = header.m_msg_id;
+        j["username"] = header.username();
+        j["session"] = header.session();
+        j["date"] = iso8601(header.m_date);
+        j["msg_type"] = header.m_msg_type;
+        j["version"] = header.version();
+    }
+
+    xmessage_header parse_header(const nl::json& header)
+    {
+        xmessage_header res;
+        auto it = header.find("msg_id");
+        if (it != header.end())
+        {
+            res.m_msg_id = it->get_ref<const std::string&>();
+        }
+        res.m_msg_type = header.value("msg_type", "");
+        it = header.find("date");
+        if (it != header.end())
+        {
+            res.m_date = parse_iso8601(it->get_ref<const std::string&>());
+        }
+        res.p_fields = std::make_shared<const xheader_fields>(xheader_fields{
+            header.value("username", ""),
+            header.value("session", ""),
+            header.value("version", ""),
+            std::string()
+        });
+        return res;
+    }
+
+    std::string serialize_header(const xmessage_header& header)
+    {
+        std::string res;
+        res.reserve(128 + header.m_msg_type.size() + header.username().size() + header.session().size());
+        append_header(res, header);
+        return res;
+    }
+
+    void serialize_header(const xmessage_header& header, std::ostream& out)
+    {
+        // Gives the stream the interface of std::string used by the
+        // writers above
+        struct stream_writer
+        {
+            std::ostream& m_out;
+
+            void append(const char* s)
+            {
+                append(s, std::strlen(s));
+            }
+
+            void append(const char* s, std::size_t size)
+            {
+                m_out.write(s, static_cast<std::streamsize>(size));
+            }
+
+            void push_back(char c)
+            {
+                m_out.put(c);
+            }
+        };
+        stream_writer writer{out};
+        append_header(writer, header);
+    }
+
+    /***********************************
+     * message_encoding implementation *
+     ***********************************/
+
+    binary_buffer serialize_json(const nl::json& value, message_encoding encoding)
+    {
+        switch (encoding)
+        {
+        case message_encoding::cbor:
+            {
+                std::vector<char> res;
+                nl::json::to_cbor(value, res);
+                return binary_buffer(std::move(res));
+            }
+        case message_encoding::msgpack:
+            {
+                std::vector<char> res;
+                nl::json::to_msgpack(value, res);
+                return binary_buffer(std::move(res));
+            }
+        case message_encoding::json:
+        default:
+            return binary_buffer(value.dump());
+        }
+    }
+
+    nl::json parse_json(const binary_buffer& buffer, message_encoding encoding)
+    {
+        if (buffer.empty())
+        {
+            return nl::json::object();
+        }
+        switch (encoding)
+        {
+        case message_encoding::cbor:
+            return nl::json::from_cbor(buffer.begin(), buffer.end());
+        case message_encoding::msgpack:
+            return nl::json::from_msgpack(buffer.begin(), buffer.end());
+        case message_encoding::json:
+        default:
+            return nl::json::parse(buffer.begin(), buffer.end());
+        }
+    }
+
+    /***********************************
+     * xmessage_section implementation *
+     ***********************************/
+
+    xmessage_section::xmessage_section(nl::json value)
+        : m_value(std::move(value))
+    {
+    }
+
+    xmessage_section::xmessage_section(binary_buffer serialized, message_encoding encoding)
+        : m_serialized(std::move(serialized))
+        , m_encoding(encoding)
+        , m_parsed(false)
+    {
+    }
+
+    const nl::json& xmessage_section::json() const
+    {
+        if (!m_parsed)
+        {
+            // An empty frame stands for an empty dict
+            m_value = parse_json(m_serialized, m_encoding);
+            m_parsed = true;
+        }
+        return m_value;
+    }
+
+    bool xmessage_section::is_parsed() const noexcept
+    {
+        return m_parsed;
+    }
+
+    bool xmessage_section::is_serialized() const noexcept
+    {
+        return m_serialized.data() != nullptr;
+    }
+
+    const binary_buffer& xmessage_section::serialized() const noexcept
+    {
+        return m_serialized;
+    }
+
+    message_encoding xmessage_section::encoding() const noexcept
+    {
+        return m_encoding;
+    }
+
+    binary_buffer xmessage_section::serialized(message_encoding encoding) const
+    {
+        if (is_serialized() && m_encoding == encoding)
+        {
+            return m_serialized;
+        }
+        return serialize_json(json(), encoding);
+    }
+
+    /********************************
+     * xmessage_base implementation *
+     ********************************/
+
+    xmessage_base::xmessage_base(xmessage_section header,
+                                 xmessage_section parent_header,
+                                 xmessage_section metadata,
+                                 xmessage_section content,
+                                 buffer_sequence buffers)
         : m_header(std::move(header))
         , m_parent_header(std::move(parent_header))
         , m_metadata(std::move(metadata))
@@ -34,41 +411,196 @@ namespace xeus
     {
     }
 
+    xmessage_base::xmessage_base(xmessage_header header,
+                                 xmessage_section parent_header,
+                                 xmessage_section metadata,
+                                 xmessage_section content,
+                                 buffer_sequence buffers)
+        : m_typed_header(std::move(header))
+        , m_header_pending(true)
+        , m_parent_header(std::move(parent_header))
+        , m_metadata(std::move(metadata))
+        , m_content(std::move(content))
+        , m_buffers(std::move(buffers))
+    {
+    }
+
+    xmessage_base::xmessage_base(xmessage_serialized_data&& data)
+        : m_header(std::move(data.m_header), data.m_encoding)
+        , m_parent_header(std::move(data.m_parent_header), data.m_encoding)
+        , m_metadata(std::move(data.m_metadata), data.m_encoding)
+        , m_content(std::move(data.m_content), data.m_encoding)
+        , m_buffers(std::move(data.m_buffers))
+        , m_chunked_buffers(std::move(data.m_chunked_buffers))
+    {
+        if (!m_chunked_buffers.empty() && !m_buffers.empty())
+        {
+            // Buffers are either all contiguous or all chunked
+            chunked_buffer_sequence buffers;
+            buffers.reserve(m_buffers.size() + m_chunked_buffers.size());
+            for (binary_buffer& buffer : m_buffers)
+            {
+                buffers.emplace_back(std::move(buffer));
+            }
+            for (xchunked_buffer& buffer : m_chunked_buffers)
+            {
+                buffers.push_back(std::move(buffer));
+            }
+            m_buffers.clear();
+            m_chunked_buffers = std::move(buffers);
+        }
+    }
+
+    xmessage_base::xmessage_base(xmessage_header header,
+                                 xmessage_section parent_header,
+                                 xmessage_section metadata,
+                                 xmessage_section content,
+                                 chunked_buffer_sequence buffers)
+        : m_typed_header(std::move(header))
+        , m_header_pending(true)
+        , m_parent_header(std::move(parent_header))
+        , m_metadata(std::move(metadata))
+        , m_content(std::move(content))
+        , m_chunked_buffers(std::move(buffers))
+    {
+    }
+
     const nl::json& xmessage_base::header() const
     {
-        return m_header;
+        return header_section().json();
+    }
+
+    const xmessage_header& xmessage_base::typed_header() const
+    {
+        if (!m_typed_header)
+        {
+            m_typed_header = parse_header(header());
+        }
+        return *m_typed_header;
     }
 
     const nl::json& xmessage_base::parent_header() const
     {
-        return m_parent_header;
+        return m_parent_header.json();
     }
 
     const nl::json& xmessage_base::metadata() const
     {
-        return m_metadata;
+        return m_metadata.json();
     }
 
     const nl::json& xmessage_base::content() const
+    {
+        return m_content.json();
+    }
+
+    // Does not build the JSON header when the message has been built from
+    // a typed header.
+    const std::string& xmessage_base::msg_type() const
+    {
+        if (m_typed_header)
+        {
+            return m_typed_header->m_msg_type;
+        }
+        static const std::string empty_type;
+        const nl::json& json_header = header();
+        auto it = json_header.find("msg_type");
+        return it != json_header.end() && it->is_string() ? it->get_ref<const std::string&>() : empty_type;
+    }
+
+    const xmessage_section& xmessage_base::header_section() const
+    {
+        if (m_header_pending)
+        {
+            m_header = xmessage_section(nl::json(*m_typed_header));
+            m_header_pending = false;
+        }
+        return m_header;
+    }
+
+    const xmessage_section& xmessage_base::parent_header_section() const noexcept
+    {
+        return m_parent_header;
+    }
+
+    const xmessage_section& xmessage_base::metadata_section() const noexcept
+    {
+        return m_metadata;
+    }
+
+    const xmessage_section& xmessage_base::content_section() const noexcept
     {
         return m_content;
     }
 
     const buffer_sequence& xmessage_base::buffers() const &
     {
+        flatten_buffers();
         return m_buffers;
     }
     
     buffer_sequence&& xmessage_base::buffers() &&
     {
+        flatten_buffers();
         return std::move(m_buffers);
     }
+
+    bool xmessage_base::has_chunked_buffers() const noexcept
+    {
+        return !m_chunked_buffers.empty();
+    }
+
+    chunked_buffer_sequence&& xmessage_base::chunked_buffers() &&
+    {
+        if (m_chunked_buffers.empty())
+        {
+            m_chunked_buffers.reserve(m_buffers.size());
+            for (binary_buffer& buffer : m_buffers)
+            {
+                m_chunked_buffers.emplace_back(std::move(buffer));
+            }
+            m_buffers.clear();
+        }
+        return std::move(m_chunked_buffers);
+    }
+
+    void xmessage_base::flatten_buffers() const
+    {
+        if (!m_chunked_buffers.empty())
+        {
+            m_buffers.reserve(m_buffers.size() + m_chunked_buffers.size());
+            for (xchunked_buffer& buffer : m_chunked_buffers)
+            {
+                m_buffers.push_back(buffer.flatten());
+            }
+            m_chunked_buffers.clear();
+        }
+    }
     
+    /***************************
+     * xmessage implementation *
+     ***************************/
+
     xmessage::xmessage(const guid_list& zmq_id,
-                       nl::json header,
-                       nl::json parent_header,
-                       nl::json metadata,
-                       nl::json content,
+                       xmessage_section header,
+                       xmessage_section parent_header,
+                       xmessage_section metadata,
+                       xmessage_section content,
+                       buffer_sequence buffers)
+        : xmessage_base(std::move(header),
+                        std::move(parent_header),
+                        std::move(metadata),
+                        std::move(content),
+                        std::move(buffers))
+        , m_zmq_id(zmq_id)
+    {
+    }
+
+    xmessage::xmessage(const guid_list& zmq_id,
+                       xmessage_header header,
+                       xmessage_section parent_header,
+                       xmessage_section metadata,
+                       xmessage_section content,
                        buffer_sequence buffers)
         : xmessage_base(std::move(header),
                         std::move(parent_header),
@@ -90,16 +622,27 @@ namespace xeus
     {
     }
 
+    xmessage::xmessage(const guid_list& zmq_id,
+                       xmessage_serialized_data&& data)
+        : xmessage_base(std::move(data))
+        , m_zmq_id(zmq_id)
+    {
+    }
+
     auto xmessage::identities() const -> const guid_list&
     {
         return m_zmq_id;
     }
 
+    /*******************************
+     * xpub_message implementation *
+     *******************************/
+
     xpub_message::xpub_message(const std::string& topic,
-                               nl::json header,
-                               nl::json parent_header,
-                               nl::json metadata,
-                               nl::json content,
+                               xmessage_section header,
+                               xmessage_section parent_header,
+                               xmessage_section metadata,
+                               xmessage_section content,
                                buffer_sequence buffers)
         : xmessage_base(std::move(header),
                         std::move(parent_header),
@@ -110,6 +653,36 @@ namespace xeus
     {
     }
 
+    xpub_message::xpub_message(const std::string& topic,
+                               xmessage_header header,
+                               xmessage_section parent_header,
+                               xmessage_section metadata,
+                               xmessage_section content,
+                               buffer_sequence buffers)
+        : xmessage_base(std::move(header),
+                        std::move(parent_header),
+                        std::move(metadata),
+                        std::move(content),
+                        std::move(buffers))
+        , m_topic(topic)
+    {
+    }
+
+    xpub_message::xpub_message(const std::string& topic,
+                               xmessage_header header,
+                               xmessage_section parent_header,
+                               xmessage_section metadata,
+                               xmessage_section content,
+                               chunked_buffer_sequence buffers)
+        : xmessage_base(std::move(header),
+                        std::move(parent_header),
+                        std::move(metadata),
+                        std::move(content),
+                        std::move(buffers))
+        , m_topic(topic)
+    {
+    }
+
     xpub_message::xpub_message(const std::string& topic,
                                xmessage_base_data&& data)
         : xmessage_base(std::move(data.m_header),
@@ -121,6 +694,13 @@ namespace xeus
     {
     }
 
+    xpub_message::xpub_message(const std::string& topic,
+                               xmessage_serialized_data&& data)
+        : xmessage_base(std::move(data))
+        , m_topic(topic)
+    {
+    }
+
     const std::string& xpub_message::topic() const
     {
         return m_topic;
@@ -128,21 +708,129 @@ namespace xeus
 
     std::string iso8601_now()
     {
-        std::ostringstream ss;
+        return iso8601(std::chrono::system_clock::now());
+    }
+
+    std::string iso8601(std::chrono::system_clock::time_point tp)
+    {
+        char buffer[iso8601_size];
+        format_iso8601(tp, buffer);
+        return std::string(buffer, iso8601_size);
+    }
 
-        // now
-        auto now = std::chrono::system_clock::now();
+    // The date and time down to the seconds only change once per second,
+    // they are formatted once and cached for the calling thread.
+    void format_iso8601(std::chrono::system_clock::time_point tp, char* out) noexcept
+    {
+        constexpr std::size_t prefix_size = 19;
+        struct seconds_cache
+        {
+            long long m_seconds = std::numeric_limits<long long>::min();
+            char m_prefix[prefix_size] = {};
+        };
+        thread_local seconds_cache cache;
 
-        // down to seconds
-        auto itt = std::chrono::system_clock::to_time_t(now);
-        ss << std::put_time(std::gmtime(&itt), "%FT%T");
+        long long micros = std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+        long long seconds = micros / 1000000;
+        long long fractionals = micros % 1000000;
+        if (fractionals < 0)
+        {
+            fractionals += 1000000;
+            --seconds;
+        }
 
-        // down to microseconds
-        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
-        auto fractionals = micros.count() % 1000000;
-        ss << "." << fractionals << "Z";
+        if (seconds != cache.m_seconds)
+        {
+            long long days = seconds / 86400;
+            long long seconds_of_day = seconds % 86400;
+            if (seconds_of_day < 0)
+            {
+                seconds_of_day += 86400;
+                --days;
+            }
+            long long year = 0;
+            unsigned month = 0;
+            unsigned day = 0;
+            civil_from_days(days, year, month, day);
 
-        return ss.str();
+            // YYYY-MM-DDTHH:MM:SS
+            char* prefix = cache.m_prefix;
+            write_digits(prefix, static_cast<unsigned long long>(year), 4);
+            prefix[4] = '-';
+            write_digits(prefix + 5, month, 2);
+            prefix[7] = '-';
+            write_digits(prefix + 8, day, 2);
+            prefix[10] = 'T';
+            write_digits(prefix + 11, static_cast<unsigned long long>(seconds_of_day / 3600), 2);
+            prefix[13] = ':';
+            write_digits(prefix + 14, static_cast<unsigned long long>(seconds_of_day / 60 % 60), 2);
+            prefix[16] = ':';
+            write_digits(prefix + 17, static_cast<unsigned long long>(seconds_of_day % 60), 2);
+            cache.m_seconds = seconds;
+        }
+
+        std::memcpy(out, cache.m_prefix, prefix_size);
+        out[prefix_size] = '.';
+        write_digits(out + prefix_size + 1, static_cast<unsigned long long>(fractionals), 6);
+        out[iso8601_size - 1] = 'Z';
+    }
+
+    std::chrono::system_clock::time_point parse_iso8601(const std::string& date)
+    {
+        // Parses YYYY-MM-DDTHH:MM:SS[.ffffff][Z|+HH:MM|-HH:MM]
+        std::size_t pos = 0;
+        long year = 0, month = 0, day = 0, hours = 0, minutes = 0, seconds = 0;
+        bool valid = read_number(date, pos, 4, year) && read_char(date, pos, "-")
+            && read_number(date, pos, 2, month) && read_char(date, pos, "-")
+            && read_number(date, pos, 2, day) && read_char(date, pos, "Tt ")
+            && read_number(date, pos, 2, hours) && read_char(date, pos, ":")
+            && read_number(date, pos, 2, minutes) && read_char(date, pos, ":")
+            && read_number(date, pos, 2, seconds);
+
+        long micros = 0;
+        if (valid && read_char(date, pos, "."))
+        {
+            std::size_t ndigits = 0;
+            for (; pos < date.size() && date[pos] >= '0' && date[pos] <= '9'; ++pos, ++ndigits)
+            {
+                if (ndigits < 6)
+                {
+                    micros = micros * 10 + (date[pos] - '0');
+                }
+            }
+            valid = ndigits != 0;
+            for (; ndigits < 6; ++ndigits)
+            {
+                micros *= 10;
+            }
+        }
+
+        long offset = 0;
+        if (valid && pos < date.size() && !read_char(date, pos, "Zz"))
+        {
+            long sign = date[pos] == '-' ? -1 : 1;
+            long offset_hours = 0, offset_minutes = 0;
+            valid = read_char(date, pos, "+-") && read_number(date, pos, 2, offset_hours);
+            if (valid)
+            {
+                read_char(date, pos, ":");
+                valid = read_number(date, pos, 2, offset_minutes);
+            }
+            offset = sign * (offset_hours * 3600 + offset_minutes * 60);
+        }
+
+        valid = valid && pos == date.size() && month >= 1 && month <= 12 && day >= 1 && day <= 31
+            && hours < 24 && minutes < 60 && seconds <= 60;
+        if (!valid)
+        {
+            throw std::invalid_argument("Invalid ISO 8601 date: " + date);
+        }
+
+        long total_seconds = days_from_civil(year, month, day) * 86400
+            + hours * 3600 + minutes * 60 + seconds - offset;
+        auto since_epoch = std::chrono::seconds(total_seconds) + std::chrono::microseconds(micros);
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(since_epoch));
     }
 
     std::string get_protocol_version()
@@ -150,9 +838,9 @@ namespace xeus
         return XEUS_KERNEL_PROTOCOL_VERSION;
     }
 
-    nl::json make_header(const std::string& msg_type,
-                      const std::string& user_name,
-                      const std::string& session_id)
+    nl::json make_header(std::string_view msg_type,
+                         std::string_view user_name,
+                         std::string_view session_id)
     {
         nl::json header;
         header["msg_id"] = new_xguid();
@@ -163,4 +851,72 @@ namespace xeus
         header["version"] = get_protocol_version();
         return header;
     }
+
+    xmessage_header make_typed_header(std::string_view msg_type,
+                                      std::string_view user_name,
+                                      std::string_view session_id)
+    {
+        return xmessage_header{
+            std::string(new_xguid()),
+            std::string(msg_type),
+            std::chrono::system_clock::now(),
+            std::make_shared<const xheader_fields>(xheader_fields{
+                std::string(user_name),
+                std::string(session_id),
+                get_protocol_version(),
+                std::string()
+            })
+        };
+    }
+
+    /**********************************
+     * xheader_factory implementation *
+     **********************************/
+
+    xheader_factory::xheader_factory(const std::string& user_name,
+                                     const std::string& session_id,
+                                     std::optional<xguid_generator> generator)
+        : m_generator(generator)
+    {
+        xheader_fields fields{user_name, session_id, get_protocol_version(), std::string()};
+        append_header_fields(fields.m_serialized, fields.m_session, fields.m_username, fields.m_version);
+        p_fields = std::make_shared<const xheader_fields>(std::move(fields));
+    }
+
+    const std::string& xheader_factory::user_name() const noexcept
+    {
+        return p_fields->m_username;
+    }
+
+    const std::string& xheader_factory::session_id() const noexcept
+    {
+        return p_fields->m_session;
+    }
+
+    nl::json xheader_factory::make_header(std::string_view msg_type) const
+    {
+        nl::json header;
+        header["msg_id"] = new_msg_id();
+        header["username"] = p_fields->m_username;
+        header["session"] = p_fields->m_session;
+        header["date"] = iso8601_now();
+        header["msg_type"] = msg_type;
+        header["version"] = p_fields->m_version;
+        return header;
+    }
+
+    xmessage_header xheader_factory::make_typed_header(std::string_view msg_type) const
+    {
+        return xmessage_header{
+            std::string(new_msg_id()),
+            std::string(msg_type),
+            std::chrono::system_clock::now(),
+            p_fields
+        };
+    }
+
+    xguid xheader_factory::new_msg_id() const
+    {
+        return m_generator ? new_xguid(*m_generator) : new_xguid();
+    }
 }
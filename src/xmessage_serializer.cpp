@@ -0,0 +1,538 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xeus/xjson.hpp"
+
+#include "xeus/xmessage_serializer.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    namespace
+    {
+        // Vectors larger than this are not kept by the pool, so that a
+        // single large message does not pin its memory forever.
+        constexpr std::size_t max_pooled_capacity = std::size_t(1) << 20;
+
+        /******************
+         * stream buffers *
+         ******************/
+
+        // The frames are written through a std::ostream, which is what the
+        // public serialization API of nlohmann_json accepts besides strings
+        // and vectors. The buffers below are its only sinks.
+
+        class xcounting_buffer : public std::streambuf
+        {
+        public:
+
+            std::size_t size() const noexcept
+            {
+                return m_size;
+            }
+
+        protected:
+
+            int_type overflow(int_type c) override
+            {
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    ++m_size;
+                }
+                return traits_type::not_eof(c);
+            }
+
+            std::streamsize xsputn(const char*, std::streamsize length) override
+            {
+                m_size += static_cast<std::size_t>(length);
+                return length;
+            }
+
+        private:
+
+            std::size_t m_size = 0;
+        };
+
+        // The put area spans the unused part of the vector, which is
+        // resized ahead of the writes and shrunk back to the written bytes
+        // by finish.
+        class xvector_buffer : public std::streambuf
+        {
+        public:
+
+            explicit xvector_buffer(std::vector<char>& out)
+                : m_out(out)
+                , m_first(out.size())
+            {
+                grow(m_first, min_growth);
+            }
+
+            std::size_t size() const noexcept
+            {
+                return written() - m_first;
+            }
+
+            void finish()
+            {
+                m_out.resize(written());
+                setp(nullptr, nullptr);
+            }
+
+        protected:
+
+            int_type overflow(int_type c) override
+            {
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    grow(written(), 1);
+                    *pptr() = traits_type::to_char_type(c);
+                    pbump(1);
+                }
+                return traits_type::not_eof(c);
+            }
+
+            std::streamsize xsputn(const char* s, std::streamsize length) override
+            {
+                std::size_t count = static_cast<std::size_t>(length);
+                std::size_t offset = written();
+                if (count > static_cast<std::size_t>(epptr() - pptr()))
+                {
+                    grow(offset, count);
+                }
+                if (count != 0)
+                {
+                    std::memcpy(m_out.data() + offset, s, count);
+                }
+                set_written(offset + count);
+                return length;
+            }
+
+        private:
+
+            static constexpr std::size_t min_growth = 256;
+
+            std::size_t written() const noexcept
+            {
+                return static_cast<std::size_t>(pptr() - m_out.data());
+            }
+
+            // pbump takes an int
+            void set_written(std::size_t offset)
+            {
+                char* data = m_out.data();
+                setp(data + offset, data + m_out.size());
+            }
+
+            // Resizing zeroes the new bytes, the vector grows geometrically
+            // from the bytes of the buffer rather than to its capacity.
+            void grow(std::size_t offset, std::size_t count)
+            {
+                std::size_t size = offset + std::max(count, min_growth);
+                if (size > m_out.size())
+                {
+                    m_out.resize(std::max(size, m_first + 2 * (m_out.size() - m_first)));
+                }
+                set_written(offset);
+            }
+
+            std::vector<char>& m_out;
+            std::size_t m_first;
+        };
+
+        // The span is the put area of the buffer, overflow is only called
+        // when it is full.
+        class xspan_buffer : public std::streambuf
+        {
+        public:
+
+            xspan_buffer(char* out, std::size_t capacity) noexcept
+            {
+                setp(out, out + capacity);
+            }
+
+            std::size_t size() const noexcept
+            {
+                return static_cast<std::size_t>(pptr() - pbase());
+            }
+
+        protected:
+
+            int_type overflow(int_type c) override
+            {
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    throw_too_small();
+                }
+                return traits_type::not_eof(c);
+            }
+
+            std::streamsize xsputn(const char* s, std::streamsize length) override
+            {
+                if (length > epptr() - pptr())
+                {
+                    throw_too_small();
+                }
+                if (length != 0)
+                {
+                    std::memcpy(pptr(), s, static_cast<std::size_t>(length));
+                }
+                // pbump takes an int
+                for (std::streamsize left = length; left != 0;)
+                {
+                    int step = static_cast<int>(std::min<std::streamsize>(left, std::numeric_limits<int>::max()));
+                    pbump(step);
+                    left -= step;
+                }
+                return length;
+            }
+
+        private:
+
+            [[noreturn]] static void throw_too_small()
+            {
+                throw std::length_error("xmessage_serializer: output buffer is too small");
+            }
+        };
+
+        /*****************
+         * frame writers *
+         *****************/
+
+        void write_json(const nl::json& value,
+                        message_encoding encoding,
+                        nl::json::error_handler_t error_handler,
+                        std::ostream& out)
+        {
+            switch (encoding)
+            {
+            case message_encoding::cbor:
+                nl::json::to_cbor(value, out);
+                break;
+            case message_encoding::msgpack:
+                nl::json::to_msgpack(value, out);
+                break;
+            case message_encoding::json:
+            default:
+                // Metadata and parent headers are often empty
+                if (value.is_object() && value.empty())
+                {
+                    out.write("{}", 2);
+                }
+                else if (error_handler == nl::json::error_handler_t::strict)
+                {
+                    // Same output as value.dump(), since the width of out is 0
+                    out << value;
+                }
+                else
+                {
+                    std::string dumped = value.dump(-1, ' ', false, error_handler);
+                    out.write(dumped.data(), static_cast<std::streamsize>(dumped.size()));
+                }
+                break;
+            }
+        }
+
+        void write_section(const xmessage_section& section,
+                           message_encoding encoding,
+                           nl::json::error_handler_t error_handler,
+                           std::ostream& out)
+        {
+            if (section.is_serialized() && section.encoding() == encoding)
+            {
+                const binary_buffer& bytes = section.serialized();
+                out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            }
+            else
+            {
+                write_json(section.json(), encoding, error_handler, out);
+            }
+        }
+
+        void write_header(const xmessage_header& header,
+                          message_encoding encoding,
+                          nl::json::error_handler_t error_handler,
+                          std::ostream& out)
+        {
+            if (encoding == message_encoding::json)
+            {
+                serialize_header(header, out);
+            }
+            else
+            {
+                write_json(nl::json(header), encoding, error_handler, out);
+            }
+        }
+
+        void check_frame_count(std::size_t count)
+        {
+            if (count < xmessage_serializer::frame_count)
+            {
+                throw std::invalid_argument("xmessage_serializer: a message has at least four frames, got "
+                                            + std::to_string(count));
+            }
+        }
+    }
+
+    /*******************************
+     * xbuffer_pool implementation *
+     *******************************/
+
+    struct xbuffer_pool::state
+    {
+        std::mutex m_mutex;
+        std::vector<std::vector<char>> m_buffers;
+        std::size_t m_max_buffers;
+    };
+
+    xbuffer_pool::xbuffer_pool(std::size_t max_buffers)
+        : p_state(std::make_shared<state>())
+    {
+        p_state->m_max_buffers = max_buffers;
+    }
+
+    std::vector<char> xbuffer_pool::acquire() const
+    {
+        std::lock_guard<std::mutex> lock(p_state->m_mutex);
+        if (p_state->m_buffers.empty())
+        {
+            return std::vector<char>();
+        }
+        std::vector<char> res = std::move(p_state->m_buffers.back());
+        p_state->m_buffers.pop_back();
+        return res;
+    }
+
+    binary_buffer xbuffer_pool::adopt(std::vector<char>&& data) const
+    {
+        std::weak_ptr<state> pool = p_state;
+        auto* holder = new std::vector<char>(std::move(data));
+        std::shared_ptr<std::vector<char>> owner(holder, [pool](std::vector<char>* p)
+        {
+            recycle(pool, p);
+        });
+        return binary_buffer(std::move(owner), holder->data(), holder->size());
+    }
+
+    std::size_t xbuffer_pool::available() const
+    {
+        std::lock_guard<std::mutex> lock(p_state->m_mutex);
+        return p_state->m_buffers.size();
+    }
+
+    void xbuffer_pool::recycle(const std::weak_ptr<state>& pool, std::vector<char>* data) noexcept
+    {
+        std::unique_ptr<std::vector<char>> holder(data);
+        std::shared_ptr<state> pool_state = pool.lock();
+        if (pool_state == nullptr || holder->capacity() > max_pooled_capacity)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(pool_state->m_mutex);
+        if (pool_state->m_buffers.size() < pool_state->m_max_buffers)
+        {
+            holder->clear();
+            try
+            {
+                pool_state->m_buffers.push_back(std::move(*holder));
+            }
+            catch (...)
+            {
+                // Not recycling the vector is harmless
+            }
+        }
+    }
+
+    /**************************************
+     * xmessage_serializer implementation *
+     **************************************/
+
+    xmessage_serializer::xmessage_serializer(message_encoding encoding,
+                                             xbuffer_pool pool,
+                                             nl::json::error_handler_t error_handler) noexcept
+        : m_encoding(encoding)
+        , m_pool(std::move(pool))
+        , m_error_handler(error_handler)
+    {
+    }
+
+    message_encoding xmessage_serializer::encoding() const noexcept
+    {
+        return m_encoding;
+    }
+
+    const xbuffer_pool& xmessage_serializer::pool() const noexcept
+    {
+        return m_pool;
+    }
+
+    nl::json::error_handler_t xmessage_serializer::error_handler() const noexcept
+    {
+        return m_error_handler;
+    }
+
+    // Built from a typed header, the header of a message is serialized
+    // without building its JSON value.
+    template <class B>
+    auto xmessage_serializer::write_frames(const xmessage_base& message, B& buffer) const -> frame_sizes
+    {
+        // Constructing a stream initializes its locale, one stream is
+        // kept per thread and bound to the buffer of each call. Errors of
+        // the buffer, such as std::length_error, are rethrown by the
+        // stream.
+        thread_local std::ostream out(nullptr);
+        out.rdbuf(&buffer);
+        out.exceptions(std::ios_base::badbit);
+        struct unbind
+        {
+            std::ostream& m_out;
+
+            // Unbinding sets badbit, which must not throw
+            ~unbind()
+            {
+                m_out.exceptions(std::ios_base::goodbit);
+                m_out.rdbuf(nullptr);
+            }
+        } unbind_buffer{out};
+
+        frame_sizes res;
+        std::size_t offset = buffer.size();
+        auto end_frame = [&res, &offset, &buffer](std::size_t i)
+        {
+            res[i] = buffer.size() - offset;
+            offset = buffer.size();
+        };
+
+        if (message.m_header_pending)
+        {
+            write_header(*message.m_typed_header, m_encoding, m_error_handler, out);
+        }
+        else
+        {
+            write_section(message.m_header, m_encoding, m_error_handler, out);
+        }
+        end_frame(0);
+        write_section(message.parent_header_section(), m_encoding, m_error_handler, out);
+        end_frame(1);
+        write_section(message.metadata_section(), m_encoding, m_error_handler, out);
+        end_frame(2);
+        write_section(message.content_section(), m_encoding, m_error_handler, out);
+        end_frame(3);
+        return res;
+    }
+
+    auto xmessage_serializer::sizes(const xmessage_base& message) const -> frame_sizes
+    {
+        xcounting_buffer buffer;
+        return write_frames(message, buffer);
+    }
+
+    auto xmessage_serializer::serialize(const xmessage_base& message, std::vector<char>& out) const -> frame_sizes
+    {
+        xvector_buffer buffer(out);
+        try
+        {
+            frame_sizes res = write_frames(message, buffer);
+            buffer.finish();
+            return res;
+        }
+        catch (...)
+        {
+            buffer.finish();
+            throw;
+        }
+    }
+
+    auto xmessage_serializer::serialize(const xmessage_base& message,
+                                        char* out,
+                                        std::size_t capacity) const -> frame_sizes
+    {
+        xspan_buffer buffer(out, capacity);
+        return write_frames(message, buffer);
+    }
+
+    xmessage_serialized_data xmessage_serializer::serialize(const xmessage_base& message) const
+    {
+        std::vector<char> out = m_pool.acquire();
+        frame_sizes frames = serialize(message, out);
+        bool streamed = std::any_of(message.m_chunked_buffers.cbegin(),
+                                    message.m_chunked_buffers.cend(),
+                                    [](const xchunked_buffer& buffer) { return buffer.is_streamed(); });
+        if (streamed)
+        {
+            return deserialize(m_pool.adopt(std::move(out)), frames, message.buffers());
+        }
+        xmessage_serialized_data res = deserialize(m_pool.adopt(std::move(out)), frames, message.m_buffers);
+        res.m_chunked_buffers = message.m_chunked_buffers;
+        return res;
+    }
+
+    xmessage_serialized_data xmessage_serializer::serialize(xmessage_base&& message) const
+    {
+        std::vector<char> out = m_pool.acquire();
+        frame_sizes frames = serialize(message, out);
+        xmessage_serialized_data res = deserialize(m_pool.adopt(std::move(out)), frames, std::move(message.m_buffers));
+        res.m_chunked_buffers = std::move(message.m_chunked_buffers);
+        return res;
+    }
+
+    xmessage_serialized_data xmessage_serializer::deserialize(buffer_sequence frames) const
+    {
+        check_frame_count(frames.size());
+        xmessage_serialized_data res;
+        res.m_header = std::move(frames[0]);
+        res.m_parent_header = std::move(frames[1]);
+        res.m_metadata = std::move(frames[2]);
+        res.m_content = std::move(frames[3]);
+        frames.erase(frames.begin(), frames.begin() + frame_count);
+        res.m_buffers = std::move(frames);
+        res.m_encoding = m_encoding;
+        return res;
+    }
+
+    xmessage_serialized_data xmessage_serializer::deserialize(const binary_buffer& data,
+                                                              const frame_sizes& sizes,
+                                                              buffer_sequence buffers) const
+    {
+        std::size_t total = 0;
+        for (std::size_t size : sizes)
+        {
+            total += size;
+        }
+        if (total > data.size())
+        {
+            throw std::invalid_argument("xmessage_serializer: frame sizes exceed the size of the data");
+        }
+
+        xmessage_serialized_data res;
+        std::size_t offset = 0;
+        binary_buffer* frames[frame_count] = { &res.m_header, &res.m_parent_header, &res.m_metadata, &res.m_content };
+        for (std::size_t i = 0; i < frame_count; ++i)
+        {
+            *frames[i] = data.slice(offset, sizes[i]);
+            offset += sizes[i];
+        }
+        res.m_buffers = std::move(buffers);
+        res.m_encoding = m_encoding;
+        return res;
+    }
+}
@@ -0,0 +1,628 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "xeus/xjson.hpp"
+
+#include "xeus/xrequest_content.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    namespace
+    {
+        /*****************
+         * field setters *
+         *****************/
+
+        // Values decoded from a parsed section are copied, values decoded
+        // from serialized bytes are moved.
+
+        template <class T>
+        void assign(T& field, const nl::json& value)
+        {
+            value.get_to(field);
+        }
+
+        void assign(std::string& field, const nl::json& value)
+        {
+            field = value.get_ref<const std::string&>();
+        }
+
+        void assign(std::string& field, nl::json&& value)
+        {
+            field = std::move(value.get_ref<std::string&>());
+        }
+
+        void assign(nl::json& field, const nl::json& value)
+        {
+            field = value;
+        }
+
+        void assign(nl::json& field, nl::json&& value)
+        {
+            field = std::move(value);
+        }
+
+        // content_fields<T>::names lists the fields of T in the order of
+        // the indices handled by set_field. The values of other fields are
+        // skipped without being built nor type-checked.
+        template <class T>
+        struct content_fields;
+
+        template <class T>
+        std::size_t field_index(std::string_view key)
+        {
+            const auto& names = content_fields<T>::names;
+            std::size_t index = 0;
+            while (index < names.size() && names[index] != key)
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        template <class T>
+        bool is_field(std::size_t index)
+        {
+            return index < content_fields<T>::names.size();
+        }
+
+        template <>
+        struct content_fields<execute_request_content>
+        {
+            static constexpr std::array<std::string_view, 6> names = {
+                "code", "silent", "store_history", "user_expressions", "allow_stdin", "stop_on_error"
+            };
+        };
+
+        template <class J>
+        void set_field(execute_request_content& content, std::size_t index, J&& value)
+        {
+            switch (index)
+            {
+            case 0:
+                assign(content.m_code, std::forward<J>(value));
+                break;
+            case 1:
+                assign(content.m_silent, std::forward<J>(value));
+                break;
+            case 2:
+                assign(content.m_store_history, std::forward<J>(value));
+                break;
+            case 3:
+                assign(content.m_user_expressions, std::forward<J>(value));
+                break;
+            case 4:
+                assign(content.m_allow_stdin, std::forward<J>(value));
+                break;
+            case 5:
+                assign(content.m_stop_on_error, std::forward<J>(value));
+                break;
+            default:
+                break;
+            }
+        }
+
+        template <>
+        struct content_fields<complete_request_content>
+        {
+            static constexpr std::array<std::string_view, 2> names = { "code", "cursor_pos" };
+        };
+
+        template <class J>
+        void set_field(complete_request_content& content, std::size_t index, J&& value)
+        {
+            switch (index)
+            {
+            case 0:
+                assign(content.m_code, std::forward<J>(value));
+                break;
+            case 1:
+                assign(content.m_cursor_pos, std::forward<J>(value));
+                break;
+            default:
+                break;
+            }
+        }
+
+        template <>
+        struct content_fields<inspect_request_content>
+        {
+            static constexpr std::array<std::string_view, 3> names = { "code", "cursor_pos", "detail_level" };
+        };
+
+        template <class J>
+        void set_field(inspect_request_content& content, std::size_t index, J&& value)
+        {
+            switch (index)
+            {
+            case 0:
+                assign(content.m_code, std::forward<J>(value));
+                break;
+            case 1:
+                assign(content.m_cursor_pos, std::forward<J>(value));
+                break;
+            case 2:
+                assign(content.m_detail_level, std::forward<J>(value));
+                break;
+            default:
+                break;
+            }
+        }
+
+        template <>
+        struct content_fields<is_complete_request_content>
+        {
+            static constexpr std::array<std::string_view, 1> names = { "code" };
+        };
+
+        template <class J>
+        void set_field(is_complete_request_content& content, std::size_t index, J&& value)
+        {
+            if (index == 0)
+            {
+                assign(content.m_code, std::forward<J>(value));
+            }
+        }
+
+        template <>
+        struct content_fields<history_request_content>
+        {
+            static constexpr std::array<std::string_view, 9> names = {
+                "hist_access_type", "output", "raw", "session", "start", "stop", "n", "pattern", "unique"
+            };
+        };
+
+        template <class J>
+        void set_field(history_request_content& content, std::size_t index, J&& value)
+        {
+            switch (index)
+            {
+            case 0:
+                assign(content.m_hist_access_type, std::forward<J>(value));
+                break;
+            case 1:
+                assign(content.m_output, std::forward<J>(value));
+                break;
+            case 2:
+                assign(content.m_raw, std::forward<J>(value));
+                break;
+            case 3:
+                assign(content.m_session, std::forward<J>(value));
+                break;
+            case 4:
+                assign(content.m_start, std::forward<J>(value));
+                break;
+            case 5:
+                assign(content.m_stop, std::forward<J>(value));
+                break;
+            case 6:
+                assign(content.m_n, std::forward<J>(value));
+                break;
+            case 7:
+                assign(content.m_pattern, std::forward<J>(value));
+                break;
+            case 8:
+                assign(content.m_unique, std::forward<J>(value));
+                break;
+            default:
+                break;
+            }
+        }
+
+        /*
+         * The fields of a history request that are read depend on its
+         * access type, which may come after them in the content. Values
+         * with an unexpected type are kept aside while decoding, and only
+         * rejected by check_fields if the access type reads them.
+         */
+        struct history_fields
+        {
+            history_request_content& m_content;
+            std::vector<std::pair<std::size_t, nl::json>> m_rejected;
+        };
+
+        template <>
+        struct content_fields<history_fields> : content_fields<history_request_content>
+        {
+        };
+
+        template <class J>
+        void set_field(history_fields& fields, std::size_t index, J&& value)
+        {
+            try
+            {
+                set_field(fields.m_content, index, value);
+            }
+            catch (nl::json::type_error&)
+            {
+                fields.m_rejected.emplace_back(index, std::forward<J>(value));
+            }
+        }
+
+        bool is_read(const history_request_content& content, std::size_t index)
+        {
+            std::string_view name = content_fields<history_request_content>::names[index];
+            const std::string& type = content.m_hist_access_type;
+            bool common = name == "hist_access_type" || name == "raw" || name == "output";
+            if (type == "tail")
+            {
+                return common || name == "n";
+            }
+            else if (type == "search")
+            {
+                return common || name == "pattern" || name == "n" || name == "unique";
+            }
+            else if (type == "range")
+            {
+                return common || name == "session" || name == "start" || name == "stop";
+            }
+            return name == "hist_access_type";
+        }
+
+        void check_fields(history_fields& fields)
+        {
+            for (auto& rejected : fields.m_rejected)
+            {
+                if (is_read(fields.m_content, rejected.first))
+                {
+                    // Throws the type error of the value
+                    set_field(fields.m_content, rejected.first, std::move(rejected.second));
+                }
+            }
+        }
+
+        /****************************
+         * xcontent_sax declaration *
+         ****************************/
+
+        /*
+         * SAX handler decoding the fields of a JSON object. Only the values
+         * of the fields listed in content_fields are built, and handed over
+         * to set_field as soon as they are complete; the values of other
+         * fields are skipped.
+         */
+        template <class T>
+        class xcontent_sax
+        {
+        public:
+
+            explicit xcontent_sax(T& content);
+
+            bool null();
+            bool boolean(bool value);
+            bool number_integer(std::int64_t value);
+            bool number_unsigned(std::uint64_t value);
+            bool number_float(double value, const std::string&);
+            bool string(std::string& value);
+            bool binary(nl::json::binary_t& value);
+
+            bool start_object(std::size_t);
+            bool key(std::string& value);
+            bool end_object();
+            bool start_array(std::size_t);
+            bool end_array();
+
+            template <class E>
+            bool parse_error(std::size_t, const std::string&, const E& error);
+
+        private:
+
+            bool skipping() const noexcept;
+            bool add_value(nl::json&& value);
+            bool start_container(nl::json&& value);
+            bool end_container();
+            nl::json* insert(nl::json&& value);
+
+            T& m_content;
+            bool m_in_object;
+            std::size_t m_field;
+            std::size_t m_skip_depth;
+            std::string m_key;
+            nl::json m_value;
+            std::vector<nl::json*> m_stack;
+        };
+
+        /*******************************
+         * xcontent_sax implementation *
+         *******************************/
+
+        template <class T>
+        xcontent_sax<T>::xcontent_sax(T& content)
+            : m_content(content)
+            , m_in_object(false)
+            , m_field(0)
+            , m_skip_depth(0)
+        {
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::null()
+        {
+            return add_value(nl::json(nullptr));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::boolean(bool value)
+        {
+            return add_value(nl::json(value));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::number_integer(std::int64_t value)
+        {
+            return add_value(nl::json(value));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::number_unsigned(std::uint64_t value)
+        {
+            return add_value(nl::json(value));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::number_float(double value, const std::string&)
+        {
+            return add_value(nl::json(value));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::string(std::string& value)
+        {
+            return add_value(nl::json(std::move(value)));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::binary(nl::json::binary_t& value)
+        {
+            return add_value(nl::json::binary(std::move(value)));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::start_object(std::size_t)
+        {
+            return start_container(nl::json::object());
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::key(std::string& value)
+        {
+            if (m_skip_depth != 0)
+            {
+                return true;
+            }
+            if (m_stack.empty())
+            {
+                m_field = field_index<T>(value);
+            }
+            else
+            {
+                m_key = std::move(value);
+            }
+            return true;
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::end_object()
+        {
+            return end_container();
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::start_array(std::size_t)
+        {
+            return start_container(nl::json::array());
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::end_array()
+        {
+            return end_container();
+        }
+
+        template <class T>
+        template <class E>
+        bool xcontent_sax<T>::parse_error(std::size_t, const std::string&, const E& error)
+        {
+            throw error;
+        }
+
+        // True while the value of a field that is not decoded is parsed
+        template <class T>
+        bool xcontent_sax<T>::skipping() const noexcept
+        {
+            return m_skip_depth != 0 || (m_stack.empty() && m_in_object && !is_field<T>(m_field));
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::add_value(nl::json&& value)
+        {
+            if (skipping())
+            {
+                return true;
+            }
+            bool is_field = m_stack.empty() && m_in_object;
+            insert(std::move(value));
+            if (is_field)
+            {
+                set_field(m_content, m_field, std::move(m_value));
+            }
+            return true;
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::start_container(nl::json&& value)
+        {
+            if (skipping())
+            {
+                ++m_skip_depth;
+            }
+            else if (m_stack.empty() && !m_in_object && value.is_object())
+            {
+                // The decoded object itself
+                m_in_object = true;
+            }
+            else
+            {
+                m_stack.push_back(insert(std::move(value)));
+            }
+            return true;
+        }
+
+        template <class T>
+        bool xcontent_sax<T>::end_container()
+        {
+            if (m_skip_depth != 0)
+            {
+                --m_skip_depth;
+            }
+            else if (!m_stack.empty())
+            {
+                m_stack.pop_back();
+                if (m_stack.empty() && m_in_object)
+                {
+                    set_field(m_content, m_field, std::move(m_value));
+                }
+            }
+            return true;
+        }
+
+        template <class T>
+        nl::json* xcontent_sax<T>::insert(nl::json&& value)
+        {
+            if (m_stack.empty())
+            {
+                m_value = std::move(value);
+                return &m_value;
+            }
+            nl::json* parent = m_stack.back();
+            if (parent->is_object())
+            {
+                nl::json& res = (*parent)[m_key];
+                res = std::move(value);
+                return &res;
+            }
+            parent->push_back(std::move(value));
+            return &(parent->back());
+        }
+
+        /**************************
+         * generic implementation *
+         **************************/
+
+        template <class T>
+        void decode_json(const nl::json& json, T& content)
+        {
+            if (!json.is_object())
+            {
+                return;
+            }
+            for (auto it = json.cbegin(); it != json.cend(); ++it)
+            {
+                std::size_t index = field_index<T>(it.key());
+                if (is_field<T>(index))
+                {
+                    set_field(content, index, it.value());
+                }
+            }
+        }
+
+        nl::json::input_format_t input_format(message_encoding encoding) noexcept
+        {
+            switch (encoding)
+            {
+            case message_encoding::cbor:
+                return nl::json::input_format_t::cbor;
+            case message_encoding::msgpack:
+                return nl::json::input_format_t::msgpack;
+            case message_encoding::json:
+            default:
+                return nl::json::input_format_t::json;
+            }
+        }
+
+        template <class T>
+        void decode_section(const xmessage_section& section, T& content)
+        {
+            if (section.is_parsed())
+            {
+                decode_json(section.json(), content);
+            }
+            else if (!section.serialized().empty())
+            {
+                const binary_buffer& buffer = section.serialized();
+                xcontent_sax<T> sax(content);
+                nl::json::sax_parse(buffer.begin(), buffer.end(), &sax, input_format(section.encoding()));
+            }
+        }
+    }
+
+    void decode_content(const xmessage_section& section, execute_request_content& content)
+    {
+        decode_section(section, content);
+    }
+
+    void decode_content(const xmessage_section& section, complete_request_content& content)
+    {
+        decode_section(section, content);
+    }
+
+    void decode_content(const xmessage_section& section, inspect_request_content& content)
+    {
+        decode_section(section, content);
+    }
+
+    void decode_content(const xmessage_section& section, is_complete_request_content& content)
+    {
+        decode_section(section, content);
+    }
+
+    void decode_content(const xmessage_section& section, history_request_content& content)
+    {
+        history_fields fields{ content, {} };
+        decode_section(section, fields);
+        check_fields(fields);
+    }
+
+    void decode_content(const nl::json& json, execute_request_content& content)
+    {
+        decode_json(json, content);
+    }
+
+    void decode_content(const nl::json& json, complete_request_content& content)
+    {
+        decode_json(json, content);
+    }
+
+    void decode_content(const nl::json& json, inspect_request_content& content)
+    {
+        decode_json(json, content);
+    }
+
+    void decode_content(const nl::json& json, is_complete_request_content& content)
+    {
+        decode_json(json, content);
+    }
+
+    void decode_content(const nl::json& json, history_request_content& content)
+    {
+        history_fields fields{ content, {} };
+        decode_json(json, fields);
+        check_fields(fields);
+    }
+}
@@ -13,6 +13,11 @@
 
 namespace xeus
 {
+    xserver::xserver(nl::json::error_handler_t error_handler)
+        : m_serializer(message_encoding::json, xbuffer_pool(), error_handler)
+    {
+    }
+
     xcontrol_messenger& xserver::get_control_messenger()
     {
         return get_control_messenger_impl();
@@ -83,6 +88,21 @@ namespace xeus
         m_internal_listener = l;
     }
 
+    void xserver::set_message_encoding(message_encoding encoding) noexcept
+    {
+        m_serializer = xmessage_serializer(encoding, m_serializer.pool(), m_serializer.error_handler());
+    }
+
+    message_encoding xserver::get_message_encoding() const noexcept
+    {
+        return m_serializer.encoding();
+    }
+
+    const xmessage_serializer& xserver::get_message_serializer() const noexcept
+    {
+        return m_serializer;
+    }
+
     void xserver::notify_shell_listener(xmessage msg)
     {
         m_shell_listener(std::move(msg));
@@ -0,0 +1,918 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "xeus/xstring_utils.hpp"
+
+#include "xcpu_features.hpp"
+
+#if defined(XEUS_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace xeus
+{
+    namespace
+    {
+        using byte = unsigned char;
+
+        // Two digits per byte value
+        constexpr std::array<char, 512> make_encode_table() noexcept
+        {
+            constexpr char digits[] = "0123456789abcdef";
+            std::array<char, 512> res = {};
+            for (std::size_t i = 0; i < 256; ++i)
+            {
+                res[2 * i] = digits[i >> 4];
+                res[2 * i + 1] = digits[i & 0xF];
+            }
+            return res;
+        }
+
+        // Value of each hexadecimal digit, -1 for other characters
+        constexpr std::array<std::int8_t, 256> make_decode_table() noexcept
+        {
+            std::array<std::int8_t, 256> res = {};
+            for (std::size_t i = 0; i < 256; ++i)
+            {
+                res[i] = -1;
+            }
+            for (std::size_t i = 0; i < 10; ++i)
+            {
+                res['0' + i] = static_cast<std::int8_t>(i);
+            }
+            for (std::size_t i = 0; i < 6; ++i)
+            {
+                res['a' + i] = static_cast<std::int8_t>(10 + i);
+                res['A' + i] = static_cast<std::int8_t>(10 + i);
+            }
+            return res;
+        }
+
+        constexpr std::array<char, 512> encode_table = make_encode_table();
+        constexpr std::array<std::int8_t, 256> decode_table = make_decode_table();
+
+        void encode_scalar(const byte* src, std::size_t size, char* out) noexcept
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const char* digits = encode_table.data() + 2 * src[i];
+                out[2 * i] = digits[0];
+                out[2 * i + 1] = digits[1];
+            }
+        }
+
+        bool decode_scalar(const char* src, std::size_t size, byte* out) noexcept
+        {
+            // size is even
+            for (std::size_t i = 0; i < size; i += 2)
+            {
+                int high = decode_table[static_cast<byte>(src[i])];
+                int low = decode_table[static_cast<byte>(src[i + 1])];
+                if ((high | low) < 0)
+                {
+                    return false;
+                }
+                out[i / 2] = static_cast<byte>((high << 4) | low);
+            }
+            return true;
+        }
+
+#ifdef XEUS_SSE2
+
+        /***********************
+         * SSE2 implementation *
+         ***********************/
+
+        // Converts bytes holding values in [0, 15] to their digit
+        __m128i nibbles_to_digits(__m128i nibbles) noexcept
+        {
+            __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+            __m128i res = _mm_add_epi8(nibbles, _mm_set1_epi8('0'));
+            return _mm_add_epi8(res, _mm_and_si128(letters, _mm_set1_epi8('a' - '0' - 10)));
+        }
+
+        // Converts digits to their values; invalid is set to 0xFF in the
+        // lanes of characters that are not digits
+        __m128i digits_to_nibbles(__m128i chars, __m128i& invalid) noexcept
+        {
+            __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+            __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+            __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+            letter = _mm_add_epi8(letter, _mm_set1_epi8(10));
+            invalid = _mm_or_si128(invalid, _mm_xor_si128(_mm_or_si128(is_digit, is_letter), _mm_set1_epi8(-1)));
+            return _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_letter, letter));
+        }
+
+        // Combines the pairs of nibbles in 16-bit lanes, the first one
+        // being the high nibble
+        __m128i combine_nibbles(__m128i nibbles) noexcept
+        {
+            __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0xFF)), 4);
+            return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+        }
+
+        void encode_sse2(const byte* src, std::size_t size, char* out) noexcept
+        {
+            const __m128i mask = _mm_set1_epi8(0xF);
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+                __m128i low = _mm_and_si128(v, mask);
+                __m128i* dst = reinterpret_cast<__m128i*>(out + 2 * i);
+                _mm_storeu_si128(dst, nibbles_to_digits(_mm_unpacklo_epi8(high, low)));
+                _mm_storeu_si128(dst + 1, nibbles_to_digits(_mm_unpackhi_epi8(high, low)));
+            }
+            encode_scalar(src + i, size - i, out + 2 * i);
+        }
+
+        bool decode_sse2(const char* src, std::size_t size, byte* out) noexcept
+        {
+            __m128i invalid = _mm_setzero_si128();
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32)
+            {
+                const __m128i* chars = reinterpret_cast<const __m128i*>(src + i);
+                __m128i first = combine_nibbles(digits_to_nibbles(_mm_loadu_si128(chars), invalid));
+                __m128i second = combine_nibbles(digits_to_nibbles(_mm_loadu_si128(chars + 1), invalid));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2), _mm_packus_epi16(first, second));
+            }
+            if (_mm_movemask_epi8(invalid) != 0)
+            {
+                return false;
+            }
+            return decode_scalar(src + i, size - i, out + i / 2);
+        }
+
+#endif
+
+#ifdef XEUS_RUNTIME_DISPATCH
+
+        /***********************
+         * AVX2 implementation *
+         ***********************/
+
+        XEUS_TARGET("avx2")
+        __m256i nibbles_to_digits_avx2(__m256i nibbles) noexcept
+        {
+            __m256i letters = _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9));
+            __m256i res = _mm256_add_epi8(nibbles, _mm256_set1_epi8('0'));
+            return _mm256_add_epi8(res, _mm256_and_si256(letters, _mm256_set1_epi8('a' - '0' - 10)));
+        }
+
+        XEUS_TARGET("avx2")
+        __m256i digits_to_nibbles_avx2(__m256i chars, __m256i& invalid) noexcept
+        {
+            __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+            __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+            __m256i letter = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+            letter = _mm256_add_epi8(letter, _mm256_set1_epi8(10));
+            invalid = _mm256_or_si256(invalid, _mm256_xor_si256(_mm256_or_si256(is_digit, is_letter), _mm256_set1_epi8(-1)));
+            return _mm256_or_si256(_mm256_and_si256(is_digit, digit), _mm256_and_si256(is_letter, letter));
+        }
+
+        XEUS_TARGET("avx2")
+        __m256i combine_nibbles_avx2(__m256i nibbles) noexcept
+        {
+            __m256i high = _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0xFF)), 4);
+            return _mm256_or_si256(high, _mm256_srli_epi16(nibbles, 8));
+        }
+
+        XEUS_TARGET("avx2")
+        void encode_avx2(const byte* src, std::size_t size, char* out) noexcept
+        {
+            const __m256i mask = _mm256_set1_epi8(0xF);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), mask);
+                __m256i low = _mm256_and_si256(v, mask);
+                // Unpacking works within 128-bit lanes, the first result
+                // holds the digits of bytes 0-7 and 16-23, the second one
+                // those of bytes 8-15 and 24-31
+                __m256i first = nibbles_to_digits_avx2(_mm256_unpacklo_epi8(high, low));
+                __m256i second = nibbles_to_digits_avx2(_mm256_unpackhi_epi8(high, low));
+                __m256i* dst = reinterpret_cast<__m256i*>(out + 2 * i);
+                _mm256_storeu_si256(dst, _mm256_permute2x128_si256(first, second, 0x20));
+                _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(first, second, 0x31));
+            }
+            // The SSE2 code is not VEX encoded, and would be slowed down
+            // by the dirty upper halves of the registers
+            _mm256_zeroupper();
+            encode_sse2(src + i, size - i, out + 2 * i);
+        }
+
+        XEUS_TARGET("avx2")
+        bool decode_avx2(const char* src, std::size_t size, byte* out) noexcept
+        {
+            __m256i invalid = _mm256_setzero_si256();
+            std::size_t i = 0;
+            for (; i + 64 <= size; i += 64)
+            {
+                const __m256i* chars = reinterpret_cast<const __m256i*>(src + i);
+                __m256i first = combine_nibbles_avx2(digits_to_nibbles_avx2(_mm256_loadu_si256(chars), invalid));
+                __m256i second = combine_nibbles_avx2(digits_to_nibbles_avx2(_mm256_loadu_si256(chars + 1), invalid));
+                // Packing works within 128-bit lanes too
+                __m256i res = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 2), res);
+            }
+            if (_mm256_movemask_epi8(invalid) != 0)
+            {
+                return false;
+            }
+            _mm256_zeroupper();
+            return decode_sse2(src + i, size - i, out + i / 2);
+        }
+
+#endif
+
+        /***************************
+         * Scalar character search *
+         ***************************/
+
+        constexpr std::size_t npos = std::string::npos;
+
+        // Returns the position of the first (or last, if reverse is true)
+        // byte of data that is in set (or not in set, if negate is true)
+        std::size_t search_scalar(const byte* data, std::size_t size,
+                                  const byte* set, std::size_t set_size,
+                                  bool negate, bool reverse) noexcept
+        {
+            std::array<bool, 256> member = {};
+            for (std::size_t i = 0; i < set_size; ++i)
+            {
+                member[set[i]] = true;
+            }
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                std::size_t pos = reverse ? size - 1 - i : i;
+                if (member[data[pos]] != negate)
+                {
+                    return pos;
+                }
+            }
+            return npos;
+        }
+
+#ifdef XEUS_SSE2
+
+        // Positions of the lowest and highest bits of a non-zero mask
+        std::size_t lowest_bit(uint32_t mask) noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long res;
+            _BitScanForward(&res, mask);
+            return res;
+#else
+            return static_cast<std::size_t>(__builtin_ctz(mask));
+#endif
+        }
+
+        std::size_t highest_bit(uint32_t mask) noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long res;
+            _BitScanReverse(&res, mask);
+            return res;
+#else
+            return static_cast<std::size_t>(31 - __builtin_clz(mask));
+#endif
+        }
+
+        /*************************
+         * SSE2 character search *
+         *************************/
+
+        // Sets are matched with a comparison per character; larger sets
+        // are searched by the scalar implementation
+        constexpr std::size_t max_sse2_set_size = 16;
+
+        // Mask of the bytes of the 16 bytes at p that are in the set
+        uint32_t match_sse2(const byte* p, const __m128i* chars, std::size_t count) noexcept
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i res = _mm_setzero_si128();
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                res = _mm_or_si128(res, _mm_cmpeq_epi8(v, chars[k]));
+            }
+            return static_cast<uint32_t>(_mm_movemask_epi8(res));
+        }
+
+        std::size_t search_sse2(const byte* data, std::size_t size,
+                                const byte* set, std::size_t set_size,
+                                bool negate, bool reverse) noexcept
+        {
+            constexpr std::size_t block = 16;
+            if (set_size > max_sse2_set_size)
+            {
+                return search_scalar(data, size, set, set_size, negate, reverse);
+            }
+            __m128i chars[max_sse2_set_size];
+            for (std::size_t k = 0; k < set_size; ++k)
+            {
+                chars[k] = _mm_set1_epi8(static_cast<char>(set[k]));
+            }
+            const uint32_t flip = negate ? 0xFFFFu : 0u;
+
+            if (size < block)
+            {
+                // Copied to a full block, so that no byte is read past the end
+                byte buffer[block] = {};
+                std::memcpy(buffer, data, size);
+                uint32_t mask = (match_sse2(buffer, chars, set_size) ^ flip) & ((1u << size) - 1);
+                return mask == 0 ? npos : (reverse ? highest_bit(mask) : lowest_bit(mask));
+            }
+
+            // The remaining bytes are searched in a block that overlaps
+            // the last (or first) one
+            std::size_t rest = size % block;
+            if (!reverse)
+            {
+                for (std::size_t i = 0; i + block <= size; i += block)
+                {
+                    uint32_t mask = match_sse2(data + i, chars, set_size) ^ flip;
+                    if (mask != 0)
+                    {
+                        return i + lowest_bit(mask);
+                    }
+                }
+                if (rest == 0)
+                {
+                    return npos;
+                }
+                uint32_t mask = (match_sse2(data + size - block, chars, set_size) ^ flip) >> (block - rest);
+                return mask == 0 ? npos : size - rest + lowest_bit(mask);
+            }
+            else
+            {
+                for (std::size_t i = size; i >= block; i -= block)
+                {
+                    uint32_t mask = match_sse2(data + i - block, chars, set_size) ^ flip;
+                    if (mask != 0)
+                    {
+                        return i - block + highest_bit(mask);
+                    }
+                }
+                if (rest == 0)
+                {
+                    return npos;
+                }
+                uint32_t mask = (match_sse2(data, chars, set_size) ^ flip) & ((1u << rest) - 1);
+                return mask == 0 ? npos : highest_bit(mask);
+            }
+        }
+
+#endif
+
+#ifdef XEUS_RUNTIME_DISPATCH
+
+        /*************************
+         * AVX2 character search *
+         *************************/
+
+        // Sets of any size are matched with lookups in two tables indexed
+        // by the low nibble of the characters. Bit h of entry l of the low
+        // table is set if the character (h << 4) | l is in the set, for h
+        // in [0, 8); the high table holds the characters whose high nibble
+        // is in [8, 16).
+        XEUS_TARGET("avx2")
+        uint32_t match_avx2(const byte* p, __m256i low_table, __m256i high_table) noexcept
+        {
+            const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                                  1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            // Shuffling gives 0 for indices with the highest bit set
+            __m256i row = _mm256_or_si256(_mm256_shuffle_epi8(low_table, v),
+                                          _mm256_shuffle_epi8(high_table, _mm256_xor_si256(v, _mm256_set1_epi8(-128))));
+            __m256i high_nibble = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0xF));
+            __m256i bit = _mm256_shuffle_epi8(bits, high_nibble);
+            __m256i match = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+            return static_cast<uint32_t>(_mm256_movemask_epi8(match));
+        }
+
+        XEUS_TARGET("avx2")
+        std::size_t search_avx2(const byte* data, std::size_t size,
+                                const byte* set, std::size_t set_size,
+                                bool negate, bool reverse) noexcept
+        {
+            constexpr std::size_t block = 32;
+            // The tables are built in registers; filling them in memory
+            // and loading them stalls on store forwarding, which costs
+            // more than searching a short string.
+            const __m128i indices = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            __m128i low = _mm_setzero_si128();
+            __m128i high = _mm_setzero_si128();
+            for (std::size_t k = 0; k < set_size; ++k)
+            {
+                byte c = set[k];
+                __m128i entry = _mm_cmpeq_epi8(indices, _mm_set1_epi8(static_cast<char>(c & 0xF)));
+                __m128i bit = _mm_and_si128(entry, _mm_set1_epi8(static_cast<char>(1u << ((c >> 4) & 7))));
+                if (c < 0x80)
+                {
+                    low = _mm_or_si128(low, bit);
+                }
+                else
+                {
+                    high = _mm_or_si128(high, bit);
+                }
+            }
+            const __m256i low_table = _mm256_broadcastsi128_si256(low);
+            const __m256i high_table = _mm256_broadcastsi128_si256(high);
+            const uint32_t flip = negate ? 0xFFFFFFFFu : 0u;
+
+            if (size < block)
+            {
+                byte buffer[block] = {};
+                std::memcpy(buffer, data, size);
+                uint32_t mask = (match_avx2(buffer, low_table, high_table) ^ flip) & ((1u << size) - 1);
+                return mask == 0 ? npos : (reverse ? highest_bit(mask) : lowest_bit(mask));
+            }
+
+            std::size_t rest = size % block;
+            if (!reverse)
+            {
+                for (std::size_t i = 0; i + block <= size; i += block)
+                {
+                    uint32_t mask = match_avx2(data + i, low_table, high_table) ^ flip;
+                    if (mask != 0)
+                    {
+                        return i + lowest_bit(mask);
+                    }
+                }
+                if (rest == 0)
+                {
+                    return npos;
+                }
+                uint32_t mask = (match_avx2(data + size - block, low_table, high_table) ^ flip) >> (block - rest);
+                return mask == 0 ? npos : size - rest + lowest_bit(mask);
+            }
+            else
+            {
+                for (std::size_t i = size; i >= block; i -= block)
+                {
+                    uint32_t mask = match_avx2(data + i - block, low_table, high_table) ^ flip;
+                    if (mask != 0)
+                    {
+                        return i - block + highest_bit(mask);
+                    }
+                }
+                if (rest == 0)
+                {
+                    return npos;
+                }
+                uint32_t mask = (match_avx2(data, low_table, high_table) ^ flip) & ((1u << rest) - 1);
+                return mask == 0 ? npos : highest_bit(mask);
+            }
+        }
+
+#endif
+
+        /***************************
+         * Scalar UTF-8 validation *
+         ***************************/
+
+        // Length of the valid UTF-8 sequence starting with the non-ASCII
+        // byte at p, or 0 if the sequence is invalid. In that case, invalid
+        // is set to the length of its maximal subpart, which is the unit of
+        // replacement recommended by the Unicode standard.
+        std::size_t utf8_sequence_length(const byte* p, std::size_t size, std::size_t& invalid) noexcept
+        {
+            // Ranges of the second byte from Table 3-7 of the standard,
+            // the following ones are in [0x80, 0xBF]
+            byte b = p[0];
+            byte low = 0x80;
+            byte high = 0xBF;
+            std::size_t length = 0;
+            if (b >= 0xC2 && b <= 0xDF)
+            {
+                length = 2;
+            }
+            else if (b >= 0xE0 && b <= 0xEF)
+            {
+                length = 3;
+                low = b == 0xE0 ? 0xA0 : low;
+                high = b == 0xED ? 0x9F : high;
+            }
+            else if (b >= 0xF0 && b <= 0xF4)
+            {
+                length = 4;
+                low = b == 0xF0 ? 0x90 : low;
+                high = b == 0xF4 ? 0x8F : high;
+            }
+            else
+            {
+                invalid = 1;
+                return 0;
+            }
+
+            std::size_t i = 1;
+            for (; i < length && i < size && p[i] >= low && p[i] <= high; ++i)
+            {
+                low = 0x80;
+                high = 0xBF;
+            }
+            if (i == length)
+            {
+                return length;
+            }
+            invalid = i;
+            return 0;
+        }
+
+        std::size_t utf8_prefix_scalar(const byte* data, std::size_t size) noexcept
+        {
+            std::size_t i = 0;
+            std::size_t invalid = 0;
+            while (i < size)
+            {
+                std::size_t length = data[i] < 0x80 ? 1 : utf8_sequence_length(data + i, size - i, invalid);
+                if (length == 0)
+                {
+                    return i;
+                }
+                i += length;
+            }
+            return size;
+        }
+
+        // Start of the last sequence that may span pos, from which the
+        // scalar validation finds the error detected in a block starting
+        // at pos
+        std::size_t utf8_resume_position(const byte* data, std::size_t pos) noexcept
+        {
+            for (std::size_t k = 1; k <= 3 && k <= pos; ++k)
+            {
+                if ((data[pos - k] & 0xC0) != 0x80)
+                {
+                    return pos - k;
+                }
+            }
+            return pos;
+        }
+
+#ifdef XEUS_SSE2
+
+        /*************************
+         * SSE2 UTF-8 validation *
+         *************************/
+
+        // ASCII blocks are skipped 16 bytes at a time, the others are
+        // validated by the scalar implementation
+        std::size_t utf8_prefix_sse2(const byte* data, std::size_t size) noexcept
+        {
+            constexpr std::size_t block = 16;
+            std::size_t i = 0;
+            std::size_t invalid = 0;
+            while (i + block <= size)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                if (_mm_movemask_epi8(v) == 0)
+                {
+                    i += block;
+                    continue;
+                }
+                // The last sequence may end past the block
+                for (std::size_t end = i + block; i < end;)
+                {
+                    std::size_t length = data[i] < 0x80 ? 1 : utf8_sequence_length(data + i, size - i, invalid);
+                    if (length == 0)
+                    {
+                        return i;
+                    }
+                    i += length;
+                }
+            }
+            return i + utf8_prefix_scalar(data + i, size - i);
+        }
+
+#endif
+
+#ifdef XEUS_RUNTIME_DISPATCH
+
+        /*************************
+         * AVX2 UTF-8 validation *
+         *************************/
+
+        // Validation with lookup tables, from "Validating UTF-8 In Less
+        // Than One Instruction Per Byte" (Keiser and Lemire, 2021). Each
+        // byte is checked with the previous one: the tables indexed by the
+        // nibbles of the pair flag the errors each nibble is compatible
+        // with, the pair is invalid if the three lookups share a flag.
+        // The expected continuation bytes of 3 and 4-byte sequences are
+        // then checked with the two and three previous bytes.
+        constexpr byte too_short = 1 << 0;     // lead byte or ASCII followed by a lead byte or ASCII
+        constexpr byte too_long = 1 << 1;      // ASCII followed by a continuation byte
+        constexpr byte overlong_3 = 1 << 2;    // 11100000 100_____
+        constexpr byte too_large = 1 << 3;     // above U+10FFFF
+        constexpr byte surrogate = 1 << 4;     // 11101101 101_____
+        constexpr byte overlong_2 = 1 << 5;    // 1100000_ 10______
+        constexpr byte too_large_1000 = 1 << 6;
+        constexpr byte overlong_4 = 1 << 6;    // 11110000 1000____
+        constexpr byte two_conts = 1 << 7;     // continuation byte followed by a continuation byte
+        constexpr byte carry = too_short | too_long | two_conts;
+
+        using utf8_table = std::array<byte, 16>;
+
+        // Indexed by the high nibble of the first byte
+        constexpr utf8_table byte_1_high = {
+            too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+            two_conts, two_conts, two_conts, two_conts,
+            too_short | overlong_2,
+            too_short,
+            too_short | overlong_3 | surrogate,
+            too_short | too_large | too_large_1000 | overlong_4
+        };
+
+        // Indexed by the low nibble of the first byte
+        constexpr utf8_table byte_1_low = {
+            carry | overlong_3 | overlong_2 | overlong_4,
+            carry | overlong_2,
+            carry,
+            carry,
+            carry | too_large,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000 | surrogate,
+            carry | too_large | too_large_1000,
+            carry | too_large | too_large_1000
+        };
+
+        // Indexed by the high nibble of the second byte
+        constexpr utf8_table byte_2_high = {
+            too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+            too_long | overlong_2 | two_conts | overlong_3 | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_long | overlong_2 | two_conts | surrogate | too_large,
+            too_short, too_short, too_short, too_short
+        };
+
+        // Bytes that start a sequence which cannot end in the block, when
+        // they are greater than the last 3 values
+        constexpr std::array<byte, 32> utf8_incomplete_limits = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+        };
+
+        XEUS_TARGET("avx2")
+        __m256i load_utf8_table(const utf8_table& table) noexcept
+        {
+            return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data())));
+        }
+
+        // Bytes of input preceded by the last N bytes of previous
+        template <int N>
+        XEUS_TARGET("avx2")
+        __m256i shift_in_avx2(__m256i input, __m256i previous) noexcept
+        {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+        }
+
+        XEUS_TARGET("avx2")
+        __m256i utf8_errors_avx2(__m256i input, __m256i previous) noexcept
+        {
+            const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+            __m256i prev1 = shift_in_avx2<1>(input, previous);
+            __m256i high_1 = _mm256_shuffle_epi8(load_utf8_table(byte_1_high),
+                                                 _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+            __m256i low_1 = _mm256_shuffle_epi8(load_utf8_table(byte_1_low), _mm256_and_si256(prev1, low_nibble));
+            __m256i high_2 = _mm256_shuffle_epi8(load_utf8_table(byte_2_high),
+                                                 _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+            __m256i pair_errors = _mm256_and_si256(_mm256_and_si256(high_1, low_1), high_2);
+
+            // The pairs of continuation bytes are flagged two_conts, which
+            // is expected after the lead bytes of 3 and 4-byte sequences
+            __m256i third = _mm256_subs_epu8(shift_in_avx2<2>(input, previous), _mm256_set1_epi8(0xE0 - 0x80));
+            __m256i fourth = _mm256_subs_epu8(shift_in_avx2<3>(input, previous), _mm256_set1_epi8(0xF0 - 0x80));
+            __m256i expected = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(-128));
+            return _mm256_xor_si256(expected, pair_errors);
+        }
+
+        XEUS_TARGET("avx2")
+        std::size_t utf8_prefix_avx2(const byte* data, std::size_t size) noexcept
+        {
+            constexpr std::size_t block = 32;
+            const __m256i limits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(utf8_incomplete_limits.data()));
+            __m256i previous = _mm256_setzero_si256();
+            __m256i incomplete = _mm256_setzero_si256();
+            std::size_t i = 0;
+            bool valid = true;
+            for (; valid && i + block <= size; i += block)
+            {
+                __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i errors = incomplete;
+                if (_mm256_movemask_epi8(input) != 0)
+                {
+                    errors = utf8_errors_avx2(input, previous);
+                    incomplete = _mm256_subs_epu8(input, limits);
+                }
+                else
+                {
+                    incomplete = _mm256_setzero_si256();
+                }
+                valid = _mm256_testz_si256(errors, errors) != 0;
+                previous = input;
+            }
+
+            if (valid)
+            {
+                // The last bytes are padded with zeros, which also reveals
+                // a truncated last sequence
+                byte buffer[block] = {};
+                std::memcpy(buffer, data + i, size - i);
+                __m256i errors = utf8_errors_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer)), previous);
+                if (_mm256_testz_si256(errors, errors) != 0)
+                {
+                    return size;
+                }
+            }
+            else
+            {
+                i -= block;
+            }
+            // The error is located by the scalar validation
+            std::size_t start = utf8_resume_position(data, i);
+            return start + utf8_prefix_scalar(data + start, size - start);
+        }
+
+#endif
+
+        using encode_function = void (*)(const byte*, std::size_t, char*) noexcept;
+        using decode_function = bool (*)(const char*, std::size_t, byte*) noexcept;
+
+        encode_function select_encode() noexcept
+        {
+#ifdef XEUS_RUNTIME_DISPATCH
+            if (cpu_has_avx2())
+            {
+                return encode_avx2;
+            }
+#endif
+#ifdef XEUS_SSE2
+            return encode_sse2;
+#else
+            return encode_scalar;
+#endif
+        }
+
+        decode_function select_decode() noexcept
+        {
+#ifdef XEUS_RUNTIME_DISPATCH
+            if (cpu_has_avx2())
+            {
+                return decode_avx2;
+            }
+#endif
+#ifdef XEUS_SSE2
+            return decode_sse2;
+#else
+            return decode_scalar;
+#endif
+        }
+
+        using search_function = std::size_t (*)(const byte*, std::size_t, const byte*, std::size_t, bool, bool) noexcept;
+
+        search_function select_search() noexcept
+        {
+#ifdef XEUS_RUNTIME_DISPATCH
+            if (cpu_has_avx2())
+            {
+                return search_avx2;
+            }
+#endif
+#ifdef XEUS_SSE2
+            return search_sse2;
+#else
+            return search_scalar;
+#endif
+        }
+
+        std::size_t search(const char* data, std::size_t size,
+                           const char* set, std::size_t set_size,
+                           bool negate, bool reverse) noexcept
+        {
+            if (size == 0)
+            {
+                return npos;
+            }
+            static const search_function f = select_search();
+            return f(reinterpret_cast<const byte*>(data), size,
+                     reinterpret_cast<const byte*>(set), set_size,
+                     negate, reverse);
+        }
+
+        using utf8_function = std::size_t (*)(const byte*, std::size_t) noexcept;
+
+        utf8_function select_utf8() noexcept
+        {
+#ifdef XEUS_RUNTIME_DISPATCH
+            if (cpu_has_avx2())
+            {
+                return utf8_prefix_avx2;
+            }
+#endif
+#ifdef XEUS_SSE2
+            return utf8_prefix_sse2;
+#else
+            return utf8_prefix_scalar;
+#endif
+        }
+    }
+
+    void hex_encode(const void* data, std::size_t size, char* out) noexcept
+    {
+        static const encode_function encode = select_encode();
+        encode(static_cast<const byte*>(data), size, out);
+    }
+
+    bool hex_decode(const char* data, std::size_t size, void* out) noexcept
+    {
+        if (size % 2 != 0)
+        {
+            return false;
+        }
+        static const decode_function decode = select_decode();
+        return decode(data, size, static_cast<byte*>(out));
+    }
+
+    std::size_t find_first_of_chars(const char* data, std::size_t size,
+                                    const char* set, std::size_t set_size) noexcept
+    {
+        return search(data, size, set, set_size, false, false);
+    }
+
+    std::size_t find_first_not_of_chars(const char* data, std::size_t size,
+                                        const char* set, std::size_t set_size) noexcept
+    {
+        return search(data, size, set, set_size, true, false);
+    }
+
+    std::size_t find_last_of_chars(const char* data, std::size_t size,
+                                   const char* set, std::size_t set_size) noexcept
+    {
+        return search(data, size, set, set_size, false, true);
+    }
+
+    std::size_t find_last_not_of_chars(const char* data, std::size_t size,
+                                       const char* set, std::size_t set_size) noexcept
+    {
+        return search(data, size, set, set_size, true, true);
+    }
+
+    std::size_t utf8_valid_prefix(const char* data, std::size_t size) noexcept
+    {
+        static const utf8_function f = select_utf8();
+        return f(reinterpret_cast<const byte*>(data), size);
+    }
+
+    bool repair_utf8(std::string& str)
+    {
+        std::size_t pos = utf8_valid_prefix(str.data(), str.size());
+        if (pos == str.size())
+        {
+            return false;
+        }
+
+        const byte* data = reinterpret_cast<const byte*>(str.data());
+        std::string res;
+        res.reserve(str.size() + 16);
+        res.append(str, 0, pos);
+        while (pos < str.size())
+        {
+            std::size_t invalid = 1;
+            utf8_sequence_length(data + pos, str.size() - pos, invalid);
+            // U+FFFD REPLACEMENT CHARACTER
+            res.append("\xEF\xBF\xBD");
+            pos += invalid;
+            std::size_t valid = utf8_valid_prefix(str.data() + pos, str.size() - pos);
+            res.append(str, pos, valid);
+            pos += valid;
+        }
+        str = std::move(res);
+        return true;
+    }
+}
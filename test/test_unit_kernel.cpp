@@ -8,14 +8,19 @@
 
 #include "doctest/doctest.h"
 
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "nlohmann/json.hpp"
 
 #include "xmock_interpreter.hpp"
 #include "xmock_server.hpp"
 
+#include "xeus/xcomm.hpp"
 #include "xeus/xkernel.hpp"
 #include "xeus/xsystem.hpp"
 #include "xeus/xeus_context.hpp"
@@ -53,6 +58,189 @@ namespace xeus
             REQUIRE_NE(pos, std::string::npos);
         }
 
+        TEST_CASE("publish_serialized_content")
+        {
+            auto context = make_mock_context();
+
+            using interpreter_ptr = std::unique_ptr<xmock_interpreter>;
+            interpreter_ptr interpreter = interpreter_ptr(new xmock_interpreter());
+            xmock_interpreter* p_interpreter = interpreter.get();
+            xkernel kernel(get_user_name(),
+                           std::move(context),
+                           std::move(interpreter),
+                           make_mock_server);
+
+            binary_buffer content(std::string(R"({"data":{"text/plain":"42"},"metadata":{},"transient":{}})"));
+            const char* bytes = content.data();
+            p_interpreter->publish_serialized_content("display_data", {{"isolated", true}}, std::move(content));
+
+            xmock_server& server = static_cast<xmock_server&>(kernel.get_server());
+            REQUIRE_EQ(server.iopub_size(), 1u);
+            xpub_message msg = server.read_iopub();
+            REQUIRE_EQ(msg.header()["msg_type"], "display_data");
+            REQUIRE_EQ(msg.metadata()["isolated"], true);
+            REQUIRE_FALSE(msg.content_section().is_parsed());
+            REQUIRE_EQ(msg.content_section().serialized().data(), bytes);
+            REQUIRE_EQ(msg.content()["data"]["text/plain"], "42");
+        }
+
+        TEST_CASE("publish_stream")
+        {
+            auto context = make_mock_context();
+
+            using interpreter_ptr = std::unique_ptr<xmock_interpreter>;
+            interpreter_ptr interpreter = interpreter_ptr(new xmock_interpreter());
+            xmock_interpreter* p_interpreter = interpreter.get();
+            xkernel kernel(get_user_name(),
+                           std::move(context),
+                           std::move(interpreter),
+                           make_mock_server);
+            xmock_server& server = static_cast<xmock_server&>(kernel.get_server());
+
+            // An rvalue is moved to the content of the message
+            std::string text(1024, 'x');
+            const char* chars = text.data();
+            p_interpreter->publish_stream("stdout", std::move(text));
+            REQUIRE_EQ(server.iopub_size(), 1u);
+            xpub_message msg = server.read_iopub();
+            REQUIRE_EQ(msg.content()["text"].get_ref<const std::string&>().data(), chars);
+
+            const char buffer[] = "line\nnext line";
+            p_interpreter->publish_stream("stderr", std::string_view(buffer, 4));
+            msg = server.read_iopub();
+            REQUIRE_EQ(msg.content()["name"], "stderr");
+            REQUIRE_EQ(msg.content()["text"], "line");
+
+            p_interpreter->publish_execution_error("NameError", "x", {"line 1", "line 2"});
+            msg = server.read_iopub();
+            REQUIRE_EQ(msg.content()["traceback"], nl::json({"line 1", "line 2"}));
+        }
+
+        TEST_CASE("publish_invalid_utf8")
+        {
+            auto context = make_mock_context();
+
+            using interpreter_ptr = std::unique_ptr<xmock_interpreter>;
+            interpreter_ptr interpreter = interpreter_ptr(new xmock_interpreter());
+            xmock_interpreter* p_interpreter = interpreter.get();
+            xkernel kernel(get_user_name(),
+                           std::move(context),
+                           std::move(interpreter),
+                           make_mock_server);
+
+            // Without the replacement, the serialization would throw
+            xmock_server& server = static_cast<xmock_server&>(kernel.get_server());
+            p_interpreter->publish_stream("stdout", "output \xFF");
+            REQUIRE_EQ(server.iopub_size(), 1u);
+            xpub_message stream = server.read_iopub();
+            REQUIRE_EQ(stream.content()["text"], "output \xEF\xBF\xBD");
+
+            p_interpreter->display_data({{"text/plain", {"\xC3"}}}, nl::json::object(), nl::json::object());
+            REQUIRE_EQ(server.iopub_size(), 1u);
+            xpub_message display = server.read_iopub();
+            REQUIRE_EQ(display.content()["data"]["text/plain"][0], "\xEF\xBF\xBD");
+        }
+
+        TEST_CASE("server_error_handler")
+        {
+            using interpreter_ptr = std::unique_ptr<xmock_interpreter>;
+            xkernel kernel(get_user_name(),
+                           make_mock_context(),
+                           interpreter_ptr(new xmock_interpreter()),
+                           make_mock_server,
+                           make_in_memory_history_manager(),
+                           nullptr,
+                           make_null_debugger,
+                           nl::json::object(),
+                           nl::json::error_handler_t::ignore);
+            const xserver& server = kernel.get_server();
+            REQUIRE_EQ(server.get_message_serializer().error_handler(), nl::json::error_handler_t::ignore);
+        }
+
+        TEST_CASE("send_chunked")
+        {
+            auto context = make_mock_context();
+
+            using interpreter_ptr = std::unique_ptr<xmock_interpreter>;
+            interpreter_ptr interpreter = interpreter_ptr(new xmock_interpreter());
+            xmock_interpreter* p_interpreter = interpreter.get();
+            xkernel kernel(get_user_name(),
+                           std::move(context),
+                           std::move(interpreter),
+                           make_mock_server);
+
+            xcomm_manager& manager = p_interpreter->comm_manager();
+            manager.register_comm_target("target", [](xcomm&&, xmessage) {});
+            xcomm comm(manager.target("target"));
+
+            int produced = 0;
+            chunked_buffer_sequence buffers;
+            buffers.emplace_back(xchunked_buffer::producer([&produced](binary_buffer& segment)
+            {
+                if (produced == 3)
+                {
+                    return false;
+                }
+                ++produced;
+                segment = binary_buffer(std::string(4, 'x'));
+                return true;
+            }));
+            comm.send_chunked(nl::json::object(), {{"x", 1}}, std::move(buffers));
+
+            // The segments are produced when the server sends the message
+            xmock_server& server = static_cast<xmock_server&>(kernel.get_server());
+            REQUIRE_EQ(server.iopub_size(), 1u);
+            xpub_message msg = server.read_iopub();
+            REQUIRE_EQ(msg.msg_type(), "comm_msg");
+            REQUIRE(msg.has_chunked_buffers());
+            REQUIRE_EQ(produced, 0);
+
+            chunked_buffer_sequence chunks = std::move(msg).chunked_buffers();
+            std::size_t size = 0;
+            binary_buffer segment;
+            while (chunks[0].next(segment))
+            {
+                size += segment.size();
+            }
+            REQUIRE_EQ(produced, 3);
+            REQUIRE_EQ(size, 12u);
+        }
+
+        TEST_CASE("guid_generator")
+        {
+            using interpreter_ptr = std::unique_ptr<xmock_interpreter>;
+            interpreter_ptr interpreter = interpreter_ptr(new xmock_interpreter());
+            xmock_interpreter* p_interpreter = interpreter.get();
+            xkernel kernel(get_user_name(),
+                           make_mock_context(),
+                           std::move(interpreter),
+                           make_mock_server,
+                           make_in_memory_history_manager(),
+                           nullptr,
+                           make_null_debugger,
+                           nl::json::object(),
+                           nl::json::error_handler_t::strict,
+                           xguid_generator::fast);
+            // The generator of a kernel does not change the process-wide one
+            REQUIRE_EQ(get_xguid_generator(), xguid_generator::system);
+
+            // Another kernel does not change the generator of the first one
+            xkernel other(get_user_name(),
+                          make_mock_context(),
+                          interpreter_ptr(new xmock_interpreter()),
+                          make_mock_server);
+            REQUIRE_EQ(get_xguid_generator(), xguid_generator::system);
+
+            xmock_server& server = static_cast<xmock_server&>(kernel.get_server());
+            p_interpreter->publish_stream("stdout", "a");
+            p_interpreter->publish_stream("stdout", "b");
+            std::string id = server.read_iopub().header()["msg_id"];
+            std::string next = server.read_iopub().header()["msg_id"];
+            // Fast ids of a thread share their prefix
+            REQUIRE_EQ(id.substr(0, 16), next.substr(0, 16));
+            REQUIRE_NE(id, next);
+        }
+
         TEST_CASE("extract_filename")
         {
             int argc = 3;
@@ -107,6 +295,117 @@ namespace xeus
             size_t expected = static_cast<std::size_t>(0xc70f6907UL);
             REQUIRE_EQ(hs, expected);
         }
+
+        TEST_CASE("status_policy")
+        {
+            auto context = make_mock_context();
+
+            using interpreter_ptr = std::unique_ptr<xmock_interpreter>;
+            interpreter_ptr interpreter = interpreter_ptr(new xmock_interpreter());
+            xmock_interpreter* p_interpreter = interpreter.get();
+            xkernel kernel(get_user_name(),
+                           std::move(context),
+                           std::move(interpreter),
+                           make_mock_server);
+            xmock_server& server = static_cast<xmock_server&>(kernel.get_server());
+            p_interpreter->comm_manager().register_comm_target("target", [](xcomm&& comm, xmessage)
+            {
+                comm.send(nl::json::object(), {{"x", 1}}, buffer_sequence());
+            });
+
+            auto send_request = [&server](const std::string& msg_type, nl::json content)
+            {
+                server.notify_shell_listener(xmessage({"id"},
+                                                      make_header(msg_type, "user", "session"),
+                                                      nl::json::object(),
+                                                      nl::json::object(),
+                                                      std::move(content),
+                                                      buffer_sequence()));
+                // comm_open has no reply
+                while (server.shell_size() != 0)
+                {
+                    server.read_shell();
+                }
+            };
+            nl::json complete_content = {{"code", "x"}, {"cursor_pos", 1}};
+            nl::json comm_open_content = {{"comm_id", std::string(new_xguid())},
+                                          {"target_name", "target"},
+                                          {"data", nl::json::object()}};
+
+            // By default, every request gets its status messages
+            send_request("complete_request", complete_content);
+            REQUIRE_EQ(server.iopub_size(), 2u);
+            REQUIRE_EQ(server.read_iopub().content()["execution_state"], "busy");
+            REQUIRE_EQ(server.read_iopub().content()["execution_state"], "idle");
+
+            xstatus_policy policy;
+            policy.m_quiet_threshold = std::chrono::hours(1);
+            policy.m_quiet_requests.push_back(message_type::comm_open);
+            kernel.set_status_policy(policy);
+
+            // A short quiet request only gets its idle status
+            send_request("complete_request", complete_content);
+            REQUIRE_EQ(server.iopub_size(), 1u);
+            xpub_message idle = server.read_iopub();
+            REQUIRE_EQ(idle.content()["execution_state"], "idle");
+            REQUIRE_EQ(idle.parent_header()["msg_type"], "complete_request");
+
+            // The busy status is published before the output of the request
+            send_request("comm_open", comm_open_content);
+            REQUIRE_EQ(server.iopub_size(), 3u);
+            xpub_message busy = server.read_iopub();
+            REQUIRE_EQ(busy.content()["execution_state"], "busy");
+            REQUIRE_EQ(busy.parent_header()["msg_type"], "comm_open");
+            REQUIRE_EQ(server.read_iopub().msg_type(), "comm_msg");
+            REQUIRE_EQ(server.read_iopub().content()["execution_state"], "idle");
+
+            // Other requests are not affected
+            send_request("kernel_info_request", nl::json::object());
+            REQUIRE_EQ(server.iopub_size(), 2u);
+        }
+
+        // Handles complete requests in more than the quiet threshold
+        class xslow_interpreter : public xmock_interpreter
+        {
+        private:
+
+            nl::json complete_request_impl(const std::string&, int cursor_pos) override
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                return create_complete_reply(nl::json::array(), cursor_pos, cursor_pos);
+            }
+        };
+
+        TEST_CASE("status_policy_late_busy")
+        {
+            using interpreter_ptr = std::unique_ptr<xslow_interpreter>;
+            xkernel kernel(get_user_name(),
+                           make_mock_context(),
+                           interpreter_ptr(new xslow_interpreter()),
+                           make_mock_server);
+            xmock_server& server = static_cast<xmock_server&>(kernel.get_server());
+
+            xstatus_policy policy;
+            policy.m_quiet_threshold = std::chrono::microseconds(500);
+            kernel.set_status_policy(policy);
+
+            std::size_t first = server.sent_messages().size();
+            server.notify_shell_listener(xmessage({"id"},
+                                                  make_header("complete_request", "user", "session"),
+                                                  nl::json::object(),
+                                                  nl::json::object(),
+                                                  nl::json({{"code", "x"}, {"cursor_pos", 1}}),
+                                                  buffer_sequence()));
+
+            // The busy status of a slow request precedes its reply
+            std::vector<std::string> sent(server.sent_messages().begin() + static_cast<std::ptrdiff_t>(first),
+                                          server.sent_messages().end());
+            std::vector<std::string> expected = {"iopub:status", "shell:complete_reply", "iopub:status"};
+            REQUIRE_EQ(sent, expected);
+            REQUIRE_EQ(server.read_iopub().content()["execution_state"], "busy");
+            REQUIRE_EQ(server.read_iopub().content()["execution_state"], "idle");
+            REQUIRE_EQ(server.read_shell().msg_type(), "complete_reply");
+        }
     }
 }
 
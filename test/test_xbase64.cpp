@@ -9,10 +9,79 @@
 
 #include "doctest/doctest.h"
 
+#include <cstddef>
+#include <string>
+
 #include "xeus/xbase64.hpp"
 
 namespace xeus
 {
+    namespace
+    {
+        std::string make_bytes(std::size_t size)
+        {
+            std::string res(size, '\0');
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                res[i] = static_cast<char>(i * 37 + 11);
+            }
+            return res;
+        }
+
+        // Former bitwise implementations, decoding up to the first
+        // character that is not in the alphabet
+        const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::string reference_encode(const std::string& input)
+        {
+            std::string output;
+            int val = 0;
+            int valb = -6;
+            for (char c : input)
+            {
+                val = (val << 8) + static_cast<unsigned char>(c);
+                valb += 8;
+                while (valb >= 0)
+                {
+                    output.push_back(alphabet[std::size_t((val >> valb) & 0x3F)]);
+                    valb -= 6;
+                }
+            }
+            if (valb > -6)
+            {
+                output.push_back(alphabet[std::size_t(((val << 8) >> (valb + 8)) & 0x3F)]);
+            }
+            while (output.size() % 4)
+            {
+                output.push_back('=');
+            }
+            return output;
+        }
+
+        std::string reference_decode(const std::string& input)
+        {
+            std::string output;
+            int val = 0;
+            int valb = -8;
+            for (char c : input)
+            {
+                std::size_t pos = alphabet.find(c);
+                if (pos == std::string::npos)
+                {
+                    break;
+                }
+                val = (val << 6) + int(pos);
+                valb += 6;
+                if (valb >= 0)
+                {
+                    output.push_back(char((val >> valb) & 0xFF));
+                    valb -= 8;
+                }
+            }
+            return output;
+        }
+    }
+
     TEST_SUITE("xbase64")
     {
         TEST_CASE("base64encode")
@@ -32,5 +101,34 @@ namespace xeus
 
             REQUIRE(decoded == expected_output);
         }
+
+        TEST_CASE("base64_round_trip")
+        {
+            // Covers the vectorized paths and their scalar tails
+            for (std::size_t size = 0; size < 300; ++size)
+            {
+                std::string bytes = make_bytes(size);
+                std::string encoded = base64encode(bytes);
+                REQUIRE_EQ(encoded.size(), base64_encoded_size(size));
+                REQUIRE_EQ(encoded, reference_encode(bytes));
+                REQUIRE_EQ(base64decode(encoded), bytes);
+            }
+        }
+
+        TEST_CASE("base64_decode_invalid")
+        {
+            // Decoding stops at the first invalid character, wherever it
+            // is in the vectorized blocks
+            std::string encoded = base64encode(make_bytes(150));
+            for (std::size_t i = 0; i < encoded.size(); ++i)
+            {
+                for (char c : {'=', '.', '-', '_', ' ', '\0', '\x80', '\xff'})
+                {
+                    std::string invalid = encoded;
+                    invalid[i] = c;
+                    REQUIRE_EQ(base64decode(invalid), reference_decode(invalid));
+                }
+            }
+        }
     }
 }
\ No newline at end of file
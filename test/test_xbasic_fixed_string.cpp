@@ -15,6 +15,14 @@ namespace xeus
     using numpy_string = xbasic_fixed_string<char, 16, buffer, string_policy::throwing_error>;
     using size_type = string_type::size_type;
 
+    using string_view_type = xbasic_string_view<char>;
+
+    // Protocol constants built at compile time
+    constexpr string_type execute_request = "execute_request";
+    constexpr string_type execute_reply = execute_request.substr(0, 8) + "reply";
+    constexpr string_view_type execute_view(execute_request.data(), 7);
+    constexpr std::size_t execute_request_hash = std::hash<string_type>()(execute_request);
+
     TEST_SUITE("xfixed_string") {
     TEST_CASE("constructors")
     {
@@ -1096,6 +1104,32 @@ namespace xeus
         REQUIRE(res != std::size_t(0));
     }
 
+    TEST_CASE("constexpr")
+    {
+        static_assert(execute_request.size() == 15, "size");
+        static_assert(execute_request == "execute_request", "comparison");
+        static_assert(execute_request != execute_reply, "comparison");
+        static_assert(execute_reply < execute_request, "comparison");
+        static_assert(execute_reply == "execute_reply", "concatenation");
+        static_assert(execute_request.find("request") == 8, "find");
+        static_assert(execute_request.rfind('e') == 12, "rfind");
+        static_assert(execute_request.find_first_of("_q") == 7, "find_first_of");
+        static_assert(execute_request.compare(0, 7, "execute") == 0, "compare");
+
+        static_assert(execute_view.size() == 7, "view size");
+        static_assert(execute_view == "execute", "view comparison");
+        static_assert(execute_view.find('u') == 4, "view find");
+        static_assert(execute_view.substr(2, 3) == "ecu", "view substr");
+
+        static_assert(std::hash<string_view_type>()(string_view_type("execute_request")) == execute_request_hash,
+                      "view hash");
+        string_type s("execute_request");
+        std::size_t h = std::hash<string_type>()(s);
+        REQUIRE_EQ(h, execute_request_hash);
+        std::string str = execute_view;
+        REQUIRE_EQ(str, "execute");
+    }
+
     TEST_CASE("limit")
     {
       using string_type = xbasic_fixed_string<char, 255, buffer | store_size, string_policy::throwing_error>;
@@ -0,0 +1,123 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xeus/xbuffer.hpp"
+#include "xeus/xchunked_buffer.hpp"
+#include "xeus/xmessage.hpp"
+
+namespace xeus
+{
+    TEST_SUITE("xbuffer")
+    {
+        TEST_CASE("from_vector")
+        {
+            std::vector<char> v = {'a', 'b', 'c'};
+            const char* ptr = v.data();
+            xbuffer b(std::move(v));
+            REQUIRE_EQ(b.size(), 3u);
+            REQUIRE_EQ(b.data(), ptr);
+            REQUIRE_EQ(std::string(b.begin(), b.end()), "abc");
+        }
+
+        TEST_CASE("copy_shares_bytes")
+        {
+            xbuffer b1(std::string("hello world"));
+            xbuffer b2 = b1;
+            REQUIRE_EQ(b1.data(), b2.data());
+            REQUIRE_EQ(b1.use_count(), 2);
+            REQUIRE(b1 == b2);
+        }
+
+        TEST_CASE("release_callback")
+        {
+            static const char bytes[] = "external";
+            int released = 0;
+            {
+                xbuffer b(bytes, sizeof(bytes) - 1, [&released](const char* p, std::size_t s)
+                {
+                    REQUIRE_EQ(p, bytes);
+                    REQUIRE_EQ(s, sizeof(bytes) - 1);
+                    ++released;
+                });
+                xbuffer b2 = b;
+                REQUIRE_EQ(b2.data(), bytes);
+                REQUIRE_EQ(released, 0);
+            }
+            REQUIRE_EQ(released, 1);
+        }
+
+        TEST_CASE("shared_owner")
+        {
+            auto owner = std::make_shared<std::vector<char>>(16, 'x');
+            xbuffer b(owner, owner->data(), owner->size());
+            REQUIRE_EQ(owner.use_count(), 2);
+            xbuffer s = b.slice(4, 100);
+            REQUIRE_EQ(s.size(), 12u);
+            REQUIRE_EQ(s.data(), owner->data() + 4);
+            REQUIRE_EQ(owner.use_count(), 3);
+            REQUIRE_THROWS_AS(b.slice(17, 1), std::out_of_range);
+        }
+
+        TEST_CASE("buffer_sequence")
+        {
+            buffer_sequence buffers;
+            buffers.push_back(std::vector<char>(1024, 'a'));
+            const char* ptr = buffers[0].data();
+            buffer_sequence copy = buffers;
+            REQUIRE_EQ(copy[0].data(), ptr);
+            REQUIRE_EQ(copy[0].size(), 1024u);
+        }
+
+        TEST_CASE("chunked_buffer")
+        {
+            xbuffer segment(std::string("abc"));
+            xchunked_buffer single(segment);
+            REQUIRE_FALSE(single.is_streamed());
+            REQUIRE_EQ(single.flatten().data(), segment.data());
+
+            xchunked_buffer chunks(std::vector<xbuffer>{ xbuffer(std::string("ab")), xbuffer(std::string("cd")) });
+            xbuffer first;
+            REQUIRE(chunks.next(first));
+            REQUIRE_EQ(std::string(first.begin(), first.end()), "ab");
+            xbuffer rest = chunks.flatten();
+            REQUIRE_EQ(std::string(rest.begin(), rest.end()), "cd");
+            REQUIRE_FALSE(chunks.next(first));
+        }
+
+        TEST_CASE("streamed_buffer")
+        {
+            // Produces 4 segments of 3 bytes, one at a time
+            int produced = 0;
+            xchunked_buffer streamed(xchunked_buffer::producer([&produced](xbuffer& segment)
+            {
+                if (produced == 4)
+                {
+                    return false;
+                }
+                segment = xbuffer(std::string(3, static_cast<char>('a' + produced++)));
+                return true;
+            }));
+            REQUIRE(streamed.is_streamed());
+            REQUIRE_EQ(produced, 0);
+
+            xbuffer segment;
+            REQUIRE(streamed.next(segment));
+            REQUIRE_EQ(produced, 1);
+            xbuffer rest = streamed.flatten();
+            REQUIRE_EQ(std::string(rest.begin(), rest.end()), "bbbcccddd");
+            REQUIRE_FALSE(streamed.is_streamed());
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xcompression.hpp"
+#include "xeus/xmessage.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    namespace
+    {
+        binary_buffer make_int_array(std::size_t count)
+        {
+            std::vector<std::int32_t> values(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                values[i] = static_cast<std::int32_t>(i % 100);
+            }
+            const char* data = reinterpret_cast<const char*>(values.data());
+            return binary_buffer(data, data + count * sizeof(std::int32_t));
+        }
+
+        binary_buffer make_noise(std::size_t size)
+        {
+            std::string res(size, '\0');
+            std::uint32_t state = 12345;
+            for (char& c : res)
+            {
+                state = state * 1103515245u + 12345u;
+                c = static_cast<char>(state >> 24);
+            }
+            return binary_buffer(std::move(res));
+        }
+    }
+
+    TEST_SUITE("xcompression")
+    {
+        TEST_CASE("lz4_round_trip")
+        {
+            std::vector<binary_buffer> inputs = {
+                binary_buffer(std::string()),
+                binary_buffer(std::string("a")),
+                binary_buffer(std::string("abcdefghijklm")),
+                binary_buffer(std::string(100000, 'x')),
+                make_int_array(10000),
+                make_noise(5000)
+            };
+            for (const binary_buffer& input : inputs)
+            {
+                binary_buffer compressed = lz4_compress(input.data(), input.size());
+                REQUIRE_LE(compressed.size(), lz4_compress_bound(input.size()));
+                binary_buffer output = lz4_decompress(compressed.data(), compressed.size(), input.size());
+                REQUIRE_EQ(output, input);
+            }
+
+            binary_buffer ints = make_int_array(10000);
+            REQUIRE_LT(lz4_compress(ints.data(), ints.size()).size() * 10, ints.size());
+        }
+
+        TEST_CASE("lz4_malformed")
+        {
+            binary_buffer input(std::string(1000, 'x'));
+            binary_buffer compressed = lz4_compress(input.data(), input.size());
+            REQUIRE_THROWS_AS(lz4_decompress(compressed.data(), compressed.size(), input.size() + 1), std::runtime_error);
+            REQUIRE_THROWS_AS(lz4_decompress(compressed.data(), compressed.size() - 1, input.size()), std::runtime_error);
+            // Offset pointing before the beginning of the output
+            std::string bad("\x10" "a" "\xff\x00", 4);
+            REQUIRE_THROWS_AS(lz4_decompress(bad.data(), bad.size(), 5), std::runtime_error);
+            // Sizes that cannot be reached, or would wrap the output end
+            REQUIRE_THROWS_AS(lz4_decompress(compressed.data(), compressed.size(), compressed.size() * 256), std::runtime_error);
+            REQUIRE_THROWS_AS(lz4_decompress(compressed.data(), compressed.size(), std::size_t(-1)), std::runtime_error);
+        }
+
+        TEST_CASE("compress_buffers")
+        {
+            binary_buffer ints = make_int_array(10000);
+            binary_buffer noise = make_noise(5000);
+            binary_buffer small(std::string(100, 'x'));
+            buffer_sequence buffers = { ints, noise, small };
+            nl::json metadata = nl::json::object();
+
+            compress_buffers(metadata, buffers, buffer_codec::lz4);
+            REQUIRE_EQ(metadata[buffer_compression_key]["codec"], "lz4");
+            REQUIRE_EQ(metadata[buffer_compression_key]["sizes"], nl::json({ints.size(), nullptr, nullptr}));
+            REQUIRE_LT(buffers[0].size(), ints.size());
+            REQUIRE_EQ(buffers[1].data(), noise.data());
+            REQUIRE_EQ(buffers[2].data(), small.data());
+
+            decompress_buffers(metadata, buffers);
+            REQUIRE_EQ(buffers[0], ints);
+            REQUIRE_EQ(buffers[1], noise);
+
+            // Nothing to compress, the metadata is left untouched
+            nl::json untouched = nl::json::object();
+            buffer_sequence incompressible = { noise };
+            compress_buffers(untouched, incompressible, buffer_codec::lz4);
+            REQUIRE(untouched.empty());
+        }
+
+        TEST_CASE("decompress_message")
+        {
+            binary_buffer ints = make_int_array(10000);
+            buffer_sequence buffers = { ints };
+            nl::json metadata = {{"key", "value"}};
+            compress_buffers(metadata, buffers, buffer_codec::lz4);
+
+            xmessage msg({"id"},
+                         make_header("comm_msg", "user", "session"),
+                         nl::json::object(),
+                         metadata,
+                         nl::json::object(),
+                         std::move(buffers));
+            xmessage res = decompress_buffers(std::move(msg));
+            REQUIRE_EQ(res.identities().size(), 1u);
+            REQUIRE_EQ(res.metadata(), nl::json({{"key", "value"}}));
+            REQUIRE_EQ(res.buffers()[0], ints);
+
+            nl::json unknown = {{buffer_compression_key, {{"codec", "zip"}, {"sizes", {10}}}}};
+            buffer_sequence other = { ints };
+            REQUIRE_THROWS_AS(decompress_buffers(unknown, other), std::runtime_error);
+
+            // Hostile sizes coming from a frontend
+            for (const nl::json& size : {nl::json(-1), nl::json(std::size_t(-1)), nl::json(1u << 30), nl::json("10")})
+            {
+                buffer_sequence hostile = { lz4_compress(ints.data(), ints.size()) };
+                nl::json description = {{buffer_compression_key, {{"codec", "lz4"}, {"sizes", {size}}}}};
+                REQUIRE_THROWS_AS(decompress_buffers(description, hostile), std::runtime_error);
+            }
+        }
+    }
+}
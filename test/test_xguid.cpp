@@ -0,0 +1,99 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <cstddef>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xeus/xguid.hpp"
+
+namespace xeus
+{
+    namespace
+    {
+        bool is_hex_guid(const xguid& id)
+        {
+            if (id.size() != 32)
+            {
+                return false;
+            }
+            for (char c : id)
+            {
+                bool digit = c >= '0' && c <= '9';
+                bool letter = c >= 'a' && c <= 'f';
+                if (!digit && !letter)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    TEST_SUITE("xguid")
+    {
+        TEST_CASE("format")
+        {
+            xguid system_id = new_xguid(xguid_generator::system);
+            xguid fast_id = new_xguid(xguid_generator::fast);
+            REQUIRE(is_hex_guid(system_id));
+            REQUIRE(is_hex_guid(fast_id));
+        }
+
+        TEST_CASE("fast_unique")
+        {
+            constexpr std::size_t thread_count = 4;
+            constexpr std::size_t id_count = 10000;
+            std::vector<std::vector<xguid>> ids(thread_count);
+            std::vector<std::thread> threads;
+            for (std::size_t i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back([&ids, i]()
+                {
+                    for (std::size_t j = 0; j < id_count; ++j)
+                    {
+                        ids[i].push_back(new_xguid(xguid_generator::fast));
+                    }
+                });
+            }
+            for (std::thread& t : threads)
+            {
+                t.join();
+            }
+
+            std::set<std::string> unique_ids;
+            for (const auto& thread_ids : ids)
+            {
+                for (const xguid& id : thread_ids)
+                {
+                    unique_ids.insert(std::string(id));
+                }
+            }
+            std::size_t expected = thread_count * id_count;
+            REQUIRE_EQ(unique_ids.size(), expected);
+        }
+
+        TEST_CASE("generator_selection")
+        {
+            REQUIRE_EQ(get_xguid_generator(), xguid_generator::system);
+            set_xguid_generator(xguid_generator::fast);
+            REQUIRE_EQ(get_xguid_generator(), xguid_generator::fast);
+            xguid id = new_xguid();
+            xguid next = new_xguid();
+            // Ids of a thread share their prefix
+            REQUIRE_EQ(id.substr(0, 16), next.substr(0, 16));
+            REQUIRE_NE(id, next);
+            set_xguid_generator(xguid_generator::system);
+        }
+    }
+}
@@ -9,10 +9,15 @@
 
 #include "doctest/doctest.h"
 
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
 
+#include "xeus/xguid.hpp"
 #include "xeus/xhash.hpp"
 
 namespace xeus
@@ -166,6 +171,22 @@ namespace xeus
         return result;
     }
 
+    // Long enough to go through all the code paths of wyhash
+    constexpr char hash_text[] = "The kernel sends execute_reply and status messages on the "
+                                 "shell and iopub channels, hashed at compile time";
+    constexpr char16_t hash_wide_text[] = u"Hashed at compile time, with 16-bit characters";
+
+    template <class CT, std::size_t N>
+    constexpr std::array<uint64_t, N> string_hashes(const CT* str)
+    {
+        std::array<uint64_t, N> res = {};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            res[i] = hash64_string(str, i, i);
+        }
+        return res;
+    }
+
     TEST_SUITE("hash") {
     TEST_CASE("verification")
     {
@@ -195,6 +216,117 @@ namespace xeus
     {
         REQUIRE(sanity_test(&hash_bytes, sizeof(std::size_t)));
     }
+
+    TEST_CASE("hash64_vectors")
+    {
+        // Test vectors of wyhash, the seed is the index of the string
+        const char* inputs[] = {
+            "",
+            "a",
+            "abc",
+            "message digest",
+            "abcdefghijklmnopqrstuvwxyz",
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+            "12345678901234567890123456789012345678901234567890123456789012345678901234567890"
+        };
+        uint64_t expected[] = {
+            0x0409638ee2bde459ull,
+            0xa8412d091b5fe0a9ull,
+            0x32dd92e4b2915153ull,
+            0x8619124089a3a16bull,
+            0x7a43afb61d7f5f40ull,
+            0xff42329b90e50d58ull,
+            0xc39cab13b115aad3ull
+        };
+        if (endianness() == endian::little_endian)
+        {
+            for (std::size_t i = 0; i < 7; ++i)
+            {
+                uint64_t actual = hash64(inputs[i], std::strlen(inputs[i]), i);
+                REQUIRE_EQ(actual, expected[i]);
+            }
+        }
+    }
+
+    TEST_CASE("hash64_sanity")
+    {
+        auto f = [](const void* buffer, std::size_t length, std::size_t seed)
+        {
+            return hash64(buffer, length, seed);
+        };
+        REQUIRE(sanity_test(f, sizeof(uint64_t)));
+    }
+
+    TEST_CASE("hash_long")
+    {
+        std::vector<unsigned char> data(100000);
+        uint32_t state = 1;
+        for (unsigned char& c : data)
+        {
+            state = state * 1103515245u + 12345u;
+            c = static_cast<unsigned char>(state >> 24);
+        }
+
+        // Same results whatever the instruction set used
+        if (endianness() == endian::little_endian)
+        {
+            xhash128 h1 = hash128(data.data(), 1087, 7);
+            xhash128 expected1 = {0x1e10c91a3f4ebc6full, 0xa5d1940ec702cc9full};
+            REQUIRE(h1 == expected1);
+            xhash128 h2 = hash128(data.data(), 99999, 7);
+            xhash128 expected2 = {0x9dd84076447bfeddull, 0xa1be1e09334db38dull};
+            REQUIRE(h2 == expected2);
+            uint64_t h3 = hash64(data.data(), 65536, 7);
+            REQUIRE_EQ(h3, 0x0f9ddb6fadd5373aull);
+        }
+
+        // Flipping any bit of the blocks, stripes and tail changes the hash
+        const std::size_t length = 5000;
+        uint64_t reference = hash64(data.data(), length);
+        xhash128 reference128 = hash128(data.data(), length);
+        for (std::size_t position : {0u, 63u, 1023u, 1024u, 4095u, 4900u, 4999u})
+        {
+            data[position] ^= 0x10;
+            REQUIRE_NE(hash64(data.data(), length), reference);
+            REQUIRE(hash128(data.data(), length) != reference128);
+            data[position] ^= 0x10;
+        }
+        REQUIRE_NE(hash64(data.data(), length, 1), reference);
+        REQUIRE_NE(hash64(data.data(), length + 1), reference);
+    }
+
+    TEST_CASE("hash64_string")
+    {
+        constexpr std::size_t size = sizeof(hash_text) - 1;
+        constexpr std::array<uint64_t, size + 1> hashes = string_hashes<char, size + 1>(hash_text);
+        for (std::size_t i = 0; i <= size; ++i)
+        {
+            uint64_t expected = hash64(hash_text, i, i);
+            REQUIRE_EQ(hashes[i], expected);
+            uint64_t runtime = hash64_string(hash_text, i, i);
+            REQUIRE_EQ(runtime, expected);
+        }
+
+        constexpr std::size_t wide_size = sizeof(hash_wide_text) / sizeof(char16_t) - 1;
+        constexpr std::array<uint64_t, wide_size + 1> wide_hashes = string_hashes<char16_t, wide_size + 1>(hash_wide_text);
+        for (std::size_t i = 0; i <= wide_size; ++i)
+        {
+            uint64_t expected = hash64(hash_wide_text, i * sizeof(char16_t), i);
+            REQUIRE_EQ(wide_hashes[i], expected);
+        }
+
+        constexpr std::size_t key = hash_key_string(hash_text, size);
+        std::size_t expected_key = hash_key(hash_text, size);
+        REQUIRE_EQ(key, expected_key);
+    }
+
+    TEST_CASE("std_hash")
+    {
+        xguid id = new_xguid();
+        std::size_t actual = std::hash<xguid>()(id);
+        std::size_t expected = hash_key(id.data(), id.size());
+        REQUIRE_EQ(actual, expected);
+    }
     }
 }
 
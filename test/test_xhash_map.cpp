@@ -0,0 +1,132 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xcomm.hpp"
+#include "xeus/xguid.hpp"
+#include "xeus/xhash_map.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    namespace
+    {
+        // Sends all the keys to a few slots to test collisions
+        struct colliding_hash
+        {
+            std::size_t operator()(int key) const noexcept
+            {
+                return static_cast<std::size_t>(key % 3);
+            }
+        };
+    }
+
+    TEST_SUITE("xhash_map")
+    {
+        TEST_CASE("insert_find_erase")
+        {
+            xhash_map<int, std::string> map;
+            REQUIRE(map.empty());
+            REQUIRE(map.find(1) == map.end());
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto res = map.insert_or_assign(i, std::to_string(i));
+                REQUIRE(res.second);
+                REQUIRE_EQ(res.first->first, i);
+            }
+            REQUIRE_EQ(map.size(), 1000u);
+            REQUIRE_GE(4 * map.capacity(), 3 * map.size());
+
+            auto res = map.insert_or_assign(10, "ten");
+            REQUIRE_FALSE(res.second);
+            REQUIRE_EQ(map.find(10)->second, "ten");
+            REQUIRE_EQ(map.size(), 1000u);
+
+            for (int i = 0; i < 1000; i += 2)
+            {
+                REQUIRE_EQ(map.erase(i), 1u);
+            }
+            REQUIRE_EQ(map.erase(0), 0u);
+            REQUIRE_EQ(map.size(), 500u);
+            for (int i = 0; i < 1000; ++i)
+            {
+                REQUIRE_EQ(map.contains(i), i % 2 == 1);
+                REQUIRE_EQ(map.count(i), static_cast<std::size_t>(i % 2));
+            }
+            REQUIRE_EQ(map.at(11), "11");
+            map.at(11) = "eleven";
+            const auto& cmap = map;
+            REQUIRE_EQ(cmap.at(11), "eleven");
+            REQUIRE_THROWS_AS(cmap.at(12), std::out_of_range);
+
+            map.clear();
+            REQUIRE(map.empty());
+            REQUIRE(map.begin() == map.end());
+        }
+
+        TEST_CASE("collisions")
+        {
+            // Compared to std::map after each erase, which shifts back the
+            // following entries of the cluster
+            xhash_map<int, int, colliding_hash> map;
+            std::map<int, int> expected;
+            for (int i = 0; i < 12; ++i)
+            {
+                map.insert_or_assign(i, i * i);
+                expected[i] = i * i;
+            }
+            for (int key : {4, 0, 11, 5, 6, 1})
+            {
+                map.erase(key);
+                expected.erase(key);
+                std::map<int, int> actual(map.cbegin(), map.cend());
+                REQUIRE_EQ(actual, expected);
+                for (const auto& [k, v] : expected)
+                {
+                    auto it = map.find(k);
+                    REQUIRE(it != map.end());
+                    REQUIRE_EQ(it->second, v);
+                }
+            }
+        }
+
+        TEST_CASE("comm_key_lookup")
+        {
+            using comm_map = xcomm_manager::comm_map;
+            comm_map map;
+            xguid id = new_xguid();
+            map.insert_or_assign(id, nullptr);
+            map.insert_or_assign(new_xguid(), nullptr);
+
+            std::string str(id);
+            nl::json json_id = str;
+            REQUIRE(map.find(id) != map.end());
+            REQUIRE(map.find(str) != map.end());
+            REQUIRE(map.find(std::string_view(str)) != map.end());
+            REQUIRE(map.find(json_id) != map.end());
+            REQUIRE(map.find("unknown") == map.end());
+            REQUIRE_THROWS_AS(map.find(nl::json(42)), nl::json::type_error);
+
+            std::size_t hash = xcomm_key_hash()(json_id);
+            std::size_t std_hash = std::hash<xguid>()(id);
+            REQUIRE_EQ(hash, std_hash);
+        }
+    }
+}
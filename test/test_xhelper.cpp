@@ -120,6 +120,24 @@ namespace xeus
             REQUIRE_EQ(res["metadata"], metadata);
         }
 
+        TEST_CASE("create_complete_reply_moves")
+        {
+            std::string match(64, 'x');
+            nl::json matches = nl::json::array({match});
+            nl::json res = create_complete_reply(std::move(matches), 0, 1);
+            REQUIRE_EQ(res["matches"][0], match);
+            REQUIRE(matches.is_null());
+
+            complete_reply_content content;
+            content.m_matches = {"foo", match};
+            content.m_cursor_start = 2;
+            content.m_cursor_end = 5;
+            const char* match_data = content.m_matches[1].data();
+            nl::json typed = create_complete_reply(std::move(content));
+            REQUIRE_EQ(typed, create_complete_reply(nl::json::array({"foo", match}), 2, 5));
+            REQUIRE_EQ(typed["matches"][1].get_ref<const std::string&>().data(), match_data);
+        }
+
         TEST_CASE("create_inspect_reply")
         {
             bool found = true;
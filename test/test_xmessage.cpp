@@ -0,0 +1,304 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xlogger.hpp"
+#include "xeus/xmessage.hpp"
+#include "xeus/xmessage_type.hpp"
+#include "xeus/xsystem.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    TEST_SUITE("xmessage")
+    {
+        TEST_CASE("lazy_sections")
+        {
+            xmessage_serialized_data data;
+            data.m_header = std::string(R"({"msg_type":"comm_msg","msg_id":"1"})");
+            data.m_parent_header = std::string("{}");
+            data.m_content = std::string(R"({"comm_id":"abc","data":{"x":1}})");
+
+            xmessage msg({"id"}, std::move(data));
+            REQUIRE_FALSE(msg.header_section().is_parsed());
+            REQUIRE_FALSE(msg.content_section().is_parsed());
+
+            REQUIRE_EQ(msg.header()["msg_type"], "comm_msg");
+            REQUIRE(msg.header_section().is_parsed());
+            REQUIRE_FALSE(msg.content_section().is_parsed());
+
+            // An empty frame is an empty dict
+            REQUIRE(msg.metadata().is_object());
+            REQUIRE(msg.metadata().empty());
+
+            REQUIRE_EQ(msg.content()["data"]["x"], 1);
+            REQUIRE(msg.content_section().is_serialized());
+            REQUIRE_EQ(std::string(msg.content_section().serialized().begin(),
+                                   msg.content_section().serialized().end()),
+                       R"({"comm_id":"abc","data":{"x":1}})");
+        }
+
+        TEST_CASE("json_sections")
+        {
+            nl::json content;
+            content["execution_state"] = "idle";
+            xpub_message msg("status",
+                             nl::json::object(),
+                             nl::json::object(),
+                             nl::json::object(),
+                             std::move(content),
+                             buffer_sequence());
+            REQUIRE(msg.content_section().is_parsed());
+            REQUIRE_FALSE(msg.content_section().is_serialized());
+            REQUIRE_EQ(msg.content()["execution_state"], "idle");
+        }
+
+        TEST_CASE("typed_header")
+        {
+            xmessage_header header = make_typed_header("status", "user", "session");
+            std::string id = header.m_msg_id;
+            xpub_message msg("status",
+                             std::move(header),
+                             nl::json::object(),
+                             nl::json::object(),
+                             nl::json::object(),
+                             buffer_sequence());
+            REQUIRE_EQ(msg.typed_header().m_msg_id, id);
+            REQUIRE_EQ(msg.typed_header().m_msg_type, "status");
+
+            const nl::json& json_header = msg.header();
+            REQUIRE_EQ(json_header["msg_id"], id);
+            REQUIRE_EQ(json_header["msg_type"], "status");
+            REQUIRE_EQ(json_header["username"], "user");
+            REQUIRE_EQ(json_header["session"], "session");
+            REQUIRE_EQ(json_header["version"], get_protocol_version());
+            REQUIRE_EQ(serialize_header(msg.typed_header()), json_header.dump());
+        }
+
+        TEST_CASE("serialize_header")
+        {
+            xmessage_header header = make_typed_header("stream", "a \"quoted\"\tname", "session");
+            REQUIRE_EQ(serialize_header(header), nl::json(header).dump());
+            std::ostringstream out;
+            serialize_header(header, out);
+            REQUIRE_EQ(out.str(), nl::json(header).dump());
+        }
+
+        TEST_CASE("header_factory")
+        {
+            xheader_factory factory("user", "a \"quoted\" session");
+            nl::json header = factory.make_header("stream");
+            REQUIRE_EQ(header["msg_type"], "stream");
+            REQUIRE_EQ(header["username"], "user");
+            REQUIRE_EQ(header["session"], "a \"quoted\" session");
+            REQUIRE_EQ(header["version"], get_protocol_version());
+
+            // The invariant fields are shared and written pre-serialized
+            xmessage_header typed_header = factory.make_typed_header("stream");
+            xmessage_header other_header = factory.make_typed_header("status");
+            REQUIRE_EQ(typed_header.session(), factory.session_id());
+            REQUIRE_EQ(typed_header.p_fields, other_header.p_fields);
+            REQUIRE_FALSE(typed_header.p_fields->m_serialized.empty());
+            REQUIRE_EQ(serialize_header(typed_header), nl::json(typed_header).dump());
+        }
+
+        TEST_CASE("parse_header")
+        {
+            nl::json json_header;
+            json_header["msg_id"] = "a1b2c3";
+            json_header["msg_type"] = "execute_request";
+            json_header["session"] = "s";
+            json_header["username"] = "u";
+            json_header["date"] = "1970-01-02T00:00:01.500000Z";
+            json_header["version"] = "5.3";
+
+            xmessage msg({"id"}, json_header, nl::json::object(), nl::json::object(), nl::json::object(), buffer_sequence());
+            const xmessage_header& header = msg.typed_header();
+            REQUIRE_EQ(header.m_msg_id, "a1b2c3");
+            REQUIRE_EQ(header.m_msg_type, "execute_request");
+            REQUIRE_EQ(header.version(), "5.3");
+            REQUIRE_EQ(header.username(), "u");
+            auto micros = std::chrono::duration_cast<std::chrono::microseconds>(header.m_date.time_since_epoch());
+            REQUIRE_EQ(micros.count(), 86401500000);
+
+            // Ids built by jupyter_client as <uuid>_<pid>_<counter> do not
+            // fit in an xguid
+            std::string long_id = "3f9b2b5e-7c4d-4f7a-9a43-51a1e0c2d6b8_123456_1234567890";
+            json_header["msg_id"] = long_id + "_suffix";
+            xmessage long_msg({"id"}, json_header, nl::json::object(), nl::json::object(), nl::json::object(), buffer_sequence());
+            REQUIRE_EQ(long_msg.typed_header().m_msg_id, long_id + "_suffix");
+            nl::json serialized = nl::json::parse(serialize_header(long_msg.typed_header()));
+            REQUIRE_EQ(serialized["msg_id"], long_id + "_suffix");
+        }
+
+        TEST_CASE("parse_iso8601")
+        {
+            using std::chrono::duration_cast;
+            using std::chrono::seconds;
+            REQUIRE_EQ(duration_cast<seconds>(parse_iso8601("2024-03-01T12:30:15Z").time_since_epoch()).count(), 1709296215);
+            REQUIRE_EQ(parse_iso8601("2024-03-01T13:30:15+01:00"), parse_iso8601("2024-03-01T12:30:15Z"));
+            REQUIRE_EQ(parse_iso8601("2024-03-01T12:30:15.25"), parse_iso8601("2024-03-01T12:30:15.250000Z"));
+            REQUIRE_THROWS_AS(parse_iso8601("2024-03-01"), std::invalid_argument);
+            REQUIRE_THROWS_AS(parse_iso8601("2024-13-01T12:30:15Z"), std::invalid_argument);
+        }
+
+        TEST_CASE("message_type")
+        {
+            for (std::size_t i = 0; i < message_type_count; ++i)
+            {
+                message_type type = static_cast<message_type>(i);
+                REQUIRE_EQ(to_message_type(to_string(type)), type);
+            }
+            REQUIRE_EQ(to_message_type("custom_request"), message_type::unknown);
+            REQUIRE_EQ(to_message_type(""), message_type::unknown);
+            // Names sharing the length and the hashed characters of a
+            // known message type
+            REQUIRE_EQ(to_message_type("stXeam"), message_type::unknown);
+            REQUIRE_EQ(to_message_type("execute_request "), message_type::unknown);
+            static_assert(to_message_type("comm_msg") == message_type::comm_msg);
+            REQUIRE(to_string(message_type::unknown).empty());
+            REQUIRE_EQ(reply_type(message_type::kernel_info_request), message_type::kernel_info_reply);
+            REQUIRE_EQ(reply_type(message_type::input_request), message_type::input_reply);
+            REQUIRE_EQ(reply_type(message_type::kernel_info_reply), message_type::unknown);
+            REQUIRE_EQ(reply_type(message_type::comm_msg), message_type::unknown);
+        }
+
+        TEST_CASE("msg_type")
+        {
+            xmessage_serialized_data data;
+            data.m_header = std::string(R"({"msg_type":"comm_msg","msg_id":"1"})");
+            xmessage msg({"id"}, std::move(data));
+            REQUIRE_EQ(msg.msg_type(), "comm_msg");
+
+            xpub_message pub("status",
+                             make_typed_header("status", "user", "session"),
+                             nl::json::object(),
+                             nl::json::object(),
+                             nl::json::object(),
+                             buffer_sequence());
+            REQUIRE_EQ(pub.msg_type(), "status");
+        }
+
+        TEST_CASE("iso8601")
+        {
+            using time_point = std::chrono::system_clock::time_point;
+            using std::chrono::duration_cast;
+            using std::chrono::microseconds;
+            auto make_time = [](long long micros)
+            {
+                return time_point(duration_cast<time_point::duration>(microseconds(micros)));
+            };
+
+            // Microseconds are zero-padded
+            REQUIRE_EQ(iso8601(make_time(1709296215000005)), "2024-03-01T12:30:15.000005Z");
+            // Same second, different microseconds
+            REQUIRE_EQ(iso8601(make_time(1709296215120000)), "2024-03-01T12:30:15.120000Z");
+            REQUIRE_EQ(iso8601(make_time(951782400000000)), "2000-02-29T00:00:00.000000Z");
+            REQUIRE_EQ(iso8601(make_time(-1)), "1969-12-31T23:59:59.999999Z");
+
+            time_point now = std::chrono::system_clock::now();
+            std::string date = iso8601(now);
+            REQUIRE_EQ(date.size(), iso8601_size);
+            REQUIRE_EQ(parse_iso8601(date), make_time(duration_cast<microseconds>(now.time_since_epoch()).count()));
+        }
+
+        TEST_CASE("binary_encodings")
+        {
+            nl::json content = {{"name", "stdout"}, {"text", "hello\n"}, {"values", {1, 2.5, nullptr}}};
+            for (message_encoding encoding : {message_encoding::cbor, message_encoding::msgpack})
+            {
+                binary_buffer bytes = serialize_json(content, encoding);
+                REQUIRE_LT(bytes.size(), content.dump().size());
+
+                xmessage_section section(bytes, encoding);
+                REQUIRE_EQ(section.encoding(), encoding);
+                REQUIRE_EQ(section.serialized(encoding).data(), bytes.data());
+                REQUIRE_FALSE(section.is_parsed());
+                REQUIRE_EQ(section.json(), content);
+                REQUIRE_EQ(parse_json(section.serialized(message_encoding::json), message_encoding::json), content);
+            }
+        }
+
+        TEST_CASE("chunked_buffers")
+        {
+            auto make_message = []()
+            {
+                chunked_buffer_sequence buffers;
+                buffers.emplace_back(std::vector<binary_buffer>{ binary_buffer(std::string("ab")),
+                                                                 binary_buffer(std::string("cd")) });
+                return xpub_message("comm_msg",
+                                    make_typed_header("comm_msg", "user", "session"),
+                                    nl::json::object(),
+                                    nl::json::object(),
+                                    nl::json::object(),
+                                    std::move(buffers));
+            };
+
+            xpub_message msg = make_message();
+            REQUIRE(msg.has_chunked_buffers());
+            chunked_buffer_sequence chunks = std::move(msg).chunked_buffers();
+            REQUIRE_EQ(chunks.size(), 1u);
+            REQUIRE_EQ(chunks[0].segments().size(), 2u);
+
+            // Transports that do not stream get contiguous buffers
+            xpub_message flat = make_message();
+            REQUIRE_EQ(flat.buffers().size(), 1u);
+            REQUIRE_EQ(std::string(flat.buffers()[0].begin(), flat.buffers()[0].end()), "abcd");
+            REQUIRE_FALSE(flat.has_chunked_buffers());
+
+            // And conversely
+            xpub_message plain("stream",
+                               make_typed_header("stream", "user", "session"),
+                               nl::json::object(),
+                               nl::json::object(),
+                               nl::json::object(),
+                               buffer_sequence{ binary_buffer(std::string("xyz")) });
+            REQUIRE_FALSE(plain.has_chunked_buffers());
+            chunks = std::move(plain).chunked_buffers();
+            REQUIRE_EQ(chunks.size(), 1u);
+            REQUIRE_EQ(chunks[0].segments().size(), 1u);
+        }
+
+        TEST_CASE("invalid_section")
+        {
+            xmessage_serialized_data data;
+            data.m_header = std::string("{\"msg_type\":");
+            xmessage msg({"id"}, std::move(data));
+            REQUIRE_THROWS_AS(msg.header(), nl::json::parse_error);
+        }
+
+        TEST_CASE("log_invalid_section")
+        {
+            xmessage_serialized_data data;
+            data.m_header = std::string(R"({"msg_type":"execute_request","msg_id":"1"})");
+            data.m_content = std::string(R"({"code": )");
+            xmessage msg({"id"}, std::move(data));
+
+            std::string file_name = get_temp_directory_path() + "/xeus_log_invalid_section.log";
+            {
+                auto logger = make_file_logger(xlogger::full, file_name);
+                REQUIRE_NOTHROW(logger->log_received_message(msg, xlogger::shell));
+            }
+            std::ifstream in(file_name);
+            std::string log((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            REQUIRE_NE(log.find("<unparsable section>"), std::string::npos);
+            REQUIRE_NE(log.find("execute_request"), std::string::npos);
+        }
+    }
+}
@@ -0,0 +1,211 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xmessage.hpp"
+#include "xeus/xmessage_serializer.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    namespace
+    {
+        xpub_message make_message()
+        {
+            nl::json content = {{"name", "stdout"}, {"text", "hello\n"}};
+            buffer_sequence buffers = { binary_buffer(std::string("raw")) };
+            return xpub_message("stream",
+                                make_typed_header("stream", "user", "session"),
+                                nl::json::object(),
+                                xmessage_section(binary_buffer(std::string(R"({ "a" : 1 })"))),
+                                std::move(content),
+                                std::move(buffers));
+        }
+
+        std::string to_string(const binary_buffer& buffer)
+        {
+            return std::string(buffer.begin(), buffer.end());
+        }
+    }
+
+    TEST_SUITE("xmessage_serializer")
+    {
+        TEST_CASE("serialize")
+        {
+            xpub_message msg = make_message();
+            xmessage_serializer serializer;
+            xmessage_serialized_data data = serializer.serialize(msg);
+
+            REQUIRE_EQ(to_string(data.m_header), serialize_header(msg.typed_header()));
+            REQUIRE_EQ(to_string(data.m_parent_header), "{}");
+            // Serialized sections are copied as they are
+            REQUIRE_EQ(to_string(data.m_metadata), R"({ "a" : 1 })");
+            REQUIRE_EQ(to_string(data.m_content), msg.content().dump());
+
+            // The JSON frames share a single buffer
+            REQUIRE_EQ(data.m_header.owner(), data.m_content.owner());
+            REQUIRE_EQ(data.m_header.data() + data.m_header.size(), data.m_parent_header.data());
+
+            REQUIRE_EQ(data.m_buffers.size(), 1u);
+            REQUIRE_EQ(data.m_buffers[0].data(), msg.buffers()[0].data());
+        }
+
+        TEST_CASE("chunked_buffers")
+        {
+            auto make_chunked = [](chunked_buffer_sequence buffers)
+            {
+                return xpub_message("stream",
+                                    make_typed_header("stream", "user", "session"),
+                                    nl::json::object(),
+                                    nl::json::object(),
+                                    nl::json::object(),
+                                    std::move(buffers));
+            };
+            xmessage_serializer serializer;
+
+            // Stored segments are shared, the message is not flattened
+            std::vector<binary_buffer> segments = { binary_buffer(std::string("ab")), binary_buffer(std::string("cd")) };
+            chunked_buffer_sequence stored;
+            stored.emplace_back(segments);
+            xpub_message msg = make_chunked(std::move(stored));
+            xmessage_serialized_data data = serializer.serialize(msg);
+            REQUIRE(msg.has_chunked_buffers());
+            REQUIRE(data.m_buffers.empty());
+            REQUIRE_EQ(data.m_chunked_buffers.size(), 1u);
+            REQUIRE_EQ(data.m_chunked_buffers[0].segments().size(), 2u);
+            REQUIRE_EQ(data.m_chunked_buffers[0].segments()[1].data(), segments[1].data());
+
+            xpub_message res("stream", std::move(data));
+            REQUIRE(res.has_chunked_buffers());
+
+            // Streamed buffers of an rvalue are moved, not read
+            int produced = 0;
+            chunked_buffer_sequence streamed;
+            streamed.emplace_back(xchunked_buffer::producer([&produced](binary_buffer& segment)
+            {
+                if (produced == 2)
+                {
+                    return false;
+                }
+                segment = binary_buffer(std::string(1, static_cast<char>('a' + produced++)));
+                return true;
+            }));
+            data = serializer.serialize(make_chunked(std::move(streamed)));
+            REQUIRE_EQ(produced, 0);
+            REQUIRE(data.m_buffers.empty());
+            REQUIRE_EQ(data.m_chunked_buffers.size(), 1u);
+            binary_buffer segment;
+            std::string streamed_bytes;
+            while (data.m_chunked_buffers[0].next(segment))
+            {
+                streamed_bytes.append(segment.begin(), segment.end());
+            }
+            REQUIRE_EQ(streamed_bytes, "ab");
+        }
+
+        TEST_CASE("error_handler")
+        {
+            xpub_message msg("stream",
+                             make_typed_header("stream", "user", "session"),
+                             nl::json::object(),
+                             nl::json::object(),
+                             nl::json({{"text", "a\xff"}}),
+                             buffer_sequence());
+            REQUIRE_THROWS_AS(xmessage_serializer().serialize(msg), nl::json::type_error);
+
+            xmessage_serializer serializer(message_encoding::json, xbuffer_pool(), nl::json::error_handler_t::replace);
+            REQUIRE_EQ(serializer.error_handler(), nl::json::error_handler_t::replace);
+            xmessage_serialized_data data = serializer.serialize(msg);
+            REQUIRE_EQ(to_string(data.m_content), "{\"text\":\"a\xef\xbf\xbd\"}");
+        }
+
+        TEST_CASE("sizes")
+        {
+            xpub_message msg = make_message();
+            xmessage_serializer serializer;
+            std::vector<char> out(3, 'x');
+            xmessage_serializer::frame_sizes sizes = serializer.serialize(msg, out);
+            REQUIRE_EQ(serializer.sizes(msg), sizes);
+            REQUIRE_EQ(out.size(), 3 + sizes[0] + sizes[1] + sizes[2] + sizes[3]);
+
+            std::vector<char> exact(out.size() - 3);
+            REQUIRE_EQ(serializer.serialize(msg, exact.data(), exact.size()), sizes);
+            REQUIRE(std::equal(exact.begin(), exact.end(), out.begin() + 3));
+            REQUIRE_THROWS_AS(serializer.serialize(msg, exact.data(), exact.size() - 1), std::length_error);
+        }
+
+        TEST_CASE("round_trip")
+        {
+            for (message_encoding encoding : {message_encoding::json,
+                                              message_encoding::cbor,
+                                              message_encoding::msgpack})
+            {
+                xpub_message msg = make_message();
+                xmessage_serializer serializer(encoding);
+                xpub_message res("stream", serializer.serialize(msg));
+
+                REQUIRE_FALSE(res.content_section().is_parsed());
+                REQUIRE_EQ(res.content_section().encoding(), encoding);
+                REQUIRE_EQ(res.header(), msg.header());
+                REQUIRE_EQ(res.metadata(), msg.metadata());
+                REQUIRE_EQ(res.content(), msg.content());
+                REQUIRE_EQ(res.buffers().size(), 1u);
+            }
+        }
+
+        TEST_CASE("deserialize_frames")
+        {
+            xmessage_serializer serializer;
+            buffer_sequence frames = {
+                binary_buffer(std::string(R"({"msg_type":"comm_msg"})")),
+                binary_buffer(std::string("{}")),
+                binary_buffer(),
+                binary_buffer(std::string(R"({"comm_id":"abc"})")),
+                binary_buffer(std::string("raw"))
+            };
+            xmessage msg({"id"}, serializer.deserialize(frames));
+            REQUIRE_EQ(msg.msg_type(), "comm_msg");
+            REQUIRE(msg.metadata().empty());
+            REQUIRE_EQ(msg.content()["comm_id"], "abc");
+            REQUIRE_EQ(msg.buffers().size(), 1u);
+
+            frames.resize(3);
+            REQUIRE_THROWS_AS(serializer.deserialize(frames), std::invalid_argument);
+            REQUIRE_THROWS_AS(serializer.deserialize(binary_buffer(std::string("{}")), {1, 1, 1, 0}, {}),
+                              std::invalid_argument);
+        }
+
+        TEST_CASE("buffer_pool")
+        {
+            xbuffer_pool pool(1);
+            xmessage_serializer serializer(message_encoding::json, pool);
+            const char* data = nullptr;
+            {
+                xmessage_serialized_data res = serializer.serialize(make_message());
+                data = res.m_header.data();
+                REQUIRE_EQ(pool.available(), 0u);
+            }
+            REQUIRE_EQ(pool.available(), 1u);
+
+            // The recycled vector is reused
+            xmessage_serialized_data res = serializer.serialize(make_message());
+            REQUIRE_EQ(res.m_header.data(), data);
+            REQUIRE_EQ(pool.available(), 0u);
+        }
+    }
+}
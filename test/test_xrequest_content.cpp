@@ -0,0 +1,116 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <string>
+
+#include "nlohmann/json.hpp"
+
+#include "xeus/xrequest_content.hpp"
+
+namespace nl = nlohmann;
+
+namespace xeus
+{
+    namespace
+    {
+        xmessage_section serialized_section(const std::string& str)
+        {
+            return xmessage_section(binary_buffer(std::string(str)));
+        }
+    }
+
+    TEST_SUITE("xrequest_content")
+    {
+        TEST_CASE("execute_request")
+        {
+            std::string content = R"json({"code":"print(\"a\")","silent":false,"store_history":false,)json"
+                                  R"("user_expressions":{"x":{"a":[1,2.5,null,{"b":true}]},"y":"z"},)"
+                                  R"("allow_stdin":false,"stop_on_error":true,"unknown":[[]]})";
+
+            xmessage_section section = serialized_section(content);
+            auto from_bytes = decode_content<execute_request_content>(section);
+            REQUIRE_FALSE(section.is_parsed());
+
+            auto from_json = decode_content<execute_request_content>(nl::json::parse(content));
+            for (const execute_request_content& c : {from_bytes, from_json})
+            {
+                REQUIRE_EQ(c.m_code, "print(\"a\")");
+                REQUIRE_FALSE(c.m_silent);
+                REQUIRE_FALSE(c.m_store_history);
+                REQUIRE_FALSE(c.m_allow_stdin);
+                REQUIRE(c.m_stop_on_error);
+                REQUIRE_EQ(c.m_user_expressions, nl::json::parse(content)["user_expressions"]);
+            }
+        }
+
+        TEST_CASE("defaults")
+        {
+            auto content = decode_content<execute_request_content>(serialized_section("{}"));
+            REQUIRE(content.m_code.empty());
+            REQUIRE(content.m_store_history);
+            REQUIRE(content.m_user_expressions.is_object());
+
+            auto history = decode_content<history_request_content>(xmessage_section(binary_buffer()));
+            REQUIRE_EQ(history.m_hist_access_type, "tail");
+            REQUIRE_EQ(history.m_n, 10);
+            REQUIRE_EQ(history.m_pattern, "*");
+        }
+
+        TEST_CASE("inspect_request")
+        {
+            auto content = decode_content<inspect_request_content>(
+                serialized_section(R"({"code":"abc","cursor_pos":2,"detail_level":1})"));
+            REQUIRE_EQ(content.m_code, "abc");
+            REQUIRE_EQ(content.m_cursor_pos, 2);
+            REQUIRE_EQ(content.m_detail_level, 1);
+        }
+
+        TEST_CASE("binary_content")
+        {
+            nl::json json = {{"code", "abc"}, {"cursor_pos", 2}, {"detail_level", 1}};
+            xmessage_section section(serialize_json(json, message_encoding::cbor), message_encoding::cbor);
+            auto content = decode_content<inspect_request_content>(section);
+            REQUIRE_FALSE(section.is_parsed());
+            REQUIRE_EQ(content.m_code, "abc");
+            REQUIRE_EQ(content.m_cursor_pos, 2);
+            REQUIRE_EQ(content.m_detail_level, 1);
+        }
+
+        TEST_CASE("invalid_content")
+        {
+            REQUIRE_THROWS_AS(decode_content<complete_request_content>(serialized_section(R"({"code":1})")),
+                              nl::json::type_error);
+            REQUIRE_THROWS_AS(decode_content<complete_request_content>(serialized_section(R"({"code":)")),
+                              nl::json::parse_error);
+
+            // Fields that are not read are not type-checked
+            std::string unknown = R"({"code":"abc","unknown":{"cursor_pos":"x"},"cursor_pos":2})";
+            auto content = decode_content<complete_request_content>(serialized_section(unknown));
+            REQUIRE_EQ(content.m_code, "abc");
+            REQUIRE_EQ(content.m_cursor_pos, 2);
+
+            std::string tail = R"({"pattern":null,"n":5,"start":"x","hist_access_type":"tail"})";
+            for (const auto& history : {decode_content<history_request_content>(serialized_section(tail)),
+                                        decode_content<history_request_content>(nl::json::parse(tail))})
+            {
+                REQUIRE_EQ(history.m_n, 5);
+                REQUIRE_EQ(history.m_pattern, "*");
+                REQUIRE_EQ(history.m_start, 1);
+            }
+
+            std::string search = R"({"pattern":null,"hist_access_type":"search"})";
+            REQUIRE_THROWS_AS(decode_content<history_request_content>(serialized_section(search)),
+                              nl::json::type_error);
+            REQUIRE_THROWS_AS(decode_content<history_request_content>(nl::json::parse(search)),
+                              nl::json::type_error);
+        }
+    }
+}
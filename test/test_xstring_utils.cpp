@@ -0,0 +1,193 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay, Martin Renou          *
+* Copyright (c) 2016, QuantStack                                           *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "doctest/doctest.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "xeus/xguid.hpp"
+#include "xeus/xstring_utils.hpp"
+
+namespace xeus
+{
+    namespace
+    {
+        std::string make_bytes(std::size_t size)
+        {
+            std::string res(size, '\0');
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                res[i] = static_cast<char>(i * 37 + 11);
+            }
+            return res;
+        }
+
+        std::string reference_hex(const std::string& bytes)
+        {
+            static constexpr char digits[] = "0123456789abcdef";
+            std::string res;
+            for (char c : bytes)
+            {
+                unsigned char b = static_cast<unsigned char>(c);
+                res.push_back(digits[b >> 4]);
+                res.push_back(digits[b & 0xF]);
+            }
+            return res;
+        }
+    }
+
+    TEST_SUITE("xstring_utils")
+    {
+        TEST_CASE("hex_string")
+        {
+            std::array<unsigned char, 4> bytes = {0x00, 0x0f, 0xa0, 0xff};
+            std::string res = hex_string(bytes);
+            REQUIRE_EQ(res, "000fa0ff");
+            xguid id = hex_string<xguid>(bytes);
+            REQUIRE_EQ(id, "000fa0ff");
+        }
+
+        TEST_CASE("hex_round_trip")
+        {
+            // Covers the vectorized paths and their scalar tails
+            for (std::size_t size = 0; size < 200; ++size)
+            {
+                std::string bytes = make_bytes(size);
+                std::string encoded = hex_string(bytes);
+                REQUIRE_EQ(encoded, reference_hex(bytes));
+
+                std::string decoded(size, '\0');
+                REQUIRE(hex_decode(encoded.data(), encoded.size(), decoded.data()));
+                REQUIRE_EQ(decoded, bytes);
+            }
+        }
+
+        TEST_CASE("hex_decode_upper_case")
+        {
+            std::string encoded = "00FFaBcD0123456789ABCDEFabcdef0123456789ABCDEFabcdef0123456789aa";
+            std::string decoded(encoded.size() / 2, '\0');
+            REQUIRE(hex_decode(encoded.data(), encoded.size(), decoded.data()));
+            std::string lower = hex_string(decoded);
+            std::string expected = "00ffabcd0123456789abcdefabcdef0123456789abcdefabcdef0123456789aa";
+            REQUIRE_EQ(lower, expected);
+        }
+
+        TEST_CASE("hex_decode_invalid")
+        {
+            std::string decoded(64, '\0');
+            REQUIRE_FALSE(hex_decode("abc", 3, decoded.data()));
+
+            std::string encoded = hex_string(make_bytes(64));
+            for (std::size_t i = 0; i < encoded.size(); ++i)
+            {
+                for (char c : {'g', 'G', '/', ':', '@', '`', ' ', '\xff'})
+                {
+                    std::string invalid = encoded;
+                    invalid[i] = c;
+                    REQUIRE_FALSE(hex_decode(invalid.data(), invalid.size(), decoded.data()));
+                }
+            }
+        }
+
+        TEST_CASE("utf8_valid_prefix")
+        {
+            // Each sequence is placed at every position of a text longer
+            // than the vectorized blocks, after ASCII or multibyte text
+            struct sample
+            {
+                std::string bytes;
+                std::size_t valid;
+            };
+            const sample samples[] = {
+                {"\xC3\xA9", 2},             // U+00E9
+                {"\xE2\x82\xAC", 3},         // U+20AC
+                {"\xF0\x9F\x98\x80", 4},     // U+1F600
+                {"\xF4\x8F\xBF\xBF", 4},     // U+10FFFF
+                {"\xEF\xBF\xBD", 3},         // U+FFFD
+                {"\x80", 0},                 // continuation byte
+                {"\xC3", 0},                 // truncated
+                {"\xE2\x82", 0},             // truncated
+                {"\xF0\x9F\x98", 0},         // truncated
+                {"\xC0\xAF", 0},             // overlong
+                {"\xE0\x80\xAF", 0},         // overlong
+                {"\xF0\x80\x80\xAF", 0},     // overlong
+                {"\xED\xA0\x80", 0},         // surrogate
+                {"\xF4\x90\x80\x80", 0},     // above U+10FFFF
+                {"\xF8\x88\x80\x80\x80", 0}, // 5-byte sequence
+                {"\xFF", 0},
+                {"\xC3\xA9\xA9", 2}          // extra continuation byte
+            };
+            for (const std::string& filler : {std::string("a"), std::string("\xC3\xA9")})
+            {
+                for (const sample& s : samples)
+                {
+                    for (std::size_t count = 0; count < 40; ++count)
+                    {
+                        std::string prefix;
+                        for (std::size_t i = 0; i < count; ++i)
+                        {
+                            prefix += filler;
+                        }
+                        std::string text = prefix + s.bytes + std::string(40, 'z');
+                        std::size_t expected = s.valid == s.bytes.size() ? text.size() : prefix.size() + s.valid;
+                        REQUIRE_EQ(utf8_valid_prefix(text.data(), text.size()), expected);
+                        std::string truncated = prefix + s.bytes;
+                        expected = s.valid == s.bytes.size() ? truncated.size() : prefix.size() + s.valid;
+                        REQUIRE_EQ(utf8_valid_prefix(truncated.data(), truncated.size()), expected);
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("repair_utf8")
+        {
+            std::string valid = "caf\xC3\xA9 \xF0\x9F\x98\x80";
+            REQUIRE_FALSE(repair_utf8(valid));
+            REQUIRE_EQ(valid, "caf\xC3\xA9 \xF0\x9F\x98\x80");
+
+            // Each maximal subpart of an invalid sequence is replaced
+            const std::string replacement = "\xEF\xBF\xBD";
+            std::string text = std::string(50, 'a') + "\xF0\x9F\x98" + "b" + "\xED\xA0\x80" + "\xC3";
+            REQUIRE(repair_utf8(text));
+            REQUIRE_EQ(text, std::string(50, 'a') + replacement + "b" + replacement + replacement + replacement + replacement);
+            REQUIRE(is_utf8_valid(text.data(), text.size()));
+        }
+
+        TEST_CASE("find_chars")
+        {
+            // Compared to std::string for every size and position of the
+            // match, covering the vectorized blocks and the short inputs;
+            // the last set is too large for the SSE2 path.
+            const std::string sets[] = {"", "/", " \t\r\n", "0123456789abcdefghijklmnopqrstuvwxyz"};
+            for (const std::string& set : sets)
+            {
+                for (std::size_t size = 0; size < 100; ++size)
+                {
+                    for (std::size_t i = 0; i <= size; ++i)
+                    {
+                        std::string text(size, 'x');
+                        std::string other(size, set.empty() ? 'x' : set.back());
+                        if (i < size)
+                        {
+                            text[i] = other[i] = '/';
+                        }
+                        const char* s = set.data();
+                        std::size_t n = set.size();
+                        REQUIRE_EQ(find_first_of_chars(text.data(), size, s, n), text.find_first_of(set));
+                        REQUIRE_EQ(find_last_of_chars(text.data(), size, s, n), text.find_last_of(set));
+                        REQUIRE_EQ(find_first_not_of_chars(other.data(), size, s, n), other.find_first_not_of(set));
+                        REQUIRE_EQ(find_last_not_of_chars(other.data(), size, s, n), other.find_last_not_of(set));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -22,8 +22,9 @@ namespace xeus
         return p_server->notify_internal_listener(message);
     }
 
-    xmock_server::xmock_server()
-        : m_messenger(this)
+    xmock_server::xmock_server(nl::json::error_handler_t eh)
+        : xserver(eh)
+        , m_messenger(this)
     {
     }
 
@@ -79,14 +80,19 @@ namespace xeus
 
     xpub_message xmock_server::read_iopub()
     {
-        xpub_message res = std::move(m_iopub_messages.back());
+        xpub_message res = std::move(m_iopub_messages.front());
         m_iopub_messages.pop();
         return res;
     }
 
+    const std::vector<std::string>& xmock_server::sent_messages() const
+    {
+        return m_sent_messages;
+    }
+
     xmessage xmock_server::read_impl(message_queue& q)
     {
-        xmessage res = std::move(q.back());
+        xmessage res = std::move(q.front());
         q.pop();
         return res;
     }
@@ -98,11 +104,13 @@ namespace xeus
 
     void xmock_server::send_shell_impl(xmessage message)
     {
+        m_sent_messages.push_back("shell:" + message.msg_type());
         m_shell_messages.push(std::move(message));
     }
 
     void xmock_server::send_control_impl(xmessage message)
     {
+        m_sent_messages.push_back("control:" + message.msg_type());
         m_control_messages.push(std::move(message));
     }
 
@@ -113,6 +121,7 @@ namespace xeus
 
     void xmock_server::publish_impl(xpub_message message, channel)
     {
+        m_sent_messages.push_back("iopub:" + message.msg_type());
         m_iopub_messages.push(std::move(message));
     }
 
@@ -135,9 +144,9 @@ namespace xeus
 
     std::unique_ptr<xserver> make_mock_server(xcontext&,
                                             const xconfiguration&,
-                                            nl::json::error_handler_t)
+                                            nl::json::error_handler_t eh)
     {
-        return std::make_unique<xmock_server>();
+        return std::make_unique<xmock_server>(eh);
     }
 
     xmock_context::xmock_context() : xcontext()
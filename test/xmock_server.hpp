@@ -13,6 +13,8 @@
 #include <cstddef>
 #include <memory>
 #include <queue>
+#include <string>
+#include <vector>
 
 #include "xeus/xcontrol_messenger.hpp"
 #include "xeus/xeus_context.hpp"
@@ -40,7 +42,7 @@ namespace xeus
     {
     public:
 
-        xmock_server();
+        explicit xmock_server(nl::json::error_handler_t eh = nl::json::error_handler_t::strict);
         virtual ~xmock_server() = default;
 
         xmock_server(const xmock_server&) = delete;
@@ -65,7 +67,12 @@ namespace xeus
         std::size_t iopub_size() const;
         xpub_message read_iopub();
 
+        // Channel and type of the messages sent by the kernel, in the
+        // order they were sent, e.g. "iopub:status" or "shell:kernel_info_reply"
+        const std::vector<std::string>& sent_messages() const;
+
         using xserver::notify_internal_listener;
+        using xserver::notify_shell_listener;
 
     private:
 
@@ -90,6 +97,7 @@ namespace xeus
         message_queue m_control_messages;
         message_queue m_stdin_messages;
         std::queue<xpub_message> m_iopub_messages;
+        std::vector<std::string> m_sent_messages;
     };
 
     std::unique_ptr<xserver> make_mock_server(xcontext& context,